@@ -25,44 +25,42 @@ void ofApp::setup()
     int tzd2 = 0;
     int tzd3 = 0;
 
-    Poco::DateTime min0;
-    Poco::DateTime max0;
-    Poco::DateTime min1;
-    Poco::DateTime max1;
-
-    try
+    Poco::Timestamp min0;
+    Poco::Timestamp max0;
+    Poco::Timestamp min1;
+    Poco::Timestamp max1;
+
+    // Each format is compiled once and can then be used to parse any number
+    // of strings.  Unlike Poco::DateTimeParser, the parsers return UTC times,
+    // so there is no need to call Poco::DateTime::makeUTC(), and they report
+    // errors with an error code rather than an exception.
+    ofxTime::CompiledParser iso8601(Poco::DateTimeFormat::ISO8601_FORMAT);
+    ofxTime::CompiledParser rfc1036(Poco::DateTimeFormat::RFC1036_FORMAT);
+    ofxTime::CompiledParser iso8601Frac(Poco::DateTimeFormat::ISO8601_FRAC_FORMAT);
+    ofxTime::CompiledParser twitter(TWITTER_DATE_FORMAT);
+
+    auto parse = [](const ofxTime::CompiledParser& parser,
+                    const std::string& text,
+                    Poco::Timestamp& timestamp,
+                    int& tzd)
     {
-        // try to auto detect a known format
-        min0 = Poco::DateTimeParser::parse(ts0, tzd0);
-
-        // try to auto detect a known format
-        max0 = Poco::DateTimeParser::parse(ts1, tzd1);
+        ofxTime::CompiledParser::Error error = parser.parse(text, timestamp, tzd);
 
-        // parse with a known format
-        Poco::DateTimeParser::parse(Poco::DateTimeFormat::ISO8601_FRAC_FORMAT, ts2, min1, tzd2);
+        if (error != ofxTime::CompiledParser::SUCCESS)
+        {
+            ofLogError("ofApp::setup()") << "Unable to parse " << text << ": " << ofxTime::CompiledParser::toString(error);
+        }
+    };
 
-        // parse with a custom format
-        Poco::DateTimeParser::parse(TWITTER_DATE_FORMAT, ts3, max1, tzd3);
-
-        // we want to work with UTC time, rather than the local time parsed by
-        // the Poco::DateTimeParser.  it is easy to convert by simply calling
-        // Poco::DateTimeParser::makeUTC() with the time zone difference (in seconds)
-        // calculated by the parser.
-
-        min0.makeUTC(tzd0);
-        max0.makeUTC(tzd1);
-        min1.makeUTC(tzd2);
-        max1.makeUTC(tzd3);
-    }
-    catch (const Poco::SyntaxException& exc)
-    {
-        ofLogError("ofApp::setup()") << "Syntax exception: " << exc.displayText();
-    }
+    parse(iso8601, ts0, min0, tzd0);
+    parse(rfc1036, ts1, max0, tzd1);
+    parse(iso8601Frac, ts2, min1, tzd2);
+    parse(twitter, ts3, max1, tzd3);
 
     // set up our ranges.  the Time::Range::set() function will order the
     // Poco::Timestamps appropriately.
-    interval0.set(min0.timestamp(), max0.timestamp());
-    interval1.set(min1.timestamp(), max1.timestamp());
+    interval0.set(min0, max0);
+    interval1.set(min1, max1);
 
     std::string range0Min = ofxTime::Utils::format(interval0.getStart());
     std::string range0Max = ofxTime::Utils::format(interval0.getEnd());
@@ -79,18 +77,13 @@ void ofApp::draw()
 {
     ofBackgroundGradient(ofColor::white, ofColor::black);
 
+    // map range0 onto the screen height.  the scale is computed once, and
+    // the integer microseconds are used directly, so no precision is lost.
+    ofxTime::IntervalMapper mapper(interval0, 0, ofGetHeight());
+
     // get the screen Y values of range1
-    float y0 = ofMap(interval1.getStart().utcTime(),
-                     interval0.getStart().utcTime(),
-                     interval0.getEnd().utcTime(),
-                     0,
-                     ofGetHeight());
-
-    float y1 = ofMap(interval1.getEnd().utcTime(),
-                     interval0.getStart().utcTime(),
-                     interval0.getEnd().utcTime(),
-                     0,
-                     ofGetHeight());
+    float y0 = mapper.map(interval1.getStart());
+    float y1 = mapper.map(interval1.getEnd());
 
     // draw range0
     ofFill();
@@ -118,11 +111,8 @@ void ofApp::draw()
     ofSetColor(255);
     ofDrawLine(0, ofGetMouseY(), ofGetWidth(), ofGetMouseY());
 
-    // calculate the noramlized cursor position
-    float normalizedMousePosition = ofGetMouseY() / (float)ofGetHeight();
-
-    // use the range0's lerp function to interpolate the date under the mouse
-    Poco::Timestamp ts = interval0.lerp(normalizedMousePosition);
+    // use the mapper to interpolate the date under the mouse
+    Poco::Timestamp ts = mapper.lerp(ofGetMouseY());
 
     // formate the interpolated date to a string
     std::string ts0 = ofxTime::Utils::format(ts);
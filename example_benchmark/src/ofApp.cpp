@@ -0,0 +1,904 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofApp.h"
+#include <queue>
+#include <random>
+
+
+void ofApp::setup()
+{
+    benchmarkGetInstances();
+    benchmarkCalendarTable();
+    benchmarkIntervalMapper();
+    benchmarkCompiledFormat();
+    benchmarkCompiledParser();
+    benchmarkColumnParser();
+    benchmarkTimeZone();
+    benchmarkLocalInstances();
+    benchmarkRRule();
+    benchmarkCronSchedule();
+    benchmarkTimingWheel();
+    benchmarkClock();
+    benchmarkIncrementalFormat();
+}
+
+
+void ofApp::draw()
+{
+    ofBackgroundGradient(ofColor::white, ofColor::black);
+    ofDrawBitmapStringHighlight(results.str(), 30, 30);
+}
+
+
+void ofApp::benchmarkGetInstances()
+{
+    // The reference is the generic loop, which calls Utils::add() once per
+    // instance and does not know the number of instances up front.
+    auto reference = [](const Poco::Timestamp& start,
+                        const Poco::Timestamp& end,
+                        const ofxTime::Period& period)
+    {
+        std::vector<Poco::Timestamp> results;
+
+        for (Poco::Timestamp t(start); t < end; t = ofxTime::Utils::add(t, period))
+        {
+            results.push_back(t);
+        }
+
+        return results;
+    };
+
+    const Poco::Timestamp start = Poco::DateTime(2018, 1, 1).timestamp();
+
+    const std::vector<std::pair<std::string, ofxTime::Period>> periods = {
+        { "getInstances() 1 us x 2M", ofxTime::Period::Microsecond() },
+        { "getInstances() 1 s x 2M", ofxTime::Period::Second() },
+        { "getInstances() 1 week x 2M", ofxTime::Period::Week() }
+    };
+
+    for (const auto& period: periods)
+    {
+        Poco::Timestamp end = start + period.second.getFixedMicroseconds() * 2000000;
+
+        std::vector<Poco::Timestamp> expected;
+        std::vector<Poco::Timestamp> actual;
+
+        double referenceMs = measure([&]() {
+            expected = reference(start, end, period.second);
+        });
+
+        double ms = measure([&]() {
+            actual = ofxTime::Utils::getInstances(start, end, period.second);
+        });
+
+        if (expected != actual)
+        {
+            ofLogError("ofApp::benchmarkGetInstances") << period.first << " results differ.";
+        }
+
+        report(period.first, referenceMs, ms);
+    }
+}
+
+
+void ofApp::benchmarkCalendarTable()
+{
+    const std::size_t size = 4000000;
+
+    std::vector<int64_t> timestamps(size);
+
+    // Uniformly distributed times between 1950 and 2100.
+    const int64_t first = ofxTime::CalendarTable::yearStart(1950);
+    const int64_t last = ofxTime::CalendarTable::yearStart(2100);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(first, last - 1);
+
+    for (auto& timestamp: timestamps)
+    {
+        timestamp = distribution(generator);
+    }
+
+    // Build the table before timing.
+    ofxTime::CalendarTable::floorMonth(first);
+
+    std::vector<int64_t> expected(size);
+    std::vector<int64_t> actual(size);
+
+    double referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            Poco::DateTime dateTime{Poco::Timestamp(timestamps[i])};
+            expected[i] = Poco::DateTime(dateTime.year(), dateTime.month(), 1).timestamp().epochMicroseconds();
+        }
+    });
+
+    double ms = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            actual[i] = ofxTime::CalendarTable::floorMonth(timestamps[i]);
+        }
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkCalendarTable") << "Poco::DateTime month starts differ.";
+    }
+
+    report("floorMonth() vs Poco 4M", referenceMs, ms);
+
+    referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected[i] = ofxTime::Calendar::floorMonth(timestamps[i]);
+        }
+    });
+
+    ms = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            actual[i] = ofxTime::CalendarTable::floorMonth(timestamps[i]);
+        }
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkCalendarTable") << "Computed month starts differ.";
+    }
+
+    report("floorMonth() vs Calendar 4M", referenceMs, ms);
+
+    referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected[i] = ofxTime::Calendar::addMonths(timestamps[i], 7);
+        }
+    });
+
+    ms = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            actual[i] = ofxTime::CalendarTable::addMonths(timestamps[i], 7);
+        }
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkCalendarTable") << "Month additions differ.";
+    }
+
+    report("addMonths() vs Calendar 4M", referenceMs, ms);
+
+    std::stringstream ss;
+    ss << "CalendarTable " << ofxTime::CalendarTable::FIRST_YEAR;
+    ss << "-" << ofxTime::CalendarTable::LAST_YEAR << ": ";
+    ss << ofxTime::CalendarTable::memorySize() << " bytes";
+
+    ofLogNotice("ofApp::benchmarkCalendarTable") << ss.str();
+
+    results << ss.str() << std::endl;
+}
+
+
+void ofApp::benchmarkIntervalMapper()
+{
+    const std::size_t size = 1000000;
+    const float height = 1080;
+
+    const ofxTime::Interval interval(Poco::DateTime(2000, 1, 1).timestamp(),
+                                     Poco::DateTime(2030, 1, 1).timestamp());
+
+    std::vector<int64_t> timestamps(size);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(interval.getStartMicroseconds(),
+                                                        interval.getEndMicroseconds());
+
+    for (auto& timestamp: timestamps)
+    {
+        timestamp = distribution(generator);
+    }
+
+    std::vector<float> expected(size);
+    std::vector<float> actual(size);
+
+    double referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected[i] = float(interval.map(Poco::Timestamp(timestamps[i]), false) * height);
+        }
+    });
+
+    ofxTime::IntervalMapper mapper(interval, 0, height);
+
+    double ms = measure([&]() {
+        mapper.map(timestamps.data(), actual.data(), size);
+    });
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (std::abs(expected[i] - actual[i]) > 0.001f)
+        {
+            ofLogError("ofApp::benchmarkIntervalMapper") << "Mapped values differ.";
+            break;
+        }
+    }
+
+    report("IntervalMapper::map() 1M", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkCompiledFormat()
+{
+    const std::size_t size = 1000000;
+    const std::string fmt = Poco::DateTimeFormat::ISO8601_FRAC_FORMAT;
+
+    // Sorted times about half a second apart, like a log.
+    std::vector<int64_t> timestamps(size);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(0, 1000000);
+
+    int64_t timestamp = Poco::DateTime(2020, 1, 1).timestamp().epochMicroseconds();
+
+    for (auto& t: timestamps)
+    {
+        timestamp += distribution(generator);
+        t = timestamp;
+    }
+
+    std::string expected;
+
+    double referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected += ofxTime::Utils::format(Poco::Timestamp(timestamps[i]), fmt);
+            expected += '\n';
+        }
+    });
+
+    ofxTime::CompiledFormat compiled(fmt);
+
+    std::vector<char> buffer(size * (compiled.getMaxSize() + 1));
+    std::size_t written = 0;
+
+    double ms = measure([&]() {
+        written = compiled.format(timestamps.data(), size, buffer.data());
+    });
+
+    if (expected != std::string(buffer.data(), written))
+    {
+        ofLogError("ofApp::benchmarkCompiledFormat") << "Formatted times differ.";
+    }
+
+    report("CompiledFormat column 1M", referenceMs, ms);
+
+    char text[64];
+
+    ms = measure([&]() {
+        written = 0;
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            written += compiled.format(timestamps[i], text);
+        }
+    });
+
+    if (written + size != expected.size())
+    {
+        ofLogError("ofApp::benchmarkCompiledFormat") << "Formatted sizes differ.";
+    }
+
+    report("CompiledFormat single 1M", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkCompiledParser()
+{
+    const std::size_t size = 1000000;
+    const std::string fmt = Poco::DateTimeFormat::ISO8601_FRAC_FORMAT;
+
+    std::vector<int64_t> timestamps(size);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(0, 1000000);
+
+    int64_t timestamp = Poco::DateTime(2020, 1, 1).timestamp().epochMicroseconds();
+
+    for (auto& t: timestamps)
+    {
+        timestamp += distribution(generator);
+        t = timestamp;
+    }
+
+    // A newline separated buffer, as read from a log.
+    ofxTime::CompiledFormat format(fmt);
+    std::vector<char> buffer(size * (format.getMaxSize() + 1));
+    buffer.resize(format.format(timestamps.data(), size, buffer.data()));
+
+    std::vector<std::string> lines;
+    lines.reserve(size);
+
+    const char* end = buffer.data() + buffer.size();
+
+    for (const char* p = buffer.data(); p != end; )
+    {
+        const char* newline = std::find(p, end, '\n');
+        lines.emplace_back(p, newline);
+        p = newline + 1;
+    }
+
+    std::vector<int64_t> expected(size);
+    std::vector<int64_t> actual(size);
+
+    double referenceMs = measure([&]() {
+        try
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                Poco::DateTime dateTime;
+                int tzd = 0;
+                Poco::DateTimeParser::parse(fmt, lines[i], dateTime, tzd);
+                dateTime.makeUTC(tzd);
+                expected[i] = dateTime.timestamp().epochMicroseconds();
+            }
+        }
+        catch (const Poco::SyntaxException& exc)
+        {
+            ofLogError("ofApp::benchmarkCompiledParser") << "Syntax exception: " << exc.displayText();
+        }
+    });
+
+    ofxTime::CompiledParser parser(fmt);
+    std::size_t parsed = 0;
+
+    double ms = measure([&]() {
+        parsed = parser.parse(buffer.data(), buffer.size(), actual.data());
+    });
+
+    if (parsed != size || actual != timestamps)
+    {
+        ofLogError("ofApp::benchmarkCompiledParser") << "Parsed times differ.";
+    }
+
+    report("CompiledParser lines 1M", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkColumnParser()
+{
+    const std::size_t size = 4000000;
+
+    // A CSV file with a header line and the time in the second column.
+    ofxTime::CompiledFormat format(Poco::DateTimeFormat::ISO8601_FORMAT);
+
+    std::string csv = "id,time,value\n";
+    csv.reserve(size * (format.getMaxSize() + 16));
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(0, 1000000);
+
+    int64_t timestamp = Poco::DateTime(2020, 1, 1).timestamp().epochMicroseconds();
+    char text[64];
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        timestamp += distribution(generator);
+        csv += std::to_string(i);
+        csv += ',';
+        csv.append(text, format.format(timestamp, text));
+        csv += ",1.0\n";
+    }
+
+    ofxTime::ColumnParser::Settings settings;
+    settings.column = 1;
+    settings.headerLines = 1;
+    settings.threads = 1;
+
+    ofxTime::CompiledParser parser(Poco::DateTimeFormat::ISO8601_FORMAT);
+
+    ofxTime::ColumnParser::Timestamps expected;
+    ofxTime::ColumnParser::Timestamps actual;
+    std::vector<ofxTime::ColumnParser::Report> reports;
+
+    double referenceMs = measure([&]() {
+        ofxTime::ColumnParser(parser, settings).parse(csv.data(), csv.size(), expected, reports);
+    });
+
+    settings.threads = 0;
+
+    double ms = measure([&]() {
+        ofxTime::ColumnParser(parser, settings).parse(csv.data(), csv.size(), actual, reports);
+    });
+
+    if (expected != actual || actual.size() != size)
+    {
+        ofLogError("ofApp::benchmarkColumnParser") << "Parsed columns differ.";
+    }
+
+    std::stringstream ss;
+    ss << "ColumnParser " << reports.size() << " threads";
+
+    report(ss.str(), referenceMs, ms);
+}
+
+
+void ofApp::report(const std::string& name, double referenceMs, double ms)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << std::setw(32) << std::left << name;
+    ss << " reference: " << std::setw(9) << std::right << referenceMs << " ms";
+    ss << " ofxTime: " << std::setw(9) << ms << " ms";
+    ss << " speedup: " << std::setw(7) << (referenceMs / std::max(ms, 0.001)) << "x";
+
+    ofLogNotice("ofApp::report") << ss.str();
+
+    results << ss.str() << std::endl;
+}
+
+
+void ofApp::benchmarkTimeZone()
+{
+    const std::size_t size = 1000000;
+
+    std::shared_ptr<const ofxTime::TimeZone> zone = ofxTime::TimeZone::local();
+
+    // Sorted times over ten years, crossing many transitions.
+    std::vector<int64_t> timestamps(size);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(Poco::DateTime(2020, 1, 1).timestamp().epochMicroseconds(),
+                                                        Poco::DateTime(2030, 1, 1).timestamp().epochMicroseconds());
+
+    for (auto& t: timestamps)
+    {
+        t = distribution(generator);
+    }
+
+    std::sort(timestamps.begin(), timestamps.end());
+
+    std::vector<int64_t> expected(size);
+    std::vector<int64_t> actual(size);
+
+    // Poco::LocalDateTime looks up the process time zone for each time.
+    double referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected[i] = Poco::LocalDateTime(Poco::DateTime(Poco::Timestamp(timestamps[i]))).timestamp().epochMicroseconds();
+        }
+    });
+
+    double ms = measure([&]() {
+        zone->toLocal(timestamps.data(), actual.data(), size);
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkTimeZone") << "Local times differ.";
+    }
+
+    report("TimeZone toLocal() 1M", referenceMs, ms);
+
+    // The reference rounds with the offset of the original time, so the
+    // results only differ on days with a transition.
+    referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            Poco::DateTime utc = Poco::Timestamp(timestamps[i]);
+            Poco::LocalDateTime local(utc);
+            expected[i] = ofxTime::Utils::toUtcTimestamp(ofxTime::Utils::floor(local, ofxTime::Period::DAY)).epochMicroseconds();
+        }
+    });
+
+    ms = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            actual[i] = ofxTime::Utils::floor(Poco::Timestamp(timestamps[i]), ofxTime::Period::DAY, *zone).epochMicroseconds();
+        }
+    });
+
+    report("TimeZone floor() DAY 1M", referenceMs, ms);
+
+    // 01:10 EST is in the second pass of the repeated hour, so rounding to
+    // half an hour must keep the EST offset.
+    std::shared_ptr<const ofxTime::TimeZone> eastern = ofxTime::TimeZone::fromPosix("EST5EDT,M3.2.0,M11.1.0");
+
+    const Poco::Timestamp time = Poco::DateTime(2021, 11, 7, 6, 10).timestamp();
+
+    if (ofxTime::Utils::ceiling(time, Poco::Timespan(0, 0, 30, 0, 0), *eastern) != Poco::DateTime(2021, 11, 7, 6, 30).timestamp()
+     || ofxTime::Utils::floor(time, Poco::Timespan(0, 0, 30, 0, 0), *eastern) != Poco::DateTime(2021, 11, 7, 6, 0).timestamp())
+    {
+        ofLogError("ofApp::benchmarkTimeZone") << "Rounding in the repeated hour changed the offset.";
+    }
+}
+
+
+void ofApp::benchmarkLocalInstances()
+{
+    const std::size_t size = 100000;
+
+    std::shared_ptr<const ofxTime::TimeZone> zone = ofxTime::TimeZone::local();
+
+    // Every day at 09:00 local time.
+    const Poco::LocalDateTime first(2000, 1, 1, 9);
+
+    std::vector<Poco::Timestamp> expected;
+    std::vector<Poco::Timestamp> actual;
+
+    // The reference builds each local time from its calendar fields, so
+    // Poco::LocalDateTime looks up the offset for every instance.
+    double referenceMs = measure([&]() {
+        expected.clear();
+        expected.reserve(size);
+
+        Poco::DateTime date(first.year(), first.month(), first.day());
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            Poco::LocalDateTime local(date.year(), date.month(), date.day(), 9);
+            expected.push_back(local.utc().timestamp());
+            date += Poco::Timespan(1, 0, 0, 0, 0);
+        }
+    });
+
+    double ms = measure([&]() {
+        actual = ofxTime::Utils::getInstances(first.utc().timestamp(),
+                                              size,
+                                              ofxTime::Period::Day(),
+                                              *zone);
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkLocalInstances") << "Instances differ.";
+    }
+
+    report("getInstances() local day x 100k", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkRRule()
+{
+    const std::size_t size = 1000;
+
+    // The second and last weekday of every month at 09:30.
+    const ofxTime::RRule rule(Poco::DateTime(2000, 1, 1, 9, 30).timestamp(),
+                              "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=2,-1");
+
+    std::mt19937 engine(0);
+
+    std::uniform_int_distribution<Poco::Timestamp::TimeVal> distribution(Poco::DateTime(2000, 1, 1).timestamp().epochMicroseconds(),
+                                                                         Poco::DateTime(2100, 1, 1).timestamp().epochMicroseconds());
+
+    std::vector<Poco::Timestamp> times;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        times.push_back(distribution(engine));
+    }
+
+    std::vector<Poco::Timestamp> expected;
+    std::vector<Poco::Timestamp> actual;
+
+    // The reference iterates over every instance from the start, as an
+    // expander without skip-ahead must.
+    double referenceMs = measure([&]() {
+        expected.clear();
+
+        for (const Poco::Timestamp& time: times)
+        {
+            ofxTime::RRule::Iterator iter = rule.begin();
+
+            while (iter != rule.end() && *iter <= time)
+            {
+                ++iter;
+            }
+
+            expected.push_back(*iter);
+        }
+    });
+
+    double ms = measure([&]() {
+        actual.clear();
+
+        for (const Poco::Timestamp& time: times)
+        {
+            Poco::Timestamp instance;
+            rule.next(time, instance);
+            actual.push_back(instance);
+        }
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkRRule") << "Instances differ.";
+    }
+
+    report("RRule next() x 1k", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkCronSchedule()
+{
+    const std::vector<std::string> expressions = {
+        "*/5 * * * *",
+        "0 * * * *",
+        "30 9 * * MON-FRI",
+        "0 0 * * SUN",
+        "15 2 1 * *",
+        "0 12 1,15 * *",
+        "0 0 1 1 *",
+        "0 6 29 2 *",
+        "45 23 28-31 * *",
+        "0 8-17/3 * JUN-AUG SAT,SUN"
+    };
+
+    std::vector<ofxTime::CronSchedule> schedules;
+
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        const ofxTime::CronSchedule schedule(expressions[i % expressions.size()]);
+
+        if (schedule.isValid())
+        {
+            schedules.push_back(schedule);
+        }
+    }
+
+    const Poco::Timestamp after = Poco::DateTime(2021, 3, 14, 15, 9, 26).timestamp();
+
+    std::vector<int64_t> expected(schedules.size(), std::numeric_limits<int64_t>::max());
+    std::vector<int64_t> actual(schedules.size());
+
+    // The reference steps through every minute of the next four years, the
+    // longest gap between two February 29ths, and tests each one.
+    double referenceMs = measure([&]() {
+        std::vector<Poco::Timestamp> minutes = ofxTime::Utils::getInstances(ofxTime::Utils::ceiling(after + 1, ofxTime::Period::MINUTE),
+                                                                            after + Poco::Timespan(4 * 366, 0, 0, 0, 0).totalMicroseconds(),
+                                                                            ofxTime::Period::Minute());
+
+        for (std::size_t i = 0; i < schedules.size(); ++i)
+        {
+            for (const Poco::Timestamp& minute: minutes)
+            {
+                if (schedules[i].matches(minute))
+                {
+                    expected[i] = minute.epochMicroseconds();
+                    break;
+                }
+            }
+        }
+    });
+
+    double ms = measure([&]() {
+        ofxTime::CronSchedule::next(schedules.data(),
+                                    schedules.size(),
+                                    after.epochMicroseconds(),
+                                    actual.data());
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkCronSchedule") << "Fire times differ.";
+    }
+
+    report("CronSchedule next() x 100", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkTimingWheel()
+{
+    const std::size_t count = 1000000;
+    const Poco::Timestamp start = Poco::DateTime(2021, 3, 14, 15, 9, 26).timestamp();
+    const Poco::Timespan resolution(0, 0, 0, 0, 1000);
+    const Poco::Timespan duration(0, 0, 1, 0, 0);
+
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<Poco::Timestamp::TimeVal> distribution(0, duration.totalMicroseconds() - 1);
+
+    std::vector<Poco::Timestamp> deadlines;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        deadlines.push_back(start + distribution(generator));
+    }
+
+    // Each benchmark schedules every timer, cancels every other one and
+    // then steps through the whole duration one resolution at a time.
+    std::size_t expected = 0;
+
+    // The reference is a binary heap of deadlines and callbacks, which
+    // cannot remove a timer, so cancelled timers are marked and skipped
+    // when they reach the top.
+    double referenceMs = measure([&]() {
+        typedef std::pair<Poco::Timestamp::TimeVal, std::size_t> Timer;
+
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+        std::vector<ofxTime::TimingWheel::Callback> callbacks;
+        std::vector<bool> isCancelled;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            timers.push(Timer(deadlines[i].epochMicroseconds(), callbacks.size()));
+
+            callbacks.push_back([&](const Poco::Timestamp&) {
+                ++expected;
+            });
+
+            isCancelled.push_back(false);
+        }
+
+        for (std::size_t i = 0; i < count; i += 2)
+        {
+            isCancelled[i] = true;
+        }
+
+        for (Poco::Timestamp now = start; now <= start + duration.totalMicroseconds(); now += resolution.totalMicroseconds())
+        {
+            while (!timers.empty() && timers.top().first <= now.epochMicroseconds())
+            {
+                const Timer timer = timers.top();
+                timers.pop();
+
+                if (!isCancelled[timer.second])
+                {
+                    callbacks[timer.second](Poco::Timestamp(timer.first));
+                }
+            }
+        }
+    });
+
+    std::size_t actual = 0;
+
+    double ms = measure([&]() {
+        ofxTime::TimingWheel wheel(resolution, start);
+        std::vector<ofxTime::TimingWheel::Timer> timers;
+        timers.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            timers.push_back(wheel.schedule(deadlines[i], [&](const Poco::Timestamp&) {
+                ++actual;
+            }));
+        }
+
+        for (std::size_t i = 0; i < count; i += 2)
+        {
+            wheel.cancel(timers[i]);
+        }
+
+        for (Poco::Timestamp now = start; now <= start + duration.totalMicroseconds(); now += resolution.totalMicroseconds())
+        {
+            wheel.advance(now);
+        }
+    });
+
+    if (expected != actual)
+    {
+        ofLogError("ofApp::benchmarkTimingWheel") << "Fired timers differ.";
+    }
+
+    report("TimingWheel 1M timers", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkClock()
+{
+    const std::size_t size = 1000000;
+
+    // The last time read by each benchmark, which must be close.
+    int64_t expected = 0;
+    int64_t actual = 0;
+
+    auto check = [&]() {
+        if (std::abs(expected - actual) > Poco::Timespan::SECONDS)
+        {
+            ofLogError("ofApp::benchmarkClock") << "Times differ.";
+        }
+    };
+
+    double referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected = Poco::Timestamp().epochMicroseconds();
+        }
+    });
+
+    for (ofxTime::Clock::Source source: { ofxTime::Clock::REALTIME_COARSE, ofxTime::Clock::TSC })
+    {
+        const ofxTime::Clock clock(source);
+
+        // Read once first, so that the TSC calibration is not measured.
+        actual = clock.getMicroseconds();
+
+        double ms = measure([&]() {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                actual = clock.getMicroseconds();
+            }
+        });
+
+        check();
+        report(source == ofxTime::Clock::TSC ? "Clock TSC 1M" : "Clock REALTIME_COARSE 1M", referenceMs, ms);
+    }
+
+    // Each request or frame reads the local time, which looks up the time
+    // zone for each Poco::LocalDateTime.
+    referenceMs = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            expected = Poco::LocalDateTime(Poco::Timestamp()).timestamp().epochMicroseconds();
+        }
+    });
+
+    ofxTime::CachedClock clock;
+    clock.start(Poco::Timespan(0, 0, 0, 0, 1000));
+
+    double ms = measure([&]() {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            actual = clock.getLocalDateTime().timestamp().epochMicroseconds();
+        }
+    });
+
+    check();
+    report("CachedClock local 1M", referenceMs, ms);
+}
+
+
+void ofApp::benchmarkIncrementalFormat()
+{
+    const std::size_t size = 1000000;
+
+    // Sorted times about a millisecond apart, like a busy log.
+    std::vector<int64_t> timestamps(size);
+
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int64_t> distribution(0, 2000);
+
+    int64_t timestamp = Poco::DateTime(2020, 1, 1).timestamp().epochMicroseconds();
+
+    for (auto& t: timestamps)
+    {
+        timestamp += distribution(generator);
+        t = timestamp;
+    }
+
+    for (const std::string& fmt: { Poco::DateTimeFormat::RFC1123_FORMAT, Poco::DateTimeFormat::ISO8601_FRAC_FORMAT })
+    {
+        std::string expected;
+
+        double referenceMs = measure([&]() {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                expected += Poco::DateTimeFormatter::format(Poco::Timestamp(timestamps[i]), fmt);
+                expected += '\n';
+            }
+        });
+
+        std::string actual;
+
+        double ms = measure([&]() {
+            ofxTime::IncrementalFormat& format = ofxTime::IncrementalFormat::getThreadLocal(fmt);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                actual += format.format(Poco::Timestamp(timestamps[i]));
+                actual += '\n';
+            }
+        });
+
+        if (expected != actual)
+        {
+            ofLogError("ofApp::benchmarkIncrementalFormat") << "Formatted times differ.";
+        }
+
+        report(fmt == Poco::DateTimeFormat::RFC1123_FORMAT ? "IncrementalFormat RFC1123 1M" : "IncrementalFormat ISO8601 1M", referenceMs, ms);
+    }
+}
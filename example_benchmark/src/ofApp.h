@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include "ofMain.h"
+#include "ofxTime.h"
+
+
+class ofApp: public ofBaseApp
+{
+public:
+    void setup() override;
+    void draw() override;
+
+    /// \brief Compare Utils::getInstances() against a per-step Utils::add().
+    void benchmarkGetInstances();
+
+    /// \brief Compare CalendarTable lookups against computed month starts.
+    void benchmarkCalendarTable();
+
+    /// \brief Compare IntervalMapper against Interval::map() per time.
+    void benchmarkIntervalMapper();
+
+    /// \brief Compare CompiledFormat against Utils::format().
+    void benchmarkCompiledFormat();
+
+    /// \brief Compare CompiledParser against Poco::DateTimeParser.
+    void benchmarkCompiledParser();
+
+    /// \brief Compare a multi-threaded ColumnParser against one thread.
+    void benchmarkColumnParser();
+
+    /// \brief Compare TimeZone against Poco::LocalDateTime conversions.
+    void benchmarkTimeZone();
+
+    /// \brief Compare local time instances against Poco::LocalDateTime.
+    void benchmarkLocalInstances();
+
+    /// \brief Compare RRule::next() against iterating from the start.
+    void benchmarkRRule();
+
+    /// \brief Compare CronSchedule::next() against filtering every minute.
+    void benchmarkCronSchedule();
+
+    /// \brief Compare TimingWheel against a std::priority_queue of timers.
+    void benchmarkTimingWheel();
+
+    /// \brief Compare Clock and CachedClock against Poco::Timestamp().
+    void benchmarkClock();
+
+    /// \brief Compare IncrementalFormat against Poco::DateTimeFormatter.
+    void benchmarkIncrementalFormat();
+
+    /// \brief Log and store a line of benchmark output.
+    void report(const std::string& name, double referenceMs, double ms);
+
+    /// \returns the time taken to run the given function in milliseconds.
+    template <typename Function>
+    static double measure(Function function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::stringstream results;
+
+};
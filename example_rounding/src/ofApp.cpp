@@ -8,14 +8,21 @@
 #include "ofApp.h"
 
 
+void ofApp::update()
+{
+    // Read the time once per frame.  The local time is computed here, so
+    // draw() does not look up the time zone.
+    clock.update();
+}
+
+
 void ofApp::draw()
 {
     // TODO: add example for any arbitrary ofx::Time::Period
 
     ofBackgroundGradient(ofColor::white, ofColor::black);
 
-    Poco::Timestamp now;
-    Poco::LocalDateTime nowLocal(now);
+    Poco::LocalDateTime nowLocal = clock.getLocalDateTime();
 
     int w = 14;
 
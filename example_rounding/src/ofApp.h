@@ -15,6 +15,10 @@
 class ofApp: public ofBaseApp
 {
 public:
+    void update() override;
     void draw() override;
 
+    /// \brief The time of the current frame, read once in update().
+    ofxTime::CachedClock clock;
+
 };
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Bit scans for the 64-bit bitmaps used by the columnar queries
+///        and the schedulers.
+///
+/// \note This is an implementation detail and is not included by
+///       ofxTime.h.
+class Bits
+{
+public:
+    /// \returns the index of the lowest set bit of a non-zero word.
+    static int lowestBit(uint64_t word);
+
+    /// \returns the index of the highest set bit of a non-zero word.
+    static int highestBit(uint64_t word);
+
+};
+
+
+inline int Bits::lowestBit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    return int(index);
+#else
+    int index = 0;
+
+    while (0 == (word & 1))
+    {
+        word >>= 1;
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+
+inline int Bits::highestBit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, word);
+    return int(index);
+#else
+    int index = 0;
+
+    while (word >>= 1)
+    {
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include "Poco/LocalDateTime.h"
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Clock.h"
+#include "ofx/Time/SeqLock.h"
+#include "ofx/Time/TimeZone.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A clock that is read once and then shared.
+///
+/// Programs that need "now" many times per frame or per request can read
+/// it once into a CachedClock with update(), or have a background thread
+/// update it at a fixed interval with start().  Reading the UTC time is
+/// then a single atomic load.  The local time and its offset are computed
+/// when the clock is updated and published together, so reading them needs
+/// no time zone lookup and they always belong to the same update.
+///
+/// \code{.cpp}
+/// ofxTime::CachedClock clock;
+///
+/// // Once per frame, in ofApp::update().
+/// clock.update();
+///
+/// // Anywhere in the frame.
+/// Poco::LocalDateTime now = clock.getLocalDateTime();
+/// \endcode
+class CachedClock
+{
+public:
+    /// \brief Create a CachedClock and update it.
+    /// \param source The source of the time.
+    /// \param zone The time zone of the local time.
+    CachedClock(Clock::Source source = Clock::REALTIME,
+                std::shared_ptr<const TimeZone> zone = TimeZone::local());
+
+    CachedClock(const CachedClock&) = delete;
+    CachedClock& operator = (const CachedClock&) = delete;
+
+    /// \brief Stop the background thread, if any.
+    ~CachedClock();
+
+    /// \brief Read the source and store the time.
+    void update();
+
+    /// \brief Update the clock at a fixed interval on a background thread.
+    /// \param interval The interval between updates.
+    void start(const Poco::Timespan& interval);
+
+    /// \brief Stop the background thread started with start().
+    void stop();
+
+    /// \returns the cached time in microseconds since the epoch.
+    int64_t getMicroseconds() const;
+
+    /// \returns the cached time.
+    Poco::Timestamp now() const;
+
+    /// \returns the cached local time in microseconds since the local
+    ///          epoch.
+    int64_t getLocalMicroseconds() const;
+
+    /// \returns the cached local time.
+    Poco::LocalDateTime getLocalDateTime() const;
+
+    /// \returns the time zone of the local time.
+    const TimeZone& getTimeZone() const;
+
+private:
+    /// \brief A local time and its offset from UTC.
+    struct LocalTime
+    {
+        /// \brief The local time in microseconds.
+        int64_t microseconds = 0;
+
+        /// \brief The offset of the local time from UTC in seconds.
+        int64_t offset = 0;
+    };
+
+    /// \brief The loop run by the background thread.
+    void run(Poco::Timespan::TimeDiff interval);
+
+    /// \brief The source of the time.
+    Clock _clock;
+
+    /// \brief The time zone of the local time.
+    std::shared_ptr<const TimeZone> _zone;
+
+    /// \brief The UTC time in microseconds.
+    std::atomic<int64_t> _utc;
+
+    /// \brief The local time and its offset.
+    SeqLock<LocalTime> _local;
+
+    /// \brief The background thread, if any.
+    std::thread _thread;
+
+    /// \brief Protects _isStopping.
+    std::mutex _mutex;
+
+    /// \brief Signaled when the background thread should stop.
+    std::condition_variable _condition;
+
+    /// \brief True when the background thread should stop.
+    bool _isStopping = false;
+
+};
+
+
+} } // namespace ofx::Time
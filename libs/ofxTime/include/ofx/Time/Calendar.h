@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <stdint.h>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Integer proleptic Gregorian calendar arithmetic.
+///
+/// Calendar operates directly on days and microseconds since the Unix epoch
+/// (1970-01-01T00:00:00Z), the same epoch used by Poco::Timestamp.  It does
+/// not construct Poco::DateTime objects, allocate, log or throw, so it is
+/// suitable for use in tight loops.
+///
+/// The day conversions are based on Howard Hinnant's `days_from_civil` and
+/// `civil_from_days` algorithms and are valid for all dates whose day count
+/// fits in an int64_t.
+///
+/// For more information, please see:
+///   - http://howardhinnant.github.io/date_algorithms.html
+class Calendar
+{
+public:
+    /// \brief A year, month and day in the proleptic Gregorian calendar.
+    struct Date
+    {
+        /// \brief The year.
+        int64_t year;
+
+        /// \brief The month of the year [1, 12].
+        int month;
+
+        /// \brief The day of the month [1, 31].
+        int day;
+    };
+
+    enum: int64_t
+    {
+        /// \brief The number of microseconds in a day.
+        MICROSECONDS_PER_DAY = INT64_C(86400000000)
+    };
+
+    /// \brief The fields that can be extracted from a time.
+    ///
+    /// The ranges match the equivalent Poco::DateTime accessors.
+    enum Field
+    {
+        /// \brief The year.
+        YEAR,
+        /// \brief The month of the year [1, 12].
+        MONTH,
+        /// \brief The day of the month [1, 31].
+        DAY,
+        /// \brief The day of the week [0, 6], where 0 is Sunday.
+        DAY_OF_WEEK,
+        /// \brief The day of the year [1, 366].
+        DAY_OF_YEAR,
+        /// \brief The hour of the day [0, 23].
+        HOUR,
+        /// \brief The minute of the hour [0, 59].
+        MINUTE,
+        /// \brief The second of the minute [0, 59].
+        SECOND,
+        /// \brief The millisecond of the second [0, 999].
+        MILLISECOND,
+        /// \brief The microsecond of the millisecond [0, 999].
+        MICROSECOND
+    };
+
+    /// \brief Divide, rounding toward negative infinity.
+    /// \param numerator The numerator.
+    /// \param denominator The denominator, must be > 0.
+    /// \returns the floored quotient.
+    static constexpr int64_t floorDivide(int64_t numerator,
+                                         int64_t denominator) noexcept
+    {
+        return numerator / denominator - (numerator % denominator < 0);
+    }
+
+    /// \param year The year.
+    /// \returns true iff the year is a leap year.
+    static constexpr bool isLeapYear(int64_t year) noexcept
+    {
+        return (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0));
+    }
+
+    /// \param year The year.
+    /// \param month The month [1, 12].
+    /// \returns the number of days in the given month.
+    static constexpr int daysInMonth(int64_t year, int month) noexcept
+    {
+        return month == 2 ? (isLeapYear(year) ? 29 : 28)
+                          : 30 + ((month + (month >> 3)) & 1);
+    }
+
+    /// \brief Convert a civil date to days since 1970-01-01.
+    /// \param year The year.
+    /// \param month The month [1, 12].
+    /// \param day The day of the month [1, 31].
+    /// \returns the number of days since 1970-01-01.
+    static constexpr int64_t daysFromCivil(int64_t year,
+                                           int month,
+                                           int day) noexcept
+    {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t yearOfEra = year - era * 400;
+        const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    /// \brief Convert days since 1970-01-01 to a civil date.
+    /// \param days The number of days since 1970-01-01.
+    /// \returns the civil date.
+    static constexpr Date civilFromDays(int64_t days) noexcept
+    {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const int64_t dayOfEra = days - era * 146097;
+        const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+        const int day = int(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+        const int month = int(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+        return Date{ yearOfEra + era * 400 + (month <= 2), month, day };
+    }
+
+    /// \brief Get the day of the week of a day.
+    /// \param days The number of days since 1970-01-01.
+    /// \returns the day of the week [0, 6], where 0 is Sunday.
+    static constexpr int dayOfWeek(int64_t days) noexcept
+    {
+        // 1970-01-01 was a Thursday.
+        return int(days - floorDivide(days + 4, 7) * 7 + 4);
+    }
+
+    /// \brief Add calendar months to a time.
+    ///
+    /// The time of day is preserved.  If the resulting month has fewer days
+    /// than the starting day of the month, the day is clamped to the last
+    /// day of the resulting month (e.g. Jan 31 + 1 month = Feb 28 or 29).
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \param months The number of months to add, can be negative.
+    /// \returns the resulting time in microseconds since the epoch.
+    static constexpr int64_t addMonths(int64_t microseconds,
+                                       int64_t months) noexcept
+    {
+        const int64_t days = floorDivide(microseconds, MICROSECONDS_PER_DAY);
+        const int64_t timeOfDay = microseconds - days * MICROSECONDS_PER_DAY;
+        const Date date = civilFromDays(days);
+        const int64_t totalMonths = date.year * 12 + (date.month - 1) + months;
+        const int64_t year = floorDivide(totalMonths, 12);
+        const int month = int(totalMonths - year * 12) + 1;
+        const int lastDay = daysInMonth(year, month);
+        const int day = date.day < lastDay ? date.day : lastDay;
+        return daysFromCivil(year, month, day) * MICROSECONDS_PER_DAY + timeOfDay;
+    }
+
+    /// \brief Add calendar years to a time.
+    ///
+    /// The month, day and time of day are preserved.  February 29 is
+    /// clamped to February 28 when the resulting year is not a leap year.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \param years The number of years to add, can be negative.
+    /// \returns the resulting time in microseconds since the epoch.
+    static constexpr int64_t addYears(int64_t microseconds,
+                                      int64_t years) noexcept
+    {
+        return addMonths(microseconds, years * 12);
+    }
+
+    /// \brief Round a time down to the start of its month.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the first microsecond of the month.
+    static constexpr int64_t floorMonth(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        return daysFromCivil(date.year, date.month, 1) * MICROSECONDS_PER_DAY;
+    }
+
+    /// \brief Round a time up to the start of a month.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the first microsecond of the next month, or the given time
+    ///          if it is already the start of a month.
+    static constexpr int64_t ceilingMonth(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        const int64_t start = daysFromCivil(date.year, date.month, 1) * MICROSECONDS_PER_DAY;
+        return start == microseconds ? start
+             : start + daysInMonth(date.year, date.month) * MICROSECONDS_PER_DAY;
+    }
+
+    /// \brief Round a time to the nearest start of a month.
+    ///
+    /// Times exactly halfway between two month starts are rounded up.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the nearest first microsecond of a month.
+    static constexpr int64_t roundMonth(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        const int64_t start = daysFromCivil(date.year, date.month, 1) * MICROSECONDS_PER_DAY;
+        const int64_t end = start + daysInMonth(date.year, date.month) * MICROSECONDS_PER_DAY;
+        return (microseconds - start) < (end - microseconds) ? start : end;
+    }
+
+    /// \brief Round a time down to the start of its year.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the first microsecond of the year.
+    static constexpr int64_t floorYear(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        return daysFromCivil(date.year, 1, 1) * MICROSECONDS_PER_DAY;
+    }
+
+    /// \brief Round a time up to the start of a year.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the first microsecond of the next year, or the given time if
+    ///          it is already the start of a year.
+    static constexpr int64_t ceilingYear(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        const int64_t start = daysFromCivil(date.year, 1, 1) * MICROSECONDS_PER_DAY;
+        return start == microseconds ? start
+             : daysFromCivil(date.year + 1, 1, 1) * MICROSECONDS_PER_DAY;
+    }
+
+    /// \brief Round a time to the nearest start of a year.
+    ///
+    /// Times exactly halfway between two year starts are rounded up.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the nearest first microsecond of a year.
+    static constexpr int64_t roundYear(int64_t microseconds) noexcept
+    {
+        const Date date = civilFromDays(floorDivide(microseconds, MICROSECONDS_PER_DAY));
+        const int64_t start = daysFromCivil(date.year, 1, 1) * MICROSECONDS_PER_DAY;
+        const int64_t end = daysFromCivil(date.year + 1, 1, 1) * MICROSECONDS_PER_DAY;
+        return (microseconds - start) < (end - microseconds) ? start : end;
+    }
+};
+
+
+} } // namespace ofx::Time
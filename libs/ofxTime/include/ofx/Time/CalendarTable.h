@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include "ofx/Time/Calendar.h"
+
+
+/// \brief The first year covered by the CalendarTable.
+#if !defined(OFX_TIME_CALENDAR_TABLE_FIRST_YEAR)
+    #define OFX_TIME_CALENDAR_TABLE_FIRST_YEAR 1900
+#endif
+
+/// \brief The last year covered by the CalendarTable.
+#if !defined(OFX_TIME_CALENDAR_TABLE_LAST_YEAR)
+    #define OFX_TIME_CALENDAR_TABLE_LAST_YEAR 2200
+#endif
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Precomputed month-start times for a span of years.
+///
+/// CalendarTable holds the epoch microseconds of the first instant of every
+/// month from January of OFX_TIME_CALENDAR_TABLE_FIRST_YEAR through January
+/// of the year after OFX_TIME_CALENDAR_TABLE_LAST_YEAR.  Year starts are the
+/// January entries.  The table is built on first use and is cache-line
+/// aligned.
+///
+/// Inside the span, month and year floors, month and year additions and
+/// date extraction are a constant-time table lookup.  Outside the span the
+/// functions fall back to the equivalent Calendar computation, so results
+/// are always identical to Calendar.
+///
+/// Define OFX_TIME_CALENDAR_TABLE_FIRST_YEAR and
+/// OFX_TIME_CALENDAR_TABLE_LAST_YEAR to change the span.
+class CalendarTable
+{
+public:
+    enum
+    {
+        /// \brief The first year in the table.
+        FIRST_YEAR = OFX_TIME_CALENDAR_TABLE_FIRST_YEAR,
+
+        /// \brief The last year in the table.
+        LAST_YEAR = OFX_TIME_CALENDAR_TABLE_LAST_YEAR,
+
+        /// \brief The number of months in the table.
+        NUM_MONTHS = (LAST_YEAR - FIRST_YEAR + 1) * 12
+    };
+
+    static_assert(FIRST_YEAR <= LAST_YEAR,
+                  "OFX_TIME_CALENDAR_TABLE_FIRST_YEAR must not be after OFX_TIME_CALENDAR_TABLE_LAST_YEAR.");
+
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns true iff the time is covered by the table.
+    static bool contains(int64_t microseconds);
+
+    /// \brief Get the start of a month.
+    /// \param year The year.
+    /// \param month The month [1, 12].
+    /// \returns the first microsecond of the month.
+    static int64_t monthStart(int64_t year, int month);
+
+    /// \brief Get the start of a year.
+    /// \param year The year.
+    /// \returns the first microsecond of the year.
+    static int64_t yearStart(int64_t year);
+
+    /// \brief Round a time down to the start of its month.
+    /// \sa Calendar::floorMonth()
+    static int64_t floorMonth(int64_t microseconds);
+
+    /// \brief Round a time down to the start of its year.
+    /// \sa Calendar::floorYear()
+    static int64_t floorYear(int64_t microseconds);
+
+    /// \brief Round a time up to the start of a month.
+    /// \sa Calendar::ceilingMonth()
+    static int64_t ceilingMonth(int64_t microseconds);
+
+    /// \brief Round a time up to the start of a year.
+    /// \sa Calendar::ceilingYear()
+    static int64_t ceilingYear(int64_t microseconds);
+
+    /// \brief Round a time to the nearest start of a month.
+    /// \sa Calendar::roundMonth()
+    static int64_t roundMonth(int64_t microseconds);
+
+    /// \brief Round a time to the nearest start of a year.
+    /// \sa Calendar::roundYear()
+    static int64_t roundYear(int64_t microseconds);
+
+    /// \brief Add calendar months to a time.
+    /// \sa Calendar::addMonths()
+    static int64_t addMonths(int64_t microseconds, int64_t months);
+
+    /// \brief Add calendar years to a time.
+    /// \sa Calendar::addYears()
+    static int64_t addYears(int64_t microseconds, int64_t years);
+
+    /// \brief Get the civil date of a time.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the year, month and day of the time.
+    static Calendar::Date date(int64_t microseconds);
+
+    /// \returns the size of the table in bytes.
+    static std::size_t memorySize();
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <stdint.h>
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A source of the current UTC time.
+///
+/// Poco::Timestamp reads the most precise real time clock, which is
+/// accurate but is not the cheapest way to get the time.  A Clock reads
+/// one of several sources, trading resolution or accuracy for speed.
+///
+/// \code{.cpp}
+/// ofxTime::Clock clock(ofxTime::Clock::REALTIME_COARSE);
+///
+/// Poco::Timestamp now = clock.now();
+/// \endcode
+class Clock
+{
+public:
+    /// \brief The sources of the time.
+    enum Source
+    {
+        /// \brief The precise real time clock, as used by Poco::Timestamp.
+        REALTIME,
+        /// \brief The real time clock at the resolution of the scheduler
+        ///        tick, typically 1 to 10 ms.  This is CLOCK_REALTIME_COARSE
+        ///        on Linux and GetSystemTimeAsFileTime() on Windows.  It is
+        ///        REALTIME where there is no coarse clock.
+        REALTIME_COARSE,
+        /// \brief The CPU time stamp counter, calibrated against REALTIME
+        ///        over 10 ms the first time it is used.  The first fit is
+        ///        within about 10 parts per million, so it can drift from
+        ///        REALTIME by up to about 40 ms per hour unless calibrate()
+        ///        is called.  It is REALTIME where there is no invariant
+        ///        time stamp counter.
+        TSC
+    };
+
+    /// \brief Create a Clock.
+    /// \param source The source of the time.
+    Clock(Source source = REALTIME);
+
+    /// \returns the source of the time.
+    Source getSource() const;
+
+    /// \returns the current time in microseconds since the epoch.
+    int64_t getMicroseconds() const;
+
+    /// \returns the current time.
+    Poco::Timestamp now() const;
+
+    /// \brief Read a source of the time.
+    /// \param source The source.
+    /// \returns the current time in microseconds since the epoch.
+    static int64_t getMicroseconds(Source source);
+
+    /// \brief Fit the TSC source to REALTIME again.
+    ///
+    /// The rate is measured from the first fit, so it becomes more precise
+    /// over time, and the TSC source is set to REALTIME, so it follows
+    /// adjustments of the real time clock.  Calls within one second of the
+    /// last fit return at once, so it may be called every frame.
+    /// CachedClock::update() calls it for TSC clocks.
+    static void calibrate();
+
+    /// \returns true iff the source is read directly, rather than falling
+    ///          back to REALTIME.
+    static bool isAvailable(Source source);
+
+private:
+    /// \brief The source of the time.
+    Source _source = REALTIME;
+
+};
+
+
+} } // namespace ofx::Time
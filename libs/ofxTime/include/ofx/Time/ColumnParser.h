@@ -0,0 +1,161 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ofx/Time/CompiledParser.h"
+#include "ofx/Time/DefaultInitAllocator.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Parse a column of timestamps from a large text file in parallel.
+///
+/// ColumnParser reads line-oriented text such as logs and CSV files, in
+/// which each line holds one timestamp in a fixed column.  Files are memory
+/// mapped rather than read, and the text is split at line boundaries into
+/// one chunk per thread.  Each thread first counts the lines in its chunk,
+/// so that every chunk knows where its lines start in the output, and then
+/// parses its lines directly into the output array.
+///
+/// Lines are separated by `\n`, and a `\r` before the `\n` is ignored.  The
+/// column is the text between the `column`th and the next delimiter, or the
+/// end of the line.  Quoted fields are not supported.
+///
+/// There is exactly one output timestamp per line after the header lines,
+/// so the results line up with the other columns of the file.  Lines that
+/// fail to parse, including blank lines, produce a timestamp of 0 and are
+/// counted in the Report of their chunk.
+///
+/// \code{.cpp}
+/// ofxTime::ColumnParser::Settings settings;
+/// settings.column = 2;
+/// settings.headerLines = 1;
+///
+/// ofxTime::ColumnParser parser(ofxTime::CompiledParser(Poco::DateTimeFormat::ISO8601_FORMAT), settings);
+///
+/// ofxTime::ColumnParser::Timestamps timestamps;
+/// std::vector<ofxTime::ColumnParser::Report> reports;
+///
+/// if (parser.parseFile("events.csv", timestamps, reports))
+/// {
+///     // ...
+/// }
+/// \endcode
+class ColumnParser
+{
+public:
+    /// \brief The output timestamps.
+    ///
+    /// Every element is written by the parsing threads, so the vector is
+    /// resized without first filling it with zeros on the calling thread.
+    typedef std::vector<int64_t, DefaultInitAllocator<int64_t>> Timestamps;
+
+    /// \brief The layout of the input and the amount of parallelism.
+    struct Settings
+    {
+        /// \brief The zero-based index of the timestamp column.
+        std::size_t column = 0;
+
+        /// \brief The column delimiter.
+        char delimiter = ',';
+
+        /// \brief The number of lines to skip at the start of the input.
+        std::size_t headerLines = 0;
+
+        /// \brief The number of threads, or 0 for one per hardware thread.
+        std::size_t threads = 0;
+
+        /// \brief The minimum number of bytes in each chunk.
+        ///
+        /// Small inputs use fewer threads.
+        std::size_t minChunkSize = 1 << 20;
+    };
+
+    /// \brief The results of parsing one chunk of the input.
+    struct Report
+    {
+        /// \brief The offset of the chunk in the input, in bytes.
+        std::size_t offset = 0;
+
+        /// \brief The size of the chunk, in bytes.
+        std::size_t size = 0;
+
+        /// \brief The index of the first line of the chunk in the output.
+        std::size_t firstLine = 0;
+
+        /// \brief The number of lines in the chunk.
+        std::size_t lines = 0;
+
+        /// \brief The number of lines that failed to parse.
+        std::size_t failures = 0;
+
+        /// \brief The output index of the first line that failed to parse.
+        std::size_t firstFailure = 0;
+
+        /// \brief The Error of the first line that failed to parse.
+        CompiledParser::Error firstError = CompiledParser::SUCCESS;
+    };
+
+    /// \brief Create a ColumnParser with the default Settings.
+    /// \param parser The parser for the timestamp column.
+    explicit ColumnParser(const CompiledParser& parser);
+
+    /// \brief Create a ColumnParser.
+    /// \param parser The parser for the timestamp column.
+    /// \param settings The layout of the input.
+    ColumnParser(const CompiledParser& parser, const Settings& settings);
+
+    /// \returns the parser for the timestamp column.
+    const CompiledParser& getParser() const;
+
+    /// \returns the settings.
+    const Settings& getSettings() const;
+
+    /// \brief Parse the timestamp column of a buffer.
+    /// \param buffer The input.
+    /// \param size The number of characters in the input.
+    /// \param timestamps The output UTC times in microseconds since the
+    ///        epoch, resized to one per line.
+    /// \param reports The output reports, one per chunk, in input order.
+    /// \returns the number of lines that failed to parse.
+    std::size_t parse(const char* buffer,
+                      std::size_t size,
+                      Timestamps& timestamps,
+                      std::vector<Report>& reports) const;
+
+    /// \brief Memory map a file and parse its timestamp column.
+    /// \param path The path of the file.
+    /// \param timestamps The output UTC times in microseconds since the
+    ///        epoch, resized to one per line.
+    /// \param reports The output reports, one per chunk, in input order.
+    /// \returns false if the file could not be mapped.
+    bool parseFile(const std::string& path,
+                   Timestamps& timestamps,
+                   std::vector<Report>& reports) const;
+
+private:
+    /// \brief Parse the lines of a chunk into the output.
+    void parseChunk(const char* buffer, int64_t* timestamps, Report& report) const;
+
+    /// \brief The parser for the timestamp column.
+    CompiledParser _parser;
+
+    /// \brief The layout of the input.
+    Settings _settings;
+
+};
+
+
+} } // namespace ofx::Time
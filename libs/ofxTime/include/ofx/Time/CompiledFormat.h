@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/DateTimeFormat.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A Poco::DateTimeFormatter format string that is parsed once.
+///
+/// Poco::DateTimeFormatter::format() parses its format string and builds a
+/// new std::string on every call.  A CompiledFormat parses the format string
+/// into a sequence of Tokens when it is constructed and then writes each
+/// formatted time directly into a caller supplied buffer, without parsing,
+/// allocating, logging or throwing.
+///
+/// The output is byte-identical to Poco::DateTimeFormatter::format() for
+/// every specifier it supports, for all times that a Poco::DateTime can
+/// represent:
+///
+///     %w %W %b %B %d %e %f %m %n %o %y %Y %H %h %a %A
+///     %M %S %s %i %c %F %z %Z
+///
+/// Any other character following a `%` is written literally, so `%%` is
+/// written as `%`.  A `%` at the end of the format string is ignored.
+///
+/// \code{.cpp}
+/// ofxTime::CompiledFormat format(Poco::DateTimeFormat::ISO8601_FRAC_FORMAT);
+///
+/// char buffer[64];
+/// std::size_t size = format.format(now.epochMicroseconds(), buffer);
+/// stream.write(buffer, size);
+/// \endcode
+class CompiledFormat
+{
+public:
+    /// \brief A single element of a parsed format string.
+    struct Token
+    {
+        /// \brief The token types.
+        ///
+        /// Each specifier type is named after the Poco::DateTimeFormatter
+        /// specifier it implements.
+        enum Type
+        {
+            /// \brief A run of literal characters.
+            LITERAL,
+            /// \brief `%w` Abbreviated weekday (Mon, Tue, ...).
+            WEEKDAY_ABBREVIATED,
+            /// \brief `%W` Full weekday (Monday, Tuesday, ...).
+            WEEKDAY_FULL,
+            /// \brief `%b` Abbreviated month (Jan, Feb, ...).
+            MONTH_ABBREVIATED,
+            /// \brief `%B` Full month (January, February, ...).
+            MONTH_FULL,
+            /// \brief `%d` Zero-padded day of month (01 .. 31).
+            DAY_ZERO_PADDED,
+            /// \brief `%e` Day of month (1 .. 31).
+            DAY,
+            /// \brief `%f` Space-padded day of month ( 1 .. 31).
+            DAY_SPACE_PADDED,
+            /// \brief `%m` Zero-padded month (01 .. 12).
+            MONTH_ZERO_PADDED,
+            /// \brief `%n` Month (1 .. 12).
+            MONTH,
+            /// \brief `%o` Space-padded month ( 1 .. 12).
+            MONTH_SPACE_PADDED,
+            /// \brief `%y` Year without century (70).
+            YEAR_SHORT,
+            /// \brief `%Y` Year with century (1970).
+            YEAR,
+            /// \brief `%H` Hour (00 .. 23).
+            HOUR,
+            /// \brief `%h` Hour (00 .. 12).
+            HOUR_AMPM,
+            /// \brief `%a` am/pm.
+            AMPM_LOWER,
+            /// \brief `%A` AM/PM.
+            AMPM_UPPER,
+            /// \brief `%M` Minute (00 .. 59).
+            MINUTE,
+            /// \brief `%S` Second (00 .. 59).
+            SECOND,
+            /// \brief `%s` Seconds and microseconds (00.000000 .. 59.999999).
+            SECOND_FRACTION,
+            /// \brief `%i` Millisecond (000 .. 999).
+            MILLISECOND,
+            /// \brief `%c` Tenth of a second (0 .. 9).
+            DECISECOND,
+            /// \brief `%F` Fractional seconds in microseconds (000000 .. 999999).
+            MICROSECOND,
+            /// \brief `%z` ISO 8601 time zone differential (Z, +02:00).
+            TIME_ZONE_ISO,
+            /// \brief `%Z` RFC time zone differential (GMT, +0200).
+            TIME_ZONE_RFC
+        };
+
+        /// \brief The type of this token.
+        Type type;
+
+        /// \brief For a LITERAL, the offset of its text in getLiterals().
+        uint32_t offset;
+
+        /// \brief For a LITERAL, the length of its text.
+        uint32_t length;
+    };
+
+    /// \brief Create a CompiledFormat.
+    /// \param fmt The Poco::DateTimeFormatter format string.
+    explicit CompiledFormat(const std::string& fmt = Poco::DateTimeFormat::RFC1123_FORMAT);
+
+    /// \returns the original format string.
+    const std::string& getFormat() const;
+
+    /// \returns the parsed tokens, in order.
+    const std::vector<Token>& getTokens() const;
+
+    /// \returns the text of all LITERAL tokens.
+    const std::string& getLiterals() const;
+
+    /// \returns the maximum number of characters written for any time.
+    std::size_t getMaxSize() const;
+
+    /// \returns true iff any token depends on the date.
+    bool usesDate() const;
+
+    /// \returns true iff any token depends on the time of day.
+    bool usesTime() const;
+
+    /// \brief Format a time.
+    ///
+    /// No null terminator is written.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \param buffer The output buffer, at least getMaxSize() characters.
+    /// \param timeZoneDifferential The time zone differential in seconds,
+    ///        as passed to Poco::DateTimeFormatter::format().
+    /// \returns the number of characters written.
+    std::size_t format(int64_t microseconds,
+                       char* buffer,
+                       int timeZoneDifferential = Poco::DateTimeFormatter::UTC) const;
+
+    /// \brief Format a time into a bounded range.
+    ///
+    /// No null terminator is written.
+    ///
+    /// \param timestamp The time to format.
+    /// \param first The start of the output range.
+    /// \param last The end of the output range.
+    /// \param timeZoneDifferential The time zone differential in seconds.
+    /// \returns a pointer past the last character written, or nullptr if
+    ///          the result does not fit in the range.
+    char* format(const Poco::Timestamp& timestamp,
+                 char* first,
+                 char* last,
+                 int timeZoneDifferential = Poco::DateTimeFormatter::UTC) const;
+
+    /// \brief Format a time as a std::string.
+    ///
+    /// This is a convenience and allocates the returned string.
+    ///
+    /// \param timestamp The time to format.
+    /// \param timeZoneDifferential The time zone differential in seconds.
+    /// \returns the formatted time.
+    std::string format(const Poco::Timestamp& timestamp,
+                       int timeZoneDifferential = Poco::DateTimeFormatter::UTC) const;
+
+    /// \brief Format a column of times into one contiguous buffer.
+    ///
+    /// Each formatted time is followed by the separator.  Consecutive times
+    /// that fall on the same day share one date computation, so sorted
+    /// columns such as log timestamps are formatted fastest.
+    ///
+    /// \param timestamps The times in microseconds since the epoch.
+    /// \param size The number of times.
+    /// \param buffer The output buffer, at least
+    ///        `size * (getMaxSize() + 1)` characters.
+    /// \param separator The character written after each time.
+    /// \param timeZoneDifferential The time zone differential in seconds.
+    /// \returns the number of characters written.
+    std::size_t format(const int64_t* timestamps,
+                       std::size_t size,
+                       char* buffer,
+                       char separator = '\n',
+                       int timeZoneDifferential = Poco::DateTimeFormatter::UTC) const;
+
+private:
+    friend class IncrementalFormat;
+
+    /// \brief The fields of a time used by the tokens.
+    struct Fields
+    {
+        int64_t year = 0;
+        int month = 1;
+        int day = 1;
+        int dayOfWeek = 0;
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+        int millisecond = 0;
+        int microsecond = 0;
+    };
+
+    /// \brief Compute the fields used by the tokens.
+    void setFields(Fields& fields, int64_t microseconds) const;
+
+    /// \brief Compute the date fields of a day since the epoch.
+    static void setDate(Fields& fields, int64_t days);
+
+    /// \brief Compute the time fields from microseconds since midnight.
+    static void setTime(Fields& fields, int64_t timeOfDay);
+
+    /// \brief Write every token.
+    char* write(const Fields& fields, char* out, int timeZoneDifferential) const;
+
+    /// \brief Write a single token.
+    char* write(const Token& token,
+                const Fields& fields,
+                char* out,
+                int timeZoneDifferential) const;
+
+    /// \returns the maximum number of characters written for a token.
+    static std::size_t getMaxSize(const Token& token);
+
+    /// \brief The original format string.
+    std::string _format;
+
+    /// \brief The parsed tokens.
+    std::vector<Token> _tokens;
+
+    /// \brief The text of the LITERAL tokens.
+    std::string _literals;
+
+    /// \brief The maximum number of characters written.
+    std::size_t _maxSize = 0;
+
+    /// \brief True iff any token depends on the date.
+    bool _usesDate = false;
+
+    /// \brief True iff any token depends on the time of day.
+    bool _usesTime = false;
+
+};
+
+
+} } // namespace ofx::Time
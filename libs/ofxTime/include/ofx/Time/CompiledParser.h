@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/DateTimeFormat.h"
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A Poco::DateTimeParser format string that is parsed once.
+///
+/// Poco::DateTimeParser::parse() interprets its format string on every call,
+/// builds temporary strings for names and reports errors by throwing a
+/// Poco::SyntaxException.  A CompiledParser interprets the format string
+/// once and then parses directly from a character range, reporting errors
+/// with an Error code.  It never allocates, logs or throws.
+///
+/// Parsing follows the rules of Poco::DateTimeParser::parse(): literal
+/// characters in the format string are ignored, numeric fields skip any
+/// non-digit characters before them and read at most their width in
+/// digits, and the time zone differential is parsed from `%z` or `%Z`.
+/// The supported specifiers are:
+///
+///     %w %W %b %B %d %e %f %m %n %o %y %Y %r %H %h %a %A
+///     %M %S %s %i %c %F %z %Z
+///
+/// Unlike Poco::DateTimeParser::parse(), the result is the UTC time, so
+/// there is no need to call Poco::DateTime::makeUTC().
+///
+/// Runs of digits are converted eight characters at a time using SWAR
+/// (SIMD within a register) arithmetic.
+///
+/// \code{.cpp}
+/// ofxTime::CompiledParser parser("%w %b %f %H:%M:%S %Z %Y");
+///
+/// Poco::Timestamp timestamp;
+/// int tzd = 0;
+///
+/// if (parser.parse(text, timestamp, tzd) == ofxTime::CompiledParser::SUCCESS)
+/// {
+///     // ...
+/// }
+/// \endcode
+class CompiledParser
+{
+public:
+    /// \brief The result of parsing.
+    enum Error
+    {
+        /// \brief The time was parsed.
+        SUCCESS = 0,
+        /// \brief The format string or the input was empty.
+        EMPTY,
+        /// \brief A month name was too short or was not recognized.
+        INVALID_MONTH,
+        /// \brief An AM/PM designator was not recognized.
+        INVALID_AMPM,
+        /// \brief A date or time component was out of range.
+        OUT_OF_RANGE
+    };
+
+    /// \brief Create a CompiledParser.
+    /// \param fmt The Poco::DateTimeParser format string.
+    explicit CompiledParser(const std::string& fmt = Poco::DateTimeFormat::ISO8601_FRAC_FORMAT);
+
+    /// \returns the original format string.
+    const std::string& getFormat() const;
+
+    /// \brief Parse a time.
+    /// \param first The start of the input.
+    /// \param last The end of the input.
+    /// \param microseconds The UTC time in microseconds since the epoch.
+    ///        It is unchanged unless SUCCESS is returned.
+    /// \param timeZoneDifferential The parsed time zone differential in
+    ///        seconds, or 0 if none was parsed.
+    /// \returns SUCCESS or the reason for failure.
+    Error parse(const char* first,
+                const char* last,
+                int64_t& microseconds,
+                int& timeZoneDifferential) const;
+
+    /// \brief Parse a time.
+    /// \param text The input.
+    /// \param timestamp The UTC time.  It is unchanged unless SUCCESS is
+    ///        returned.
+    /// \param timeZoneDifferential The parsed time zone differential in
+    ///        seconds, or 0 if none was parsed.
+    /// \returns SUCCESS or the reason for failure.
+    Error parse(const std::string& text,
+                Poco::Timestamp& timestamp,
+                int& timeZoneDifferential) const;
+
+    /// \brief Parse one time per line from a buffer.
+    ///
+    /// Lines are separated by `\n`, and a `\r` before the `\n` is ignored.
+    /// The final line does not need a trailing newline.  Lines that fail to
+    /// parse produce a timestamp of 0 and their Error.
+    ///
+    /// \param buffer The input.
+    /// \param size The number of characters in the input.
+    /// \param timestamps The output UTC times in microseconds since the
+    ///        epoch, at least countLines(buffer, size) elements.
+    /// \param errors The output errors, one per line, or nullptr.
+    /// \param timeZoneDifferentials The output time zone differentials, one
+    ///        per line, or nullptr.
+    /// \returns the number of lines that were parsed successfully.
+    std::size_t parse(const char* buffer,
+                      std::size_t size,
+                      int64_t* timestamps,
+                      Error* errors = nullptr,
+                      int* timeZoneDifferentials = nullptr) const;
+
+    /// \brief Count the lines in a buffer as parse() does.
+    /// \param buffer The input.
+    /// \param size The number of characters in the input.
+    /// \returns the number of lines.
+    static std::size_t countLines(const char* buffer, std::size_t size);
+
+    /// \returns a description of an Error.
+    static const char* toString(Error error);
+
+private:
+    /// \brief The parsing steps, one per specifier.
+    enum Step
+    {
+        SKIP_WEEKDAY,
+        MONTH_NAME,
+        DAY,
+        MONTH,
+        YEAR_SHORT,
+        YEAR,
+        YEAR_ANY,
+        HOUR,
+        AMPM,
+        MINUTE,
+        SECOND,
+        SECOND_FRACTION,
+        MILLISECOND,
+        DECISECOND,
+        FRACTION,
+        TIME_ZONE
+    };
+
+    /// \brief The original format string.
+    std::string _format;
+
+    /// \brief The steps.
+    std::vector<Step> _steps;
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+// The coroutine support is only available when the compiler supports C++20
+// coroutines, e.g. with -std=c++20 or /std:c++20.
+#if defined(__has_include)
+    #if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+        #define OFX_TIME_HAVE_COROUTINES 1
+    #endif
+#endif
+
+
+#if defined(OFX_TIME_HAVE_COROUTINES)
+
+
+#include <coroutine>
+#include <limits>
+#include <stdint.h>
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/EventLoop.h"
+#include "ofx/Time/Interval.h"
+#include "ofx/Time/Period.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief The return type of a coroutine that runs on its own.
+///
+/// A coroutine returning Coroutine starts as soon as it is called and is
+/// destroyed when it finishes.  Nothing waits for it, so it must not
+/// refer to objects that may be destroyed while it is suspended.
+///
+/// \code{.cpp}
+/// ofxTime::Coroutine blink()
+/// {
+///     ofxTime::Ticker ticker = ofxTime::every(ofxTime::Period::Seconds(1));
+///
+///     for (;;)
+///     {
+///         Poco::Timestamp time = co_await ticker.next();
+///         // ...
+///     }
+/// }
+/// \endcode
+class Coroutine
+{
+public:
+    /// \brief The promise type required by the compiler.
+    struct promise_type
+    {
+        Coroutine get_return_object() noexcept
+        {
+            return Coroutine();
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return std::suspend_never();
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return std::suspend_never();
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        /// \brief Log an exception that escaped the coroutine.
+        void unhandled_exception() noexcept;
+    };
+
+};
+
+
+/// \brief An awaitable that resumes a coroutine on an EventLoop at a time.
+///
+/// The result of `co_await` is the time.  If the time has already passed,
+/// the coroutine continues without suspending.
+class SleepAwaitable
+{
+public:
+    /// \brief Create a SleepAwaitable that never resumes.
+    ///
+    /// No timer is scheduled, so the suspended coroutine does not keep an
+    /// EventLoop running.
+    SleepAwaitable():
+        _time(std::numeric_limits<Poco::Timestamp::TimeVal>::max())
+    {
+    }
+
+    /// \brief Create a SleepAwaitable.
+    /// \param time The time at which to resume.
+    /// \param loop The loop on which to resume.
+    SleepAwaitable(const Poco::Timestamp& time, EventLoop& loop):
+        _time(time),
+        _loop(&loop)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return _time <= Poco::Timestamp();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        if (!_loop)
+        {
+            return;
+        }
+
+        _loop->schedule(_time, [handle]() {
+            handle.resume();
+        });
+    }
+
+    Poco::Timestamp await_resume() const noexcept
+    {
+        return _time;
+    }
+
+private:
+    /// \brief The time at which to resume.
+    Poco::Timestamp _time;
+
+    /// \brief The loop on which to resume, or nullptr to never resume.
+    EventLoop* _loop = nullptr;
+
+};
+
+
+/// \brief An awaitable that resumes a coroutine at the start of an
+///        Interval.
+///
+/// The result of `co_await` is true iff the coroutine resumed within the
+/// Interval, and false if the Interval had already ended.
+class IntervalAwaitable
+{
+public:
+    /// \brief Create an IntervalAwaitable.
+    /// \param interval The interval.
+    /// \param loop The loop on which to resume.
+    IntervalAwaitable(const Interval& interval, EventLoop& loop):
+        _interval(interval),
+        _sleep(interval.getStart(), loop)
+    {
+    }
+
+    bool await_ready() const
+    {
+        return _sleep.await_ready();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        _sleep.await_suspend(handle);
+    }
+
+    bool await_resume() const
+    {
+        return Poco::Timestamp() <= _interval.getEnd();
+    }
+
+private:
+    /// \brief The interval.
+    Interval _interval;
+
+    /// \brief Waits for the start of the interval.
+    SleepAwaitable _sleep;
+
+};
+
+
+/// \brief A sequence of times separated by a Period, for use in a loop.
+///
+/// The nth time is the first time plus n times the Period using
+/// Utils::add(), so calendar fields such as MONTH are supported.  Times
+/// that have already passed when next() is called are skipped.
+class Ticker
+{
+public:
+    /// \brief Create a Ticker.
+    ///
+    /// If the period does not advance the time, an error is logged and
+    /// next() never resumes.
+    ///
+    /// \param period The time between ticks.
+    /// \param first The time of the first tick.
+    /// \param loop The loop on which to resume.
+    Ticker(const Period& period, const Poco::Timestamp& first, EventLoop& loop);
+
+    /// \returns an awaitable that resumes at the next tick.
+    SleepAwaitable next();
+
+private:
+    /// \brief The time between ticks.
+    Period _period;
+
+    /// \brief The time of the first tick.
+    Poco::Timestamp _first;
+
+    /// \brief The number of the next tick.
+    int64_t _count = 0;
+
+    /// \brief True iff the period advances the time.
+    bool _isValidPeriod = false;
+
+    /// \brief The loop on which to resume.
+    EventLoop* _loop = nullptr;
+
+};
+
+
+/// \brief Suspend a coroutine until a time.
+/// \param time The time.
+/// \param loop The loop on which to resume.
+/// \returns an awaitable whose result is the time.
+inline SleepAwaitable sleepUntil(const Poco::Timestamp& time,
+                                 EventLoop& loop = EventLoop::getCurrent())
+{
+    return SleepAwaitable(time, loop);
+}
+
+
+/// \brief Suspend a coroutine for a timespan.
+/// \param timespan The timespan.
+/// \param loop The loop on which to resume.
+/// \returns an awaitable whose result is the time at which it resumes.
+inline SleepAwaitable sleepFor(const Poco::Timespan& timespan,
+                               EventLoop& loop = EventLoop::getCurrent())
+{
+    return SleepAwaitable(Poco::Timestamp() + timespan.totalMicroseconds(), loop);
+}
+
+
+/// \brief Suspend a coroutine until the start of an Interval.
+/// \param interval The interval.
+/// \param loop The loop on which to resume.
+/// \returns an awaitable whose result is false if the interval has ended.
+inline IntervalAwaitable at(const Interval& interval,
+                            EventLoop& loop = EventLoop::getCurrent())
+{
+    return IntervalAwaitable(interval, loop);
+}
+
+
+/// \brief Create a Ticker whose first tick is one period from now.
+/// \param period The time between ticks.
+/// \param loop The loop on which to resume.
+/// \returns the Ticker.
+Ticker every(const Period& period, EventLoop& loop = EventLoop::getCurrent());
+
+
+} } // namespace ofx::Time
+
+
+#endif
@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/LocalDateTime.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/TimeZone.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A schedule defined by a cron expression.
+///
+/// A CronSchedule parses a standard five field cron expression
+/// (`minute hour day-of-month month day-of-week`), or a six field
+/// expression with a leading seconds field, into one bitset per field.
+/// Each field accepts `*`, values, ranges (`1-5`), steps (`*/15`, `0-30/5`,
+/// `10/20`) and comma separated lists.  Months and days of the week may be
+/// given by their three letter English names, and both 0 and 7 mean Sunday.
+/// `?` is the same as `*` in the day fields.  The macros `@yearly`,
+/// `@annually`, `@monthly`, `@weekly`, `@daily`, `@midnight` and `@hourly`
+/// are also accepted.
+///
+/// As in Vixie cron, if both day fields are restricted (neither starts
+/// with `*`), a day matches if either field matches.  Otherwise a day must
+/// match both.
+///
+/// next() does not test each minute in turn.  It finds the next matching
+/// month, day, hour, minute and second in that order, jumping directly to
+/// the next set bit of each field, so the cost does not depend on how far
+/// away the next fire time is.
+///
+/// \code{.cpp}
+/// // Every weekday at 09:30.
+/// ofxTime::CronSchedule schedule("30 9 * * MON-FRI");
+///
+/// Poco::Timestamp fire;
+///
+/// if (schedule.next(Poco::Timestamp(), *ofxTime::TimeZone::local(), fire))
+/// {
+///     // ...
+/// }
+/// \endcode
+///
+/// For more information, please see:
+///   - https://pubs.opengroup.org/onlinepubs/9699919799/utilities/crontab.html
+///   - `man 5 crontab`
+class CronSchedule
+{
+public:
+    /// \brief Create an invalid CronSchedule that never fires.
+    CronSchedule();
+
+    /// \brief Create a CronSchedule.
+    ///
+    /// If the expression is invalid, an error is logged and isValid() is
+    /// false.
+    ///
+    /// \param expression The cron expression.
+    CronSchedule(const std::string& expression);
+
+    /// \returns true iff the expression was parsed successfully.
+    bool isValid() const;
+
+    /// \returns the cron expression.
+    const std::string& getExpression() const;
+
+    /// \returns true iff the schedule fires at the given time.
+    /// \param time The time, in the schedule's clock.
+    bool matches(const Poco::Timestamp& time) const;
+
+    /// \brief Find the next fire time after a time.
+    ///
+    /// The expression is evaluated on the clock of the given time, which is
+    /// usually UTC.
+    ///
+    /// \param after The time, in microseconds since the epoch.
+    /// \param fire The first fire time strictly after the time.
+    /// \returns false if the schedule never fires.
+    bool next(int64_t after, int64_t& fire) const;
+
+    /// \brief Find the next fire time after a time.
+    ///
+    /// The expression is evaluated on the clock of the given time, which is
+    /// usually UTC.
+    ///
+    /// \param after The time.
+    /// \param fire The first fire time strictly after the time.
+    /// \returns false if the schedule never fires.
+    bool next(const Poco::Timestamp& after, Poco::Timestamp& fire) const;
+
+    /// \brief Find the next fire time after a time in a time zone.
+    ///
+    /// The expression is evaluated on the local time of the zone.  Fire
+    /// times that are skipped when the clocks are set forward fire once at
+    /// the transition.  Fire times that are repeated when the clocks are
+    /// set back fire only the first time if the second, minute and hour
+    /// fields do not start with `*`, as for fixed-time jobs in Vixie cron.
+    /// Other schedules, e.g. `*/5 * * * *`, fire in both passes of the
+    /// repeated hour, so they keep firing on elapsed time.
+    ///
+    /// \param after The UTC time.
+    /// \param zone The time zone.
+    /// \param fire The first UTC fire time strictly after the time.
+    /// \returns false if the schedule never fires.
+    bool next(const Poco::Timestamp& after,
+              const TimeZone& zone,
+              Poco::Timestamp& fire) const;
+
+    /// \brief Find the next fire time after a time in the process time zone.
+    ///
+    /// This is the same as next(after.utc().timestamp(), *TimeZone::local(),
+    /// fire).
+    ///
+    /// \param after The local time.
+    /// \param fire The first local fire time strictly after the time.
+    /// \returns false if the schedule never fires.
+    bool next(const Poco::LocalDateTime& after, Poco::LocalDateTime& fire) const;
+
+    /// \brief Get the fire times in a time range.
+    /// \param start The start of the range, inclusive.
+    /// \param end The end of the range, exclusive.
+    /// \returns the fire times, in order.
+    std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                              const Poco::Timestamp& end) const;
+
+    /// \brief Find the next fire time of many schedules after the same time.
+    ///
+    /// The time is split into its calendar fields once for all schedules.
+    ///
+    /// \param schedules The schedules.
+    /// \param size The number of schedules.
+    /// \param after The time, in microseconds since the epoch.
+    /// \param fires The first fire time of each schedule strictly after the
+    ///        time, or std::numeric_limits<int64_t>::max() if it never
+    ///        fires.
+    static void next(const CronSchedule* schedules,
+                     std::size_t size,
+                     int64_t after,
+                     int64_t* fires);
+
+private:
+    /// \brief Parse a cron expression.
+    /// \returns false and sets error if the expression is invalid.
+    bool parse(const std::string& expression, std::string& error);
+
+    /// \brief Find the first fire time at or after a local date and time.
+    /// \param year The year.
+    /// \param month The month [1, 12].
+    /// \param day The day of the month [1, 31].
+    /// \param secondOfDay The second of the day [0, 86399].
+    /// \param fire The fire time in microseconds.
+    /// \returns false if there is no fire time.
+    bool find(int64_t year,
+              int month,
+              int day,
+              int secondOfDay,
+              int64_t& fire) const;
+
+    /// \returns the first matching day of the month at or after the given
+    ///          day, or 0 if there is none.
+    int getNextDay(int64_t year, int month, int day) const;
+
+    /// \brief The cron expression.
+    std::string _expression;
+
+    /// \brief True iff the expression is valid.
+    bool _valid = false;
+
+    /// \brief True iff the schedule has at least one fire time.
+    bool _hasFires = false;
+
+    /// \brief Bit n is set for each matching second.
+    uint64_t _seconds = 0;
+
+    /// \brief Bit n is set for each matching minute.
+    uint64_t _minutes = 0;
+
+    /// \brief Bit n is set for each matching hour.
+    uint64_t _hours = 0;
+
+    /// \brief Bit n is set for each matching day of the month.
+    uint64_t _daysOfMonth = 0;
+
+    /// \brief Bit n is set for each matching month.
+    uint64_t _months = 0;
+
+    /// \brief Bit n is set for each matching day of the week, where 0 is
+    ///        Sunday.
+    uint64_t _daysOfWeek = 0;
+
+    /// \brief True iff the day of the month field starts with `*` or `?`.
+    bool _isAnyDayOfMonth = false;
+
+    /// \brief True iff the day of the week field starts with `*` or `?`.
+    bool _isAnyDayOfWeek = false;
+
+    /// \brief True iff none of the second, minute and hour fields starts
+    ///        with `*`.
+    bool _isFixedTime = false;
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief An allocator that default-initializes rather than
+///        value-initializes.
+///
+/// std::vector::resize() value-initializes the new elements, which fills
+/// arithmetic types with zeros.  With a DefaultInitAllocator the new
+/// elements of such types are left uninitialized, which saves a pass over
+/// buffers that are about to be overwritten.
+///
+/// \tparam T The value type.
+/// \tparam Allocator The allocator that provides the memory.
+template <typename T, typename Allocator = std::allocator<T>>
+class DefaultInitAllocator: public Allocator
+{
+public:
+    /// \brief The traits of the underlying allocator.
+    typedef std::allocator_traits<Allocator> Traits;
+
+    /// \brief The same allocator for another value type.
+    template <typename U>
+    struct rebind
+    {
+        typedef DefaultInitAllocator<U, typename Traits::template rebind_alloc<U>> other;
+    };
+
+    using Allocator::Allocator;
+
+    /// \brief Default-initialize a value.
+    /// \param pointer The memory of the value.
+    template <typename U>
+    void construct(U* pointer) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    /// \brief Construct a value from arguments.
+    /// \param pointer The memory of the value.
+    /// \param args The constructor arguments.
+    template <typename U, typename... Args>
+    void construct(U* pointer, Args&&... args)
+    {
+        Traits::construct(static_cast<Allocator&>(*this), pointer, std::forward<Args>(args)...);
+    }
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/TimingWheel.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A single-threaded loop that runs tasks and timers.
+///
+/// Tasks and timers may be added from any thread, but they all run on the
+/// thread that calls run() or poll().  Timers are kept in a TimingWheel,
+/// and run() sleeps until the next timer or task is due, so any number of
+/// waiting timers costs no threads and no polling.
+///
+/// The coroutine awaitables in Coroutine.h resume on an EventLoop.
+///
+/// \code{.cpp}
+/// ofxTime::EventLoop loop;
+///
+/// loop.schedule(Poco::Timestamp() + Poco::Timespan::SECONDS, []() {
+///     // ...
+///     ofxTime::EventLoop::getCurrent().stop();
+/// });
+///
+/// loop.run();
+/// \endcode
+///
+/// In an openFrameworks app, poll() may be called from ofApp::update()
+/// instead of calling run() on another thread.
+class EventLoop
+{
+public:
+    /// \brief A unit of work.
+    typedef std::function<void()> Task;
+
+    /// \brief Create an EventLoop.
+    /// \param resolution The resolution of the timers.
+    EventLoop(const Poco::Timespan& resolution = Poco::Timespan(0, 0, 0, 0, 1000));
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator = (const EventLoop&) = delete;
+
+    /// \brief Run a task on the loop at a time.
+    /// \param deadline The time.  Times in the past run on the next pass.
+    /// \param task The task.
+    /// \returns a timer that can be passed to cancel().
+    TimingWheel::Timer schedule(const Poco::Timestamp& deadline, Task task);
+
+    /// \brief Cancel a task added with schedule().
+    /// \param timer The timer.
+    /// \returns true iff the task had not run yet.
+    bool cancel(TimingWheel::Timer timer);
+
+    /// \brief Run a task on the loop as soon as possible.
+    /// \param task The task.
+    void post(Task task);
+
+    /// \brief Run the tasks and timers that are due, without waiting.
+    /// \returns the number of tasks and timers run.
+    std::size_t poll();
+
+    /// \brief Run tasks and timers until stop() is called or there is
+    ///        nothing left to do.
+    void run();
+
+    /// \brief Make run() return after the current task.
+    void stop();
+
+    /// \returns true iff there are no tasks or timers waiting.
+    bool empty() const;
+
+    /// \returns the loop running on the calling thread, or getDefault() if
+    ///          there is none.
+    static EventLoop& getCurrent();
+
+    /// \returns a process-wide EventLoop.
+    static EventLoop& getDefault();
+
+private:
+    /// \brief The timers.
+    TimingWheel _wheel;
+
+    /// \brief Protects the members below.
+    mutable std::mutex _mutex;
+
+    /// \brief Signaled when a task is posted, a timer is scheduled or the
+    ///        loop is stopped.
+    std::condition_variable _condition;
+
+    /// \brief The posted tasks.
+    std::vector<Task> _tasks;
+
+    /// \brief True if a timer was scheduled since run() last went to sleep.
+    bool _isChanged = false;
+
+    /// \brief True if stop() was called.
+    bool _isStopping = false;
+
+};
+
+
+} } // namespace ofx::Time
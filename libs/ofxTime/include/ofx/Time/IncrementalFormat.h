@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/DateTimeFormat.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/CompiledFormat.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A CompiledFormat that reuses the previous result.
+///
+/// Log writers format times that usually differ from the previous time
+/// only in the seconds or the fraction of a second.  An IncrementalFormat
+/// keeps the text of the previous time.  If the next time falls on the
+/// same day, only the time of day tokens for the fields that changed are
+/// rewritten in place, since they always have the same width.  Otherwise
+/// the whole text is formatted again.
+///
+/// The output is identical to CompiledFormat for any sequence of times,
+/// but it is fastest when the times are sorted.  An IncrementalFormat is
+/// not thread safe.  getThreadLocal() returns one per thread and format.
+///
+/// \code{.cpp}
+/// ofxTime::IncrementalFormat format(Poco::DateTimeFormat::ISO8601_FRAC_FORMAT);
+///
+/// for (const Poco::Timestamp& time: times)
+/// {
+///     stream << format.format(time) << '\n';
+/// }
+/// \endcode
+class IncrementalFormat
+{
+public:
+    /// \brief Create an IncrementalFormat.
+    /// \param fmt The Poco::DateTimeFormatter format string.
+    /// \param timeZoneDifferential The time zone differential in seconds,
+    ///        as passed to Poco::DateTimeFormatter::format().
+    explicit IncrementalFormat(const std::string& fmt = Poco::DateTimeFormat::RFC1123_FORMAT,
+                               int timeZoneDifferential = Poco::DateTimeFormatter::UTC);
+
+    /// \brief Format a time.
+    ///
+    /// No null terminator is written.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \param buffer The output buffer, at least getMaxSize() characters.
+    /// \returns the number of characters written.
+    std::size_t format(int64_t microseconds, char* buffer);
+
+    /// \brief Format a time.
+    /// \param timestamp The time to format.
+    /// \returns the formatted time, which is valid until the next call.
+    const std::string& format(const Poco::Timestamp& timestamp);
+
+    /// \returns the compiled format.
+    const CompiledFormat& getCompiledFormat() const;
+
+    /// \returns the time zone differential in seconds.
+    int getTimeZoneDifferential() const;
+
+    /// \returns the maximum number of characters written for any time.
+    std::size_t getMaxSize() const;
+
+    /// \brief Get the IncrementalFormat of the calling thread for a format.
+    ///
+    /// The first call on each thread for each format and differential
+    /// creates the IncrementalFormat, which lives until the thread exits.
+    ///
+    /// \param fmt The Poco::DateTimeFormatter format string.
+    /// \param timeZoneDifferential The time zone differential in seconds.
+    /// \returns the IncrementalFormat.
+    static IncrementalFormat& getThreadLocal(const std::string& fmt = Poco::DateTimeFormat::RFC1123_FORMAT,
+                                             int timeZoneDifferential = Poco::DateTimeFormatter::UTC);
+
+private:
+    /// \brief The fields of the time of day, from the coarsest to the
+    ///        finest.
+    enum Level
+    {
+        /// \brief The hour, including am/pm.
+        LEVEL_HOUR,
+        /// \brief The minute.
+        LEVEL_MINUTE,
+        /// \brief The second.
+        LEVEL_SECOND,
+        /// \brief The fraction of a second.
+        LEVEL_FRACTION,
+        /// \brief Nothing changed.
+        LEVEL_NONE
+    };
+
+    /// \brief A time of day token and where its text starts.
+    struct Field
+    {
+        /// \brief The token.
+        CompiledFormat::Token token;
+
+        /// \brief The finest level that the token depends on.
+        Level level;
+
+        /// \brief The offset of the token's text in _text.
+        std::size_t offset;
+    };
+
+    /// \brief Bring _text up to date with a time.
+    void update(int64_t microseconds);
+
+    /// \brief The compiled format.
+    CompiledFormat _format;
+
+    /// \brief The time zone differential in seconds.
+    int _timeZoneDifferential = Poco::DateTimeFormatter::UTC;
+
+    /// \brief The time of day tokens of the previous text.
+    std::vector<Field> _fields;
+
+    /// \brief The fields of the previous time.
+    CompiledFormat::Fields _values;
+
+    /// \brief The day of the previous time, in days since the epoch.
+    int64_t _days = 0;
+
+    /// \brief True iff _text holds a formatted time.
+    bool _hasText = false;
+
+    /// \brief The text of the previous time.
+    std::string _text;
+
+};
+
+
+} } // namespace ofx::Time
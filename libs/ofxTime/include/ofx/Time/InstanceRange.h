@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <iterator>
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "ofx/Time/Interval.h"
+#include "ofx/Time/Period.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A lazily evaluated sequence of instances.
+///
+/// An InstanceRange generates the same instances as Utils::getInstances(),
+/// but computes each instance as it is visited rather than storing them in
+/// a std::vector.  Memory use is constant regardless of the number of
+/// instances, so it is well suited for iterating over long, high resolution
+/// sequences.
+///
+/// \code{.cpp}
+/// ofxTime::InstanceRange range(start, end, ofxTime::Period::Second());
+///
+/// for (const Poco::Timestamp& t: range)
+/// {
+///     // ...
+/// }
+/// \endcode
+///
+/// \note Iterators refer to the InstanceRange that created them and are
+/// invalidated when the InstanceRange is destroyed.
+class InstanceRange
+{
+public:
+    /// \brief A forward iterator over the instances of an InstanceRange.
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Poco::Timestamp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Poco::Timestamp* pointer;
+        typedef const Poco::Timestamp& reference;
+
+        /// \brief Create a past-the-end Iterator.
+        Iterator();
+
+        /// \returns the current instance.
+        reference operator * () const;
+
+        /// \returns a pointer to the current instance.
+        pointer operator -> () const;
+
+        /// \brief Advance to the next instance.
+        /// \returns this Iterator.
+        Iterator& operator ++ ();
+
+        /// \brief Advance to the next instance.
+        /// \returns a copy of this Iterator before it was advanced.
+        Iterator operator ++ (int);
+
+        /// \returns true iff both iterators are past-the-end or both point to
+        /// the same instance of the same InstanceRange.
+        bool operator == (const Iterator& other) const;
+
+        /// \returns true iff the iterators are not equal.
+        bool operator != (const Iterator& other) const;
+
+    private:
+        Iterator(const InstanceRange* range);
+
+        /// \returns true iff this Iterator is past-the-end.
+        bool done() const;
+
+        /// \brief The range being iterated, or nullptr for past-the-end.
+        const InstanceRange* _range = nullptr;
+
+        /// \brief The current instance.
+        Poco::Timestamp _current;
+
+        /// \brief The index of the current instance.
+        std::size_t _index = 0;
+
+        friend class InstanceRange;
+
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /// \brief Create a range with a fixed number of instances.
+    /// \param start The starting time.
+    /// \param numInstances The number of instances.
+    /// \param period The instance increment size.
+    InstanceRange(const Poco::Timestamp& start,
+                  std::size_t numInstances,
+                  const Period& period);
+
+    /// \brief Create a range of instances within a Poco::Timespan.
+    /// \param start The starting time.
+    /// \param timespan The duration after start within which instances occur.
+    /// \param period The instance increment size.
+    InstanceRange(const Poco::Timestamp& start,
+                  const Poco::Timespan& timespan,
+                  const Period& period);
+
+    /// \brief Create a range of the instances that happen before "end".
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size.
+    InstanceRange(const Poco::Timestamp& start,
+                  const Poco::Timestamp& end,
+                  const Period& period);
+
+    /// \brief Create a range of instances beginning with the Interval's start
+    /// time that happen before the Interval's end time.
+    /// \param interval The Interval to generate instances within.
+    /// \param period The instance increment size.
+    InstanceRange(const Interval& interval, const Period& period);
+
+    /// \returns an Iterator pointing to the first instance.
+    Iterator begin() const;
+
+    /// \returns a past-the-end Iterator.
+    Iterator end() const;
+
+    /// \returns true iff the range contains no instances.
+    bool empty() const;
+
+    /// \returns the number of instances in the range.
+    /// \note This is computed directly for fixed periods, but requires
+    /// iterating over the range otherwise.
+    std::size_t size() const;
+
+    /// \returns the Period used to increment instances.
+    const Period& getPeriod() const;
+
+private:
+    /// \brief The first instance.
+    Poco::Timestamp _start;
+
+    /// \brief All instances occur before this time.
+    Poco::Timestamp _end;
+
+    /// \brief The maximum number of instances.
+    std::size_t _numInstances;
+
+    /// \brief The instance increment size.
+    Period _period;
+
+    /// \brief True if the Period is fixed and _step can be used directly.
+    bool _isFixed;
+
+    /// \brief The increment in microseconds when the Period is fixed.
+    Poco::Timestamp::TimeDiff _step;
+
+};
+
+
+} } // namespace ofx::Time
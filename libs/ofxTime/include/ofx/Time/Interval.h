@@ -8,7 +8,11 @@
 #pragma once
 
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <stdint.h>
+#include <type_traits>
 #include "Poco/DateTime.h"
 #include "Poco/Timestamp.h"
 #include "Poco/Timespan.h"
@@ -28,45 +32,74 @@ namespace Time {
 /// operators compare both end points.  Comparison operators >, <, >=, <=
 /// compare only the start end point and are primarily useful for sorting.
 ///
+/// Interval is a final, trivially copyable 16 byte value type holding the
+/// end points as epoch microseconds.  The accessors and comparisons are
+/// inline, and those that do not involve Poco types are constexpr.
+///
 /// \note The relationship `start <= end` is enforced by this class.
-class Interval
+class Interval final
 {
 public:
     /// \brief Creates an empty Interval.
     ///
     /// Both start and end are set to with Poco::Timestamp(0).
-    Interval();
+    constexpr Interval() noexcept:
+        _start(0),
+        _end(0)
+    {
+    }
+
+    /// \brief Creates an Interval with start and end epoch microseconds.
+    /// \param start is starting time in microseconds since the epoch.
+    /// \param end is the ending time in microseconds since the epoch.
+    /// \note If `start > end`, the `start` and `end` are
+    /// swapped to guaruntee the relationship `start <= end`.
+    constexpr Interval(int64_t start, int64_t end) noexcept:
+        _start(start <= end ? start : end),
+        _end(start <= end ? end : start)
+    {
+    }
 
     /// \brief Creates an Interval with a start and a end Poco::Timestamp.
     /// \param start is starting timestamp.
     /// \param end is the ending timestamp.
     /// \note If `start > end`, the `start` and `end` are
     /// swapped to guaruntee the relationship `start <= end`.
-    Interval(const Poco::Timestamp& start, const Poco::Timestamp& end);
+    Interval(const Poco::Timestamp& start, const Poco::Timestamp& end):
+        Interval(start.epochMicroseconds(), end.epochMicroseconds())
+    {
+    }
 
     /// \brief Creates an Interval with a start and a end Poco::DateTime.
     /// \param start is starting datetime.
     /// \param end is the ending datetime.
     /// \note If `start > end`, the `start` and `end` are
     /// swapped to guaruntee the relationship `start <= end`.
-    Interval(const Poco::DateTime& start, const Poco::DateTime& end);
+    Interval(const Poco::DateTime& start, const Poco::DateTime& end):
+        Interval(start.timestamp(), end.timestamp())
+    {
+    }
 
     /// \brief Creates an Interval from the center.
     /// \param center is the center of the interval.
     /// \param timespan is the total duration of the interval.  The
     /// relationship `start == center - timespan / 2` and `end == center +
     /// timespan / 2` is enforced.
-    Interval(const Poco::Timestamp& center, const Poco::Timespan& timespan);
-
-    /// \brief Destroys the Interval.
-    virtual ~Interval();
+    Interval(const Poco::Timestamp& center, const Poco::Timespan& timespan):
+        Interval(center.epochMicroseconds() - timespan.totalMicroseconds() / 2,
+                 center.epochMicroseconds() + timespan.totalMicroseconds() / 2)
+    {
+    }
 
     /// \brief Sets the Interval bounds.
     /// \param start is starting timestamp.
     /// \param end is the ending timestamp.
     /// \note If `start > end`, the `start` and `end` are
     /// swapped to guaruntee the relationship `start <= end`.
-    void set(const Poco::Timestamp& start, const Poco::Timestamp& end);
+    void set(const Poco::Timestamp& start, const Poco::Timestamp& end)
+    {
+        *this = Interval(start, end);
+    }
 
     /// \brief Sets the Interval from the center.
     /// \param center is the center of the interval.
@@ -74,13 +107,34 @@ public:
     /// relationship `start == center - timespan / 2` and `end == center +
     /// timespan / 2` is enforced.
     void setFromCenter(const Poco::Timestamp& center,
-                       const Poco::Timespan& timespan);
+                       const Poco::Timespan& timespan)
+    {
+        *this = Interval(center, timespan);
+    }
 
     /// \returns the Interval start timestamp.
-    Poco::Timestamp getStart() const;
+    Poco::Timestamp getStart() const
+    {
+        return Poco::Timestamp(_start);
+    }
 
     /// \returns the Interval end timestamp.
-    Poco::Timestamp getEnd() const;
+    Poco::Timestamp getEnd() const
+    {
+        return Poco::Timestamp(_end);
+    }
+
+    /// \returns the Interval start in microseconds since the epoch.
+    constexpr int64_t getStartMicroseconds() const noexcept
+    {
+        return _start;
+    }
+
+    /// \returns the Interval end in microseconds since the epoch.
+    constexpr int64_t getEndMicroseconds() const noexcept
+    {
+        return _end;
+    }
 
     /// \brief Return a linearly interpolated timestamp.
     /// \param amount usually [0, 1], where 0 == start and 1 == end.
@@ -101,45 +155,94 @@ public:
     float normalize(const Poco::Timestamp& time) const;
 
     /// \returns the Poco::Timespan represented by end - start;
-    Poco::Timespan getTimespan() const;
+    Poco::Timespan getTimespan() const
+    {
+        return Poco::Timespan(_end - _start);
+    }
+
+    /// \returns the end - start in microseconds.
+    constexpr int64_t getDurationMicroseconds() const noexcept
+    {
+        return _end - _start;
+    }
+
+    /// \returns true iff the given time in microseconds since the epoch is
+    /// contained within the Interval.  The comparison is inclusive of the
+    /// endpoints.
+    constexpr bool contains(int64_t microseconds) const noexcept
+    {
+        return (microseconds >= _start) & (microseconds <= _end);
+    }
 
     /// \returns true iff the given Poco::Timestamp is contained within
     /// the Interval.  The comparison is inclusive of the endpoints.
-    bool contains(const Poco::Timestamp& timestamp) const;
+    bool contains(const Poco::Timestamp& timestamp) const
+    {
+        return contains(timestamp.epochMicroseconds());
+    }
 
     /// \returns true iff the given Interval is completely contained within
     /// the Interval.  The comparison is inclusive of the endpoints.
-    bool contains(const Interval& other) const;
+    constexpr bool contains(const Interval& other) const noexcept
+    {
+        return (other._start >= _start) & (other._end <= _end);
+    }
 
     /// \returns true iff any portion of the given Interval
-    /// with this Interval intersects with the
-    bool intersects(const Interval& other) const;
+    /// intersects with this Interval.  The comparison is inclusive of the
+    /// endpoints.
+    constexpr bool intersects(const Interval& other) const noexcept
+    {
+        return intersects(*this, other);
+    }
 
     /// \returns true iff the endpoints of the given Interval
     /// are exactly equal to the endpoints of this Interval.
-    bool operator == (const Interval& other) const;
+    constexpr bool operator == (const Interval& other) const noexcept
+    {
+        return (_start == other._start) & (_end == other._end);
+    }
 
     /// \returns true iff the endpoints of the given Interval
     /// are not exactly equal to the endpoints of this Interval.
-    bool operator != (const Interval& other) const;
+    constexpr bool operator != (const Interval& other) const noexcept
+    {
+        return (_start != other._start) | (_end != other._end);
+    }
 
     /// \returns true iff the start is greater than the given Interval's start.
-    bool operator >  (const Interval& other) const;
+    constexpr bool operator >  (const Interval& other) const noexcept
+    {
+        return _start > other._start;
+    }
 
     /// \returns true iff the start is greater than
     /// or equal to the given Interval's start.
-    bool operator >= (const Interval& other) const;
+    constexpr bool operator >= (const Interval& other) const noexcept
+    {
+        return _start >= other._start;
+    }
 
     /// \returns true iff the start is less than the given Interval's start.
-    bool operator <  (const Interval& other) const;
+    constexpr bool operator <  (const Interval& other) const noexcept
+    {
+        return _start < other._start;
+    }
 
     /// \returns true iff the start is less than or equal
     /// to the given Interval's start.
-    bool operator <= (const Interval& other) const;
-
-    /// \returns true iff the Interval0  is completely contained within the
-    /// Interval.  The comparison is inclusive of the endpoints.
-    static bool intersects(const Interval& interval0, const Interval& interval1);
+    constexpr bool operator <= (const Interval& other) const noexcept
+    {
+        return _start <= other._start;
+    }
+
+    /// \returns true iff any portion of the two Intervals intersect.  The
+    /// comparison is inclusive of the endpoints.
+    static constexpr bool intersects(const Interval& interval0,
+                                     const Interval& interval1) noexcept
+    {
+        return (interval0._start <= interval1._end) & (interval1._start <= interval0._end);
+    }
 
     /// \returns a Poco::Timestamp corresponding to a linear mapping in
     /// the given Interval where 0 == start and 1 == end.
@@ -158,13 +261,40 @@ public:
     static float normalize(const Interval& interval, const Poco::Timestamp& time);
 
 private:
-    Poco::Timestamp _start;
-        ///< \brief The start value of the Interval.
+    int64_t _start;
+        ///< \brief The start value of the Interval in epoch microseconds.
 
-    Poco::Timestamp _end;
-        ///< \brief The end value of the Interval.
+    int64_t _end;
+        ///< \brief The end value of the Interval in epoch microseconds.
 
 };
 
 
+static_assert(sizeof(Interval) == 16, "Interval must be 16 bytes.");
+static_assert(std::is_trivially_copyable<Interval>::value, "Interval must be trivially copyable.");
+
+
 } } // namespace ofx::Time
+
+
+namespace std {
+
+
+/// \brief Hashes an Interval so it can be used as an unordered container key.
+template <>
+struct hash<ofx::Time::Interval>
+{
+    std::size_t operator () (const ofx::Time::Interval& interval) const noexcept
+    {
+        // Multiply-xorshift mix of both end points.
+        uint64_t h = uint64_t(interval.getStartMicroseconds()) * UINT64_C(0x9E3779B97F4A7C15);
+        h ^= h >> 32;
+        h += uint64_t(interval.getEndMicroseconds());
+        h *= UINT64_C(0xBF58476D1CE4E5B9);
+        h ^= h >> 31;
+        return std::size_t(h);
+    }
+};
+
+
+} // namespace std
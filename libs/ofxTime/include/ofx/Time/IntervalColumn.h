@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Bits.h"
+#include "ofx/Time/Interval.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A column of Intervals stored as separate start and end arrays.
+///
+/// IntervalColumn stores the start and end points of each Interval in two
+/// contiguous int64_t arrays of epoch microseconds, which is the layout
+/// expected by analytics code and by the batch predicates below.  The
+/// predicates compare every Interval at once using AVX2 or AVX-512 when
+/// available and write one bit per Interval to a bitmask.
+///
+/// A bitmask holds getMaskSize() 64 bit words.  Bit `i % 64` of word
+/// `i / 64` is set iff Interval `i` matched.  Use toIndices() to convert a
+/// bitmask into a list of Interval indices.
+///
+/// \code{.cpp}
+/// ofxTime::IntervalColumn column(intervals);
+///
+/// for (std::size_t i: ofxTime::IntervalColumn::toIndices(column.contains(now)))
+/// {
+///     // intervals[i] contains now.
+/// }
+/// \endcode
+class IntervalColumn
+{
+public:
+    /// \brief A bitmask with one bit per Interval.
+    typedef std::vector<uint64_t> Mask;
+
+    /// \brief Create an empty IntervalColumn.
+    IntervalColumn();
+
+    /// \brief Create an IntervalColumn from Intervals.
+    /// \param intervals The Intervals to copy.
+    explicit IntervalColumn(const std::vector<Interval>& intervals);
+
+    /// \brief Replace the contents with a sequence of Intervals.
+    /// \param intervals The Intervals to copy.
+    /// \param size The number of Intervals.
+    void assign(const Interval* intervals, std::size_t size);
+
+    /// \brief Add an Interval to the end of the column.
+    /// \param interval The Interval to add.
+    void push_back(const Interval& interval);
+
+    /// \brief Reserve space for a number of Intervals.
+    /// \param size The number of Intervals.
+    void reserve(std::size_t size);
+
+    /// \brief Remove all Intervals.
+    void clear();
+
+    /// \returns the number of Intervals.
+    std::size_t size() const;
+
+    /// \returns true iff the column is empty.
+    bool empty() const;
+
+    /// \returns the Interval at the given index.
+    Interval operator [] (std::size_t index) const;
+
+    /// \returns the start points in epoch microseconds.
+    const int64_t* getStarts() const;
+
+    /// \returns the end points in epoch microseconds.
+    const int64_t* getEnds() const;
+
+    /// \returns the Intervals as a std::vector.
+    std::vector<Interval> toIntervals() const;
+
+    /// \returns the number of words in a bitmask for this column.
+    std::size_t getMaskSize() const;
+
+    /// \brief Find the Intervals that contain a time.
+    /// \param time The time to test.
+    /// \param mask The output bitmask of getMaskSize() words.
+    /// \sa Interval::contains(const Poco::Timestamp&)
+    void contains(const Poco::Timestamp& time, uint64_t* mask) const;
+
+    /// \brief Find the Intervals that contain a time.
+    /// \param time The time to test.
+    /// \returns the bitmask.
+    Mask contains(const Poco::Timestamp& time) const;
+
+    /// \brief Find the Intervals that completely contain an Interval.
+    /// \param interval The Interval to test.
+    /// \param mask The output bitmask of getMaskSize() words.
+    /// \sa Interval::contains(const Interval&)
+    void contains(const Interval& interval, uint64_t* mask) const;
+
+    /// \brief Find the Intervals that completely contain an Interval.
+    /// \param interval The Interval to test.
+    /// \returns the bitmask.
+    Mask contains(const Interval& interval) const;
+
+    /// \brief Find the Intervals that intersect an Interval.
+    /// \param interval The Interval to test.
+    /// \param mask The output bitmask of getMaskSize() words.
+    /// \sa Interval::intersects(const Interval&)
+    void intersects(const Interval& interval, uint64_t* mask) const;
+
+    /// \brief Find the Intervals that intersect an Interval.
+    /// \param interval The Interval to test.
+    /// \returns the bitmask.
+    Mask intersects(const Interval& interval) const;
+
+    /// \brief Compute the duration of every Interval.
+    /// \param timespans The output durations in microseconds, one per Interval.
+    /// \sa Interval::getTimespan()
+    void getTimespans(int64_t* timespans) const;
+
+    /// \returns the duration of every Interval in microseconds.
+    std::vector<int64_t> getTimespans() const;
+
+    /// \brief Convert a bitmask to a list of indices.
+    /// \param mask The bitmask.
+    /// \param size The number of words in the bitmask.
+    /// \param output The output iterator receiving the indices.
+    /// \returns the output iterator past the last index written.
+    template <typename OutputIterator>
+    static OutputIterator toIndices(const uint64_t* mask,
+                                    std::size_t size,
+                                    OutputIterator output);
+
+    /// \brief Convert a bitmask to a list of indices.
+    /// \param mask The bitmask.
+    /// \returns the indices of the set bits, in increasing order.
+    static std::vector<std::size_t> toIndices(const Mask& mask);
+
+    /// \returns the number of set bits in a bitmask.
+    static std::size_t count(const Mask& mask);
+
+private:
+    /// \brief Set bit i iff `starts[i] <= lower && ends[i] >= upper`.
+    ///
+    /// All three predicates reduce to this form.
+    void compare(int64_t lower, int64_t upper, uint64_t* mask) const;
+
+    /// \brief The start points in epoch microseconds.
+    std::vector<int64_t> _starts;
+
+    /// \brief The end points in epoch microseconds.
+    std::vector<int64_t> _ends;
+
+};
+
+
+template <typename OutputIterator>
+OutputIterator IntervalColumn::toIndices(const uint64_t* mask,
+                                         std::size_t size,
+                                         OutputIterator output)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        for (uint64_t word = mask[i]; word != 0; word &= word - 1)
+        {
+            *output++ = i * 64 + std::size_t(Bits::lowestBit(word));
+        }
+    }
+
+    return output;
+}
+
+
+} } // namespace ofx::Time
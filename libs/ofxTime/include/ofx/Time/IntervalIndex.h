@@ -0,0 +1,326 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Interval.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A static index of Intervals for stabbing, overlap and nearest
+/// neighbor queries.
+///
+/// The index is an implicit augmented interval tree: the Intervals are
+/// sorted by start time in a single flat array, the tree structure is
+/// implied by the array positions and each internal node stores the
+/// largest end time of its subtree.  There is no per-node allocation and
+/// small subtrees are scanned linearly.  A second array sorted by end time
+/// supports nearest neighbor queries.
+///
+/// Queries are O(log n + k) where k is the number of results, and report
+/// the positions of the matching Intervals in the sequence used to build
+/// the index.  All comparisons are inclusive of the endpoints, matching
+/// Interval::contains() and Interval::intersects().
+///
+/// \code{.cpp}
+/// ofxTime::IntervalIndex index(intervals);
+///
+/// for (std::size_t i: index.stab(Poco::Timestamp()))
+/// {
+///     // intervals[i] contains the current time.
+/// }
+/// \endcode
+///
+/// The index is based on Heng Li's cgranges.
+///
+/// For more information, please see:
+///   - https://github.com/lh3/cgranges
+class IntervalIndex
+{
+public:
+    /// \brief Create an empty IntervalIndex.
+    IntervalIndex();
+
+    /// \brief Create an IntervalIndex.
+    /// \param intervals The Intervals to index.
+    explicit IntervalIndex(const std::vector<Interval>& intervals);
+
+    /// \brief Rebuild the index.
+    /// \param intervals The Intervals to index.
+    void build(const std::vector<Interval>& intervals);
+
+    /// \brief Rebuild the index.
+    /// \param intervals The Intervals to index.
+    /// \param size The number of Intervals.
+    void build(const Interval* intervals, std::size_t size);
+
+    /// \brief Remove all Intervals from the index.
+    void clear();
+
+    /// \returns the number of indexed Intervals.
+    std::size_t size() const;
+
+    /// \returns true iff the index is empty.
+    bool empty() const;
+
+    /// \brief Find the Intervals that contain a time.
+    /// \param time The time to query.
+    /// \param output The output iterator receiving the Interval positions.
+    /// \returns the output iterator past the last position written.
+    template <typename OutputIterator>
+    OutputIterator stab(const Poco::Timestamp& time,
+                        OutputIterator output) const;
+
+    /// \brief Find the Intervals that contain a time.
+    /// \param time The time to query.
+    /// \returns the positions of the matching Intervals.
+    std::vector<std::size_t> stab(const Poco::Timestamp& time) const;
+
+    /// \brief Find the Intervals that intersect an Interval.
+    /// \param interval The Interval to query.
+    /// \param output The output iterator receiving the Interval positions.
+    /// \returns the output iterator past the last position written.
+    template <typename OutputIterator>
+    OutputIterator overlap(const Interval& interval,
+                           OutputIterator output) const;
+
+    /// \brief Find the Intervals that intersect an Interval.
+    /// \param interval The Interval to query.
+    /// \returns the positions of the matching Intervals.
+    std::vector<std::size_t> overlap(const Interval& interval) const;
+
+    /// \brief Find the k Intervals nearest to a time.
+    ///
+    /// The distance to an Interval is zero if it contains the time, and
+    /// otherwise the distance to its nearest endpoint.  Results are written
+    /// in order of increasing distance.  Ties between Intervals containing
+    /// the time are broken arbitrarily.
+    ///
+    /// \param time The time to query.
+    /// \param k The maximum number of Intervals to find.
+    /// \param output The output iterator receiving the Interval positions.
+    /// \returns the output iterator past the last position written.
+    template <typename OutputIterator>
+    OutputIterator nearest(const Poco::Timestamp& time,
+                           std::size_t k,
+                           OutputIterator output) const;
+
+    /// \brief Find the k Intervals nearest to a time.
+    /// \param time The time to query.
+    /// \param k The maximum number of Intervals to find.
+    /// \returns the positions of the nearest Intervals.
+    /// \sa nearest(const Poco::Timestamp&, std::size_t, OutputIterator)
+    std::vector<std::size_t> nearest(const Poco::Timestamp& time,
+                                     std::size_t k) const;
+
+private:
+    /// \brief A node of the implicit tree.
+    struct Node
+    {
+        /// \brief The start of the Interval in epoch microseconds.
+        int64_t start;
+
+        /// \brief The end of the Interval in epoch microseconds.
+        int64_t end;
+
+        /// \brief The largest end in the subtree rooted at this node.
+        int64_t maxEnd;
+
+        /// \brief The position of the Interval in the input.
+        std::size_t position;
+    };
+
+    /// \brief An entry in the secondary index sorted by end time.
+    struct End
+    {
+        /// \brief The end of the Interval in epoch microseconds.
+        int64_t end;
+
+        /// \brief The position of the Interval in the input.
+        std::size_t position;
+    };
+
+    /// \brief Call a function for each Interval intersecting [start, end].
+    ///
+    /// The traversal stops early if the function returns false.
+    template <typename Function>
+    void forEachOverlap(int64_t start, int64_t end, Function function) const;
+
+    /// \brief The tree nodes, sorted by start.
+    std::vector<Node> _nodes;
+
+    /// \brief The Interval ends, sorted by end.
+    std::vector<End> _ends;
+
+    /// \brief The level of the root node, or -1 if empty.
+    int _rootLevel;
+
+};
+
+
+template <typename OutputIterator>
+OutputIterator IntervalIndex::stab(const Poco::Timestamp& time,
+                                   OutputIterator output) const
+{
+    forEachOverlap(time.epochMicroseconds(),
+                   time.epochMicroseconds(),
+                   [&](const Node& node) {
+                       *output++ = node.position;
+                       return true;
+                   });
+    return output;
+}
+
+
+template <typename OutputIterator>
+OutputIterator IntervalIndex::overlap(const Interval& interval,
+                                      OutputIterator output) const
+{
+    forEachOverlap(interval.getStartMicroseconds(),
+                   interval.getEndMicroseconds(),
+                   [&](const Node& node) {
+                       *output++ = node.position;
+                       return true;
+                   });
+    return output;
+}
+
+
+template <typename OutputIterator>
+OutputIterator IntervalIndex::nearest(const Poco::Timestamp& time,
+                                      std::size_t k,
+                                      OutputIterator output) const
+{
+    const int64_t t = time.epochMicroseconds();
+
+    std::size_t count = 0;
+
+    if (k == 0)
+    {
+        return output;
+    }
+
+    // Intervals containing the time are at distance zero.
+    forEachOverlap(t, t, [&](const Node& node) {
+        *output++ = node.position;
+        return ++count < k;
+    });
+
+    // The remaining Intervals either start after the time or end before
+    // it, so merge a forward walk by start and a backward walk by end.
+    auto after = std::upper_bound(_nodes.begin(), _nodes.end(), t,
+                                  [](int64_t value, const Node& node) {
+                                      return value < node.start;
+                                  });
+
+    auto before = std::lower_bound(_ends.begin(), _ends.end(), t,
+                                   [](const End& entry, int64_t value) {
+                                       return entry.end < value;
+                                   });
+
+    while (count < k && (after != _nodes.end() || before != _ends.begin()))
+    {
+        bool takeBefore = after == _nodes.end()
+                       || (before != _ends.begin()
+                           && uint64_t(t) - uint64_t(std::prev(before)->end) <= uint64_t(after->start) - uint64_t(t));
+
+        if (takeBefore)
+        {
+            --before;
+            *output++ = before->position;
+        }
+        else
+        {
+            *output++ = after->position;
+            ++after;
+        }
+
+        ++count;
+    }
+
+    return output;
+}
+
+
+template <typename Function>
+void IntervalIndex::forEachOverlap(int64_t start,
+                                   int64_t end,
+                                   Function function) const
+{
+    struct Entry
+    {
+        int level;
+        int64_t x;
+        bool visited;
+    };
+
+    if (_rootLevel < 0)
+    {
+        return;
+    }
+
+    const int64_t n = int64_t(_nodes.size());
+    const Node* nodes = _nodes.data();
+
+    // Each level pushes at most two entries.
+    Entry stack[128];
+    int top = 0;
+
+    stack[top++] = Entry{ _rootLevel, (int64_t(1) << _rootLevel) - 1, false };
+
+    while (top > 0)
+    {
+        Entry entry = stack[--top];
+
+        if (entry.level <= 3)
+        {
+            // Small subtrees are faster to scan than to traverse.
+            int64_t i = entry.x >> entry.level << entry.level;
+            int64_t last = std::min(i + (int64_t(1) << (entry.level + 1)) - 1, n);
+
+            for (; i < last && nodes[i].start <= end; ++i)
+            {
+                if (start <= nodes[i].end && !function(nodes[i]))
+                {
+                    return;
+                }
+            }
+        }
+        else if (!entry.visited)
+        {
+            // Revisit this node after its left subtree.
+            int64_t left = entry.x - (int64_t(1) << (entry.level - 1));
+            stack[top++] = Entry{ entry.level, entry.x, true };
+
+            if (left >= n || nodes[left].maxEnd >= start)
+            {
+                stack[top++] = Entry{ entry.level - 1, left, false };
+            }
+        }
+        else if (entry.x < n && nodes[entry.x].start <= end)
+        {
+            if (start <= nodes[entry.x].end && !function(nodes[entry.x]))
+            {
+                return;
+            }
+
+            stack[top++] = Entry{ entry.level - 1, entry.x + (int64_t(1) << (entry.level - 1)), false };
+        }
+    }
+}
+
+
+} } // namespace ofx::Time
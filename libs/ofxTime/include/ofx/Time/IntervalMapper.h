@@ -0,0 +1,164 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Interval.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A precomputed linear mapping between an Interval and a range.
+///
+/// IntervalMapper maps times in an Interval to an output range such as
+/// screen pixels or sample indices, and back.  The scale and offset are
+/// computed once, so each mapping is an integer subtraction followed by a
+/// double multiply-add.  The subtraction is done on the integer
+/// microseconds, so precision is not lost on long Intervals.
+///
+/// The array versions of map() are vectorised with AVX2 when available.
+///
+/// \code{.cpp}
+/// ofxTime::IntervalMapper mapper(interval, 0, ofGetHeight());
+///
+/// float y = mapper.map(event);
+/// Poco::Timestamp underMouse = mapper.lerp(ofGetMouseY());
+/// \endcode
+class IntervalMapper
+{
+public:
+    /// \brief Create a mapper from an empty Interval to [0, 1].
+    IntervalMapper();
+
+    /// \brief Create an IntervalMapper.
+    /// \param interval The input Interval.
+    /// \param outputMin The output value for the Interval's start.
+    /// \param outputMax The output value for the Interval's end.
+    /// \param clamp If true, outputs of map() are clamped to the output
+    ///        range and times returned by lerp() to the Interval.
+    IntervalMapper(const Interval& interval,
+                   double outputMin = 0,
+                   double outputMax = 1,
+                   bool clamp = false);
+
+    /// \brief Set the mapping.
+    /// \sa IntervalMapper(const Interval&, double, double, bool)
+    void set(const Interval& interval,
+             double outputMin = 0,
+             double outputMax = 1,
+             bool clamp = false);
+
+    /// \returns the input Interval.
+    Interval getInterval() const;
+
+    /// \returns the output value for the Interval's start.
+    double getOutputMin() const;
+
+    /// \returns the output value for the Interval's end.
+    double getOutputMax() const;
+
+    /// \returns true iff the results are clamped.
+    bool isClamped() const;
+
+    /// \brief Map a time to the output range.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the output value.
+    double map(int64_t microseconds) const
+    {
+        double value = double(microseconds - _start) * _scale + _outputMin;
+        return _clamp ? clamp(value, _lower, _upper) : value;
+    }
+
+    /// \brief Map a time to the output range.
+    /// \param time The time.
+    /// \returns the output value.
+    double map(const Poco::Timestamp& time) const
+    {
+        return map(time.epochMicroseconds());
+    }
+
+    /// \brief Map an output value back to a time.
+    /// \param value The output value.
+    /// \returns the time, rounded to the nearest microsecond.
+    Poco::Timestamp lerp(double value) const
+    {
+        double offset = (value - _outputMin) * _inverseScale;
+
+        if (_clamp)
+        {
+            offset = clamp(offset, 0, double(_end - _start));
+        }
+
+        return Poco::Timestamp(_start + std::llround(offset));
+    }
+
+    /// \brief Map an array of times to the output range.
+    /// \param timestamps The times in microseconds since the epoch.
+    /// \param results The output values.
+    /// \param size The number of times.
+    void map(const int64_t* timestamps, double* results, std::size_t size) const;
+
+    /// \brief Map an array of times to the output range.
+    ///
+    /// This form is suitable for filling vertex arrays directly.
+    ///
+    /// \param timestamps The times in microseconds since the epoch.
+    /// \param results The output values.
+    /// \param size The number of times.
+    void map(const int64_t* timestamps, float* results, std::size_t size) const;
+
+    /// \brief Map an array of output values back to times.
+    /// \param values The output values.
+    /// \param results The times in microseconds since the epoch.
+    /// \param size The number of values.
+    void lerp(const double* values, int64_t* results, std::size_t size) const;
+
+private:
+    /// \returns the value limited to [lower, upper].
+    static double clamp(double value, double lower, double upper)
+    {
+        return value < lower ? lower : (value > upper ? upper : value);
+    }
+
+    /// \brief The start of the Interval in epoch microseconds.
+    int64_t _start;
+
+    /// \brief The end of the Interval in epoch microseconds.
+    int64_t _end;
+
+    /// \brief The output value for the start.
+    double _outputMin;
+
+    /// \brief The output value for the end.
+    double _outputMax;
+
+    /// \brief The smaller of the output values.
+    double _lower;
+
+    /// \brief The larger of the output values.
+    double _upper;
+
+    /// \brief The output units per microsecond.
+    double _scale;
+
+    /// \brief The microseconds per output unit.
+    double _inverseScale;
+
+    /// \brief True if results are clamped.
+    bool _clamp;
+
+};
+
+
+} } // namespace ofx::Time
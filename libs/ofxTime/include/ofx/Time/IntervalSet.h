@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <vector>
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Interval.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A sorted set of disjoint Intervals that coalesces on insertion.
+///
+/// An IntervalSet represents a set of microseconds as the smallest possible
+/// sequence of disjoint, sorted Intervals.  Like Interval, the end points
+/// are inclusive, so Intervals that overlap or that are adjacent (one ends
+/// the microsecond before the other starts) are merged into one.  Erasing
+/// an Interval removes exactly the microseconds it contains, which may
+/// split an existing Interval in two.
+///
+/// Insertion and erasure are O(log n) amortised.  Union, intersection and
+/// difference of two sets are linear in the total number of Intervals.
+///
+/// \code{.cpp}
+/// ofxTime::IntervalSet available;
+/// available.insert(morning);
+/// available.insert(afternoon);
+/// available.erase(lunch);
+///
+/// for (const ofxTime::Interval& gap: available.gaps(today))
+/// {
+///     // ...
+/// }
+/// \endcode
+class IntervalSet
+{
+public:
+    /// \brief A forward iterator over the Intervals of an IntervalSet.
+    ///
+    /// Intervals are produced by value, in order of increasing start time.
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Interval value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Interval* pointer;
+        typedef Interval reference;
+
+        /// \brief Create a singular Iterator.
+        Iterator();
+
+        /// \returns the current Interval.
+        reference operator * () const;
+
+        /// \brief Advance to the next Interval.
+        /// \returns this Iterator.
+        Iterator& operator ++ ();
+
+        /// \brief Advance to the next Interval.
+        /// \returns a copy of this Iterator before it was advanced.
+        Iterator operator ++ (int);
+
+        /// \returns true iff the iterators point to the same Interval.
+        bool operator == (const Iterator& other) const;
+
+        /// \returns true iff the iterators are not equal.
+        bool operator != (const Iterator& other) const;
+
+    private:
+        Iterator(std::map<int64_t, int64_t>::const_iterator iterator);
+
+        /// \brief The current start and end.
+        std::map<int64_t, int64_t>::const_iterator _iterator;
+
+        friend class IntervalSet;
+
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /// \brief Create an empty IntervalSet.
+    IntervalSet();
+
+    /// \brief Create an IntervalSet from a sequence of Intervals.
+    /// \param intervals The Intervals, which may overlap and be unsorted.
+    explicit IntervalSet(const std::vector<Interval>& intervals);
+
+    /// \brief Add an Interval, merging it with any it overlaps or touches.
+    /// \param interval The Interval to add.
+    void insert(const Interval& interval);
+
+    /// \brief Remove the microseconds contained in an Interval.
+    /// \param interval The Interval to remove.
+    void erase(const Interval& interval);
+
+    /// \brief Remove all Intervals.
+    void clear();
+
+    /// \returns true iff the set is empty.
+    bool empty() const;
+
+    /// \returns the number of disjoint Intervals in the set.
+    std::size_t size() const;
+
+    /// \returns an iterator to the first Interval.
+    Iterator begin() const;
+
+    /// \returns a past-the-end iterator.
+    Iterator end() const;
+
+    /// \returns the disjoint Intervals in the set.
+    std::vector<Interval> getIntervals() const;
+
+    /// \returns true iff the time is contained in the set.
+    bool contains(const Poco::Timestamp& time) const;
+
+    /// \returns true iff all of the Interval is contained in the set.
+    bool contains(const Interval& interval) const;
+
+    /// \returns true iff any part of the Interval is contained in the set.
+    bool intersects(const Interval& interval) const;
+
+    /// \brief Find the parts of an Interval not contained in the set.
+    /// \param within The Interval to search.
+    /// \param output The output iterator receiving the gaps.
+    /// \returns the output iterator past the last gap written.
+    template <typename OutputIterator>
+    OutputIterator gaps(const Interval& within, OutputIterator output) const;
+
+    /// \brief Find the parts of an Interval not contained in the set.
+    /// \param within The Interval to search.
+    /// \returns the gaps, in order.
+    std::vector<Interval> gaps(const Interval& within) const;
+
+    /// \returns true iff both sets contain the same Intervals.
+    bool operator == (const IntervalSet& other) const;
+
+    /// \returns true iff the sets are not equal.
+    bool operator != (const IntervalSet& other) const;
+
+    /// \returns the union of two sets.
+    static IntervalSet setUnion(const IntervalSet& set0,
+                                const IntervalSet& set1);
+
+    /// \returns the intersection of two sets.
+    static IntervalSet setIntersection(const IntervalSet& set0,
+                                       const IntervalSet& set1);
+
+    /// \returns the microseconds in set0 that are not in set1.
+    static IntervalSet setDifference(const IntervalSet& set0,
+                                     const IntervalSet& set1);
+
+private:
+    /// \brief Add an Interval that starts at or after the last Interval.
+    ///
+    /// Used to build results in order in amortised constant time.
+    void append(int64_t start, int64_t end);
+
+    /// \returns true iff an Interval ending at end overlaps or touches an
+    /// Interval starting at start.
+    static bool touches(int64_t end, int64_t start);
+
+    /// \brief The Interval ends, keyed by start.
+    std::map<int64_t, int64_t> _intervals;
+
+};
+
+
+template <typename OutputIterator>
+OutputIterator IntervalSet::gaps(const Interval& within,
+                                 OutputIterator output) const
+{
+    const int64_t last = within.getEndMicroseconds();
+
+    int64_t cursor = within.getStartMicroseconds();
+
+    auto iter = _intervals.upper_bound(cursor);
+
+    if (iter != _intervals.begin())
+    {
+        --iter;
+
+        if (iter->second < cursor)
+        {
+            ++iter;
+        }
+    }
+
+    for (; iter != _intervals.end() && iter->first <= last; ++iter)
+    {
+        if (iter->first > cursor)
+        {
+            *output++ = Interval(cursor, iter->first - 1);
+        }
+
+        if (iter->second >= last)
+        {
+            return output;
+        }
+
+        cursor = iter->second + 1;
+    }
+
+    *output++ = Interval(cursor, last);
+
+    return output;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <iterator>
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "ofx/Time/Interval.h"
+#include "ofx/Time/Period.h"
+#include "ofx/Time/TimeZone.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A lazily evaluated sequence of instances in local time.
+///
+/// An InstanceRange steps in UTC, so "every day at 09:00" in a zone with
+/// daylight saving time drifts by an hour at each transition.  A
+/// LocalInstanceRange instead steps the local wall clock time of the start
+/// in the given TimeZone and converts each local instance back to UTC.
+/// Calendar fields are added with the same calendar arithmetic as
+/// Utils::add(), and fixed-length fields are added to the local time, so a
+/// DAY is always the same time on the next calendar day.
+///
+/// Local instances that never occur or occur twice because of a transition
+/// are converted with the given policies.  Instances are visited in local
+/// time order, so with TimeZone::AMBIGUOUS_BOTH each ambiguous local time
+/// produces its earlier and then its later UTC time.  Skipped local times
+/// do not count toward the number of instances.  The start is converted
+/// to local time and resolved in the same way as every other instance.
+///
+/// The offsets are looked up in the TimeZone's cached transition table and
+/// reused while the instances stay between two transitions.
+///
+/// \code{.cpp}
+/// std::shared_ptr<const ofxTime::TimeZone> zone = ofxTime::TimeZone::get("Europe/London");
+///
+/// // Every day at 09:00 London time, starting at the given UTC time.
+/// ofxTime::LocalInstanceRange range(start, 365, ofxTime::Period::Day(), *zone);
+///
+/// for (const Poco::Timestamp& t: range)
+/// {
+///     // ...
+/// }
+/// \endcode
+///
+/// \note The TimeZone must outlive the LocalInstanceRange.  Iterators refer
+/// to the LocalInstanceRange that created them and are invalidated when the
+/// LocalInstanceRange is destroyed.
+class LocalInstanceRange
+{
+public:
+    /// \brief A forward iterator over the instances of a LocalInstanceRange.
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Poco::Timestamp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Poco::Timestamp* pointer;
+        typedef const Poco::Timestamp& reference;
+
+        /// \brief Create a past-the-end Iterator.
+        Iterator();
+
+        /// \returns the current instance.
+        reference operator * () const;
+
+        /// \returns a pointer to the current instance.
+        pointer operator -> () const;
+
+        /// \brief Advance to the next instance.
+        /// \returns this Iterator.
+        Iterator& operator ++ ();
+
+        /// \brief Advance to the next instance.
+        /// \returns a copy of this Iterator before it was advanced.
+        Iterator operator ++ (int);
+
+        /// \returns true iff both iterators are past-the-end or both point to
+        /// the same instance of the same LocalInstanceRange.
+        bool operator == (const Iterator& other) const;
+
+        /// \returns true iff the iterators are not equal.
+        bool operator != (const Iterator& other) const;
+
+        /// \returns the local time of the current instance in microseconds
+        ///          since the local epoch.
+        int64_t local() const;
+
+    private:
+        Iterator(const LocalInstanceRange* range);
+
+        /// \returns true iff this Iterator is past-the-end.
+        bool done() const;
+
+        /// \brief Advance the local time by one period.
+        void step();
+
+        /// \brief Convert the local time to the current instance, stepping
+        ///        past skipped local times.
+        void resolve();
+
+        /// \brief The range being iterated, or nullptr for past-the-end.
+        const LocalInstanceRange* _range = nullptr;
+
+        /// \brief The current instance.
+        Poco::Timestamp _current;
+
+        /// \brief The local time of the current instance.
+        int64_t _local = 0;
+
+        /// \brief The later time of an ambiguous local time, if pending.
+        int64_t _later = 0;
+
+        /// \brief True iff _later is the next instance.
+        bool _hasLater = false;
+
+        /// \brief The local times [_first, _last) with the offset _offset.
+        int64_t _first = 0;
+
+        /// \brief The end of the local times with the offset _offset.
+        int64_t _last = 0;
+
+        /// \brief The cached offset in microseconds.
+        int64_t _offset = 0;
+
+        /// \brief The index of the current instance.
+        std::size_t _index = 0;
+
+        friend class LocalInstanceRange;
+
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /// \brief Create a range with a fixed number of instances.
+    /// \param start The starting time.
+    /// \param numInstances The number of instances.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    LocalInstanceRange(const Poco::Timestamp& start,
+                       std::size_t numInstances,
+                       const Period& period,
+                       const TimeZone& zone,
+                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Create a range of instances within a Poco::Timespan.
+    /// \param start The starting time.
+    /// \param timespan The duration after start within which instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    LocalInstanceRange(const Poco::Timestamp& start,
+                       const Poco::Timespan& timespan,
+                       const Period& period,
+                       const TimeZone& zone,
+                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Create a range of the instances that happen before "end".
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    LocalInstanceRange(const Poco::Timestamp& start,
+                       const Poco::Timestamp& end,
+                       const Period& period,
+                       const TimeZone& zone,
+                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Create a range of instances beginning with the Interval's start
+    /// time that happen before the Interval's end time.
+    /// \param interval The Interval to generate instances within.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    LocalInstanceRange(const Interval& interval,
+                       const Period& period,
+                       const TimeZone& zone,
+                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \returns an Iterator pointing to the first instance.
+    Iterator begin() const;
+
+    /// \returns a past-the-end Iterator.
+    Iterator end() const;
+
+    /// \returns true iff the range contains no instances.
+    bool empty() const;
+
+    /// \returns the number of instances in the range.
+    /// \note This requires iterating over the range.
+    std::size_t size() const;
+
+    /// \returns the Period used to increment instances.
+    const Period& getPeriod() const;
+
+    /// \returns the time zone.
+    const TimeZone& getTimeZone() const;
+
+    /// \returns the policy for local times that never occur.
+    TimeZone::NonexistentPolicy getNonexistentPolicy() const;
+
+    /// \returns the policy for local times that occur twice.
+    TimeZone::AmbiguousPolicy getAmbiguousPolicy() const;
+
+private:
+    /// \brief The first instance.
+    Poco::Timestamp _start;
+
+    /// \brief All instances occur before this time.
+    Poco::Timestamp _end;
+
+    /// \brief The maximum number of instances.
+    std::size_t _numInstances;
+
+    /// \brief The instance increment size.
+    Period _period;
+
+    /// \brief True if the Period is fixed and _step can be used directly.
+    bool _isFixed;
+
+    /// \brief The increment in microseconds when the Period is fixed.
+    Poco::Timestamp::TimeDiff _step;
+
+    /// \brief The time zone.
+    const TimeZone* _zone;
+
+    /// \brief The policy for local times that never occur.
+    TimeZone::NonexistentPolicy _nonexistent;
+
+    /// \brief The policy for local times that occur twice.
+    TimeZone::AmbiguousPolicy _ambiguous;
+
+};
+
+
+} } // namespace ofx::Time
@@ -8,7 +8,6 @@
 #pragma once
 
 
-#include <vector>
 #include <cstdlib>
 #include <stdint.h>
 #include "Poco/Timestamp.h"
@@ -29,6 +28,12 @@ class Period
     // are vary due to "leap" seconds, and other calendrical irregularities.
     //
     // Empty or NULL periods are those that have all fields set to zero.
+    //
+    // Periods are stored inline without heap allocation.  The fixed-length
+    // fields are kept pre-summed in microseconds and a bitmask records which
+    // fields are non-zero, so adding a Period to a time is a single integer
+    // add plus an optional calendar step.  Periods are literal types and can
+    // be built at compile time.
 {
 public:
     enum Field
@@ -50,143 +55,481 @@ public:
         NUM_FIELDS = YEAR + 1
     };
 
-    Period();
+    enum
+    {
+        CALENDAR_FIELD_MASK = (1 << MONTH) | (1 << YEAR)
+            ///< A mask of the fields with a calendar dependent length.
+    };
+
+    constexpr Period() noexcept;
         ///< Create a 0 period.
 
-    Period(Field field, int64_t amount);
+    constexpr Period(Field field, int64_t amount) noexcept;
         ///< Create a period with a given amount in a given field.
         ///< The amount can be negative.
 
-    virtual ~Period();
-        ///< Destroy the Period.
-
-    void set(Field field, int64_t amount);
+    constexpr void set(Field field, int64_t amount) noexcept;
         ///< Set the value of a specific field.
 
-    Poco::Timestamp::TimeVal get(Field field) const;
+    constexpr Poco::Timestamp::TimeVal get(Field field) const noexcept;
         ///< Get the given field's amount.
 
-    void add(Field field, int64_t amount);
+    constexpr void add(Field field, int64_t amount) noexcept;
         ///< Add the given amount to the given Field.
         ///< The amount can be negative.
 
-    void addMicroseconds(int64_t amount);
+    constexpr void addMicroseconds(int64_t amount) noexcept;
         ///< Add microseconds.
         ///< The amount can be negative.
 
-    void addMilliseconds(int64_t amount);
+    constexpr void addMilliseconds(int64_t amount) noexcept;
         ///< Add milliseconds.
         ///< The amount can be negative.
 
-    void addSeconds(int64_t amount);
+    constexpr void addSeconds(int64_t amount) noexcept;
         ///< Add seconds.
         ///< The amount can be negative.
 
-    void addMinutes(int64_t amount);
+    constexpr void addMinutes(int64_t amount) noexcept;
         ///< Add minutes.
         ///< The amount can be negative.
 
-    void addHours(int64_t amount);
+    constexpr void addHours(int64_t amount) noexcept;
         ///< Add hours.
         ///< The amount can be negative.
 
-    void addDays(int64_t amount);
+    constexpr void addDays(int64_t amount) noexcept;
         ///< Add days.
         ///< The amount can be negative.
 
-    void addWeeks(int64_t amount);
+    constexpr void addWeeks(int64_t amount) noexcept;
         ///< Add weeks.
         ///< The amount can be negative.
 
-    void addMonths(int64_t amount);
+    constexpr void addMonths(int64_t amount) noexcept;
         ///< Add months.
         ///< The amount can be negative.
 
-    void addYears(int64_t amount);
+    constexpr void addYears(int64_t amount) noexcept;
         ///< Add years.
         ///< The amount can be negative.
 
-    void clear(Field field);
+    constexpr void clear(Field field) noexcept;
         ///< Clear a given Field's value.
 
-    bool empty() const;
+    constexpr bool empty() const noexcept;
         ///< Returns true iff all possible fields are set to 0.
 
-    Period  operator +  (const Period& period) const;
-	Period  operator -  (const Period& period) const;
-	Period& operator += (const Period& period);
-	Period& operator -= (const Period& period);
+    constexpr bool isFixed() const noexcept;
+        ///< Returns true iff only fixed-length fields (MICROSECOND through
+        ///< WEEK) are non-zero.  The length of a fixed Period does not depend
+        ///< on the calendar time it is added to.
+
+    constexpr int64_t getFixedMicroseconds() const noexcept;
+        ///< Returns the sum of the fixed-length fields (MICROSECOND through
+        ///< WEEK) in microseconds.  MONTH and YEAR fields are ignored.
+
+    constexpr uint32_t getFieldMask() const noexcept;
+        ///< Returns a bitmask where bit (1 << field) is set iff the field is
+        ///< non-zero.
+
+    constexpr Period operator + (const Period& period) const noexcept;
+        ///< Returns the field-wise sum of this and the given Period.
+
+    constexpr Period operator - (const Period& period) const noexcept;
+        ///< Returns the field-wise difference of this and the given Period.
+
+    constexpr Period operator * (int64_t factor) const noexcept;
+        ///< Returns this Period with every field multiplied by the given factor.
 
-    static Period Microsecond();
+    constexpr Period& operator += (const Period& period) noexcept;
+        ///< Adds the given Period to this Period field-wise.
+
+    constexpr Period& operator -= (const Period& period) noexcept;
+        ///< Subtracts the given Period from this Period field-wise.
+
+    static constexpr int64_t getFieldMicroseconds(Field field) noexcept;
+        ///< Returns the length of one unit of a fixed-length field in
+        ///< microseconds, or 0 for MONTH and YEAR.
+
+    static constexpr Period Microsecond() noexcept;
         ///< Returns a period of one microsecond.
 
-    static Period Microseconds(int64_t amount);
+    static constexpr Period Microseconds(int64_t amount) noexcept;
         ///< Returns a period of microseconds.
         ///< The amount can be negative.
 
-    static Period Millisecond();
+    static constexpr Period Millisecond() noexcept;
         ///< Returns a period of one millisecond.
 
-    static Period Milliseconds(int64_t amount);
+    static constexpr Period Milliseconds(int64_t amount) noexcept;
         ///< Returns a period of milliseconds.
         ///< The amount can be negative.
 
-    static Period Second();
+    static constexpr Period Second() noexcept;
         ///< Returns a period of one second.
 
-    static Period Seconds(int64_t amount);
+    static constexpr Period Seconds(int64_t amount) noexcept;
         ///< Returns a period of seconds.
         ///< The amount can be negative.
 
-    static Period Minute();
+    static constexpr Period Minute() noexcept;
         ///< Returns a period of one minute.
 
-    static Period Minutes(int64_t amount);
+    static constexpr Period Minutes(int64_t amount) noexcept;
         ///< Returns a period of minutes.
         ///< The amount can be negative.
 
-    static Period Hour();
+    static constexpr Period Hour() noexcept;
         ///< Returns a period of one hour.
 
-    static Period Hours(int64_t amount);
+    static constexpr Period Hours(int64_t amount) noexcept;
         ///< Returns a period of hours.
         ///< The amount can be negative.
 
-    static Period Day();
+    static constexpr Period Day() noexcept;
         ///< Returns a period of one day.
 
-    static Period Days(int64_t amount);
+    static constexpr Period Days(int64_t amount) noexcept;
         ///< Returns a period of days.
         ///< The amount can be negative.
 
-    static Period Week();
+    static constexpr Period Week() noexcept;
         ///< Returns a period of one week.
 
-    static Period Weeks(int64_t amount);
-        ///< Returns a period of days.
+    static constexpr Period Weeks(int64_t amount) noexcept;
+        ///< Returns a period of weeks.
         ///< The amount can be negative.
 
-    static Period Month();
+    static constexpr Period Month() noexcept;
         ///< Returns a period of one month.
 
-    static Period Month(int64_t amount);
+    static constexpr Period Month(int64_t amount) noexcept;
         ///< Returns a period of months.
         ///< The amount can be negative.
 
-    static Period Year();
+    static constexpr Period Year() noexcept;
         ///< Returns a period of one year.
 
-    static Period Years(int64_t amount);
+    static constexpr Period Years(int64_t amount) noexcept;
         ///< Returns a period of years.
         ///< The amount can be negative.
 
 private:
-    typedef std::vector<int64_t> FieldMap;
+    int64_t _fields[NUM_FIELDS];
+        ///< The amount stored in each field.
+
+    uint32_t _fieldMask;
+        ///< Bit (1 << field) is set iff the field is non-zero.
 
-    FieldMap _fields;
+    int64_t _fixedMicroseconds;
+        ///< The sum of the fixed-length fields in microseconds.
 
 };
 
 
+//
+// inlines
+//
+constexpr Period::Period() noexcept:
+    _fields{},
+    _fieldMask(0),
+    _fixedMicroseconds(0)
+{
+}
+
+
+constexpr Period::Period(Field field, int64_t amount) noexcept:
+    _fields{},
+    _fieldMask(0),
+    _fixedMicroseconds(0)
+{
+    set(field, amount);
+}
+
+
+constexpr void Period::set(Field field, int64_t amount) noexcept
+{
+    _fixedMicroseconds += (amount - _fields[field]) * getFieldMicroseconds(field);
+    _fields[field] = amount;
+
+    if (0 != amount)
+    {
+        _fieldMask |= (1u << field);
+    }
+    else
+    {
+        _fieldMask &= ~(1u << field);
+    }
+}
+
+
+constexpr Poco::Timestamp::TimeVal Period::get(Field field) const noexcept
+{
+    return _fields[field];
+}
+
+
+constexpr void Period::add(Field field, int64_t amount) noexcept
+{
+    set(field, _fields[field] + amount);
+}
+
+
+constexpr void Period::addMicroseconds(int64_t amount) noexcept
+{
+    add(MICROSECOND, amount);
+}
+
+
+constexpr void Period::addMilliseconds(int64_t amount) noexcept
+{
+    add(MILLISECOND, amount);
+}
+
+
+constexpr void Period::addSeconds(int64_t amount) noexcept
+{
+    add(SECOND, amount);
+}
+
+
+constexpr void Period::addMinutes(int64_t amount) noexcept
+{
+    add(MINUTE, amount);
+}
+
+
+constexpr void Period::addHours(int64_t amount) noexcept
+{
+    add(HOUR, amount);
+}
+
+
+constexpr void Period::addDays(int64_t amount) noexcept
+{
+    add(DAY, amount);
+}
+
+
+constexpr void Period::addWeeks(int64_t amount) noexcept
+{
+    add(WEEK, amount);
+}
+
+
+constexpr void Period::addMonths(int64_t amount) noexcept
+{
+    add(MONTH, amount);
+}
+
+
+constexpr void Period::addYears(int64_t amount) noexcept
+{
+    add(YEAR, amount);
+}
+
+
+constexpr void Period::clear(Field field) noexcept
+{
+    set(field, 0);
+}
+
+
+constexpr bool Period::empty() const noexcept
+{
+    return 0 == _fieldMask;
+}
+
+
+constexpr bool Period::isFixed() const noexcept
+{
+    return 0 == (_fieldMask & CALENDAR_FIELD_MASK);
+}
+
+
+constexpr int64_t Period::getFixedMicroseconds() const noexcept
+{
+    return _fixedMicroseconds;
+}
+
+
+constexpr uint32_t Period::getFieldMask() const noexcept
+{
+    return _fieldMask;
+}
+
+
+constexpr Period Period::operator + (const Period& period) const noexcept
+{
+    Period result(*this);
+    result += period;
+    return result;
+}
+
+
+constexpr Period Period::operator - (const Period& period) const noexcept
+{
+    Period result(*this);
+    result -= period;
+    return result;
+}
+
+
+constexpr Period Period::operator * (int64_t factor) const noexcept
+{
+    Period result;
+
+    for (int field = 0; field < int(NUM_FIELDS); ++field)
+    {
+        result.set(Field(field), _fields[field] * factor);
+    }
+
+    return result;
+}
+
+
+constexpr Period& Period::operator += (const Period& period) noexcept
+{
+    for (int field = 0; field < int(NUM_FIELDS); ++field)
+    {
+        add(Field(field), period._fields[field]);
+    }
+
+    return *this;
+}
+
+
+constexpr Period& Period::operator -= (const Period& period) noexcept
+{
+    for (int field = 0; field < int(NUM_FIELDS); ++field)
+    {
+        add(Field(field), -period._fields[field]);
+    }
+
+    return *this;
+}
+
+
+constexpr int64_t Period::getFieldMicroseconds(Field field) noexcept
+{
+    return field == MICROSECOND ? INT64_C(1)
+         : field == MILLISECOND ? INT64_C(1000)
+         : field == SECOND      ? INT64_C(1000000)
+         : field == MINUTE      ? INT64_C(60000000)
+         : field == HOUR        ? INT64_C(3600000000)
+         : field == DAY         ? INT64_C(86400000000)
+         : field == WEEK        ? INT64_C(604800000000)
+         : INT64_C(0);
+}
+
+
+constexpr Period Period::Microsecond() noexcept
+{
+    return Period(MICROSECOND, 1);
+}
+
+
+constexpr Period Period::Microseconds(int64_t amount) noexcept
+{
+    return Period(MICROSECOND, amount);
+}
+
+
+constexpr Period Period::Millisecond() noexcept
+{
+    return Period(MILLISECOND, 1);
+}
+
+
+constexpr Period Period::Milliseconds(int64_t amount) noexcept
+{
+    return Period(MILLISECOND, amount);
+}
+
+
+constexpr Period Period::Second() noexcept
+{
+    return Period(SECOND, 1);
+}
+
+
+constexpr Period Period::Seconds(int64_t amount) noexcept
+{
+    return Period(SECOND, amount);
+}
+
+
+constexpr Period Period::Minute() noexcept
+{
+    return Period(MINUTE, 1);
+}
+
+
+constexpr Period Period::Minutes(int64_t amount) noexcept
+{
+    return Period(MINUTE, amount);
+}
+
+
+constexpr Period Period::Hour() noexcept
+{
+    return Period(HOUR, 1);
+}
+
+
+constexpr Period Period::Hours(int64_t amount) noexcept
+{
+    return Period(HOUR, amount);
+}
+
+
+constexpr Period Period::Day() noexcept
+{
+    return Period(DAY, 1);
+}
+
+
+constexpr Period Period::Days(int64_t amount) noexcept
+{
+    return Period(DAY, amount);
+}
+
+
+constexpr Period Period::Week() noexcept
+{
+    return Period(WEEK, 1);
+}
+
+
+constexpr Period Period::Weeks(int64_t amount) noexcept
+{
+    return Period(WEEK, amount);
+}
+
+
+constexpr Period Period::Month() noexcept
+{
+    return Period(MONTH, 1);
+}
+
+
+constexpr Period Period::Month(int64_t amount) noexcept
+{
+    return Period(MONTH, amount);
+}
+
+
+constexpr Period Period::Year() noexcept
+{
+    return Period(YEAR, 1);
+}
+
+
+constexpr Period Period::Years(int64_t amount) noexcept
+{
+    return Period(YEAR, amount);
+}
+
 
 } } // namespace ofx::Time
@@ -0,0 +1,346 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <iterator>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief An RFC 5545 recurrence rule.
+///
+/// An RRule expands an iCalendar RRULE value such as
+/// `FREQ=MONTHLY;BYDAY=-1FR;COUNT=12` from a start time (DTSTART).  All
+/// rule parts are supported: FREQ, INTERVAL, COUNT, UNTIL, BYSECOND,
+/// BYMINUTE, BYHOUR, BYDAY, BYMONTHDAY, BYYEARDAY, BYWEEKNO, BYMONTH,
+/// BYSETPOS and WKST.  Excluded instances (EXDATE) can be added separately.
+///
+/// Instances are generated one FREQ period at a time, and the period that
+/// contains a given time is computed directly from the start, so next()
+/// does not iterate over the periods before it.  A COUNT is converted once,
+/// when the rule is created, into the time of its last instance.  As in
+/// RFC 5545, excluded instances still count toward the COUNT.
+///
+/// The rule is evaluated on the clock of the start time.  To follow the
+/// local time of a zone, create the rule with a TimeZone::toLocal() time
+/// and convert the instances with TimeZone::toUtc().  UNTIL values are
+/// read on the same clock, with or without a trailing `Z`.
+///
+/// Instances are those times that match the rule at or after the start.
+/// The start itself is only an instance if it matches the rule.
+///
+/// \code{.cpp}
+/// // The last Friday of every month.
+/// ofxTime::RRule rule(start, "FREQ=MONTHLY;BYDAY=-1FR");
+///
+/// Poco::Timestamp instance;
+///
+/// if (rule.next(Poco::Timestamp(), instance))
+/// {
+///     // ...
+/// }
+/// \endcode
+///
+/// For more information, please see:
+///   - https://www.rfc-editor.org/rfc/rfc5545#section-3.3.10
+class RRule
+{
+public:
+    /// \brief The frequencies, from the finest to the coarsest.
+    enum Frequency
+    {
+        SECONDLY,
+        MINUTELY,
+        HOURLY,
+        DAILY,
+        WEEKLY,
+        MONTHLY,
+        YEARLY
+    };
+
+    /// \brief A forward iterator over the instances of an RRule.
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Poco::Timestamp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Poco::Timestamp* pointer;
+        typedef const Poco::Timestamp& reference;
+
+        /// \brief Create a past-the-end Iterator.
+        Iterator();
+
+        /// \returns the current instance.
+        reference operator * () const;
+
+        /// \returns a pointer to the current instance.
+        pointer operator -> () const;
+
+        /// \brief Advance to the next instance.
+        /// \returns this Iterator.
+        Iterator& operator ++ ();
+
+        /// \brief Advance to the next instance.
+        /// \returns a copy of this Iterator before it was advanced.
+        Iterator operator ++ (int);
+
+        /// \returns true iff both iterators are past-the-end or both point to
+        /// the same instance of the same RRule.
+        bool operator == (const Iterator& other) const;
+
+        /// \returns true iff the iterators are not equal.
+        bool operator != (const Iterator& other) const;
+
+    private:
+        Iterator(const RRule* rule, int64_t from);
+
+        /// \brief Load the next instances at or after a time.
+        void load(int64_t from);
+
+        /// \brief The rule being iterated, or nullptr for past-the-end.
+        const RRule* _rule = nullptr;
+
+        /// \brief The buffered instances.
+        std::vector<int64_t> _instances;
+
+        /// \brief The position of the current instance in _instances.
+        std::size_t _position = 0;
+
+        /// \brief The current instance.
+        Poco::Timestamp _current;
+
+        friend class RRule;
+
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+
+    /// \brief Create an invalid RRule with no instances.
+    RRule();
+
+    /// \brief Create an RRule.
+    ///
+    /// If the rule is invalid, an error is logged and isValid() is false.
+    ///
+    /// \param start The start time (DTSTART).
+    /// \param rule The RRULE value, with or without the "RRULE:" prefix.
+    RRule(const Poco::Timestamp& start, const std::string& rule);
+
+    /// \returns true iff the rule was parsed successfully.
+    bool isValid() const;
+
+    /// \returns the start time (DTSTART).
+    const Poco::Timestamp& getStart() const;
+
+    /// \returns the frequency.
+    Frequency getFrequency() const;
+
+    /// \returns the number of periods between instances.
+    int getInterval() const;
+
+    /// \returns the COUNT, or 0 if there is none.
+    std::size_t getCount() const;
+
+    /// \returns the time of the last possible instance, taking both UNTIL
+    ///          and COUNT into account.
+    Poco::Timestamp getUntil() const;
+
+    /// \brief Exclude an instance (EXDATE).
+    /// \param time The time to exclude.
+    void addExclusion(const Poco::Timestamp& time);
+
+    /// \brief Replace the excluded instances (EXDATE).
+    /// \param times The times to exclude, in any order.
+    void setExclusions(const std::vector<Poco::Timestamp>& times);
+
+    /// \returns the excluded times in microseconds, sorted.
+    const std::vector<int64_t>& getExclusions() const;
+
+    /// \brief Find the first instance after a time.
+    /// \param after The time, in microseconds since the epoch.
+    /// \param instance The first instance strictly after the time.
+    /// \returns false if there are no more instances.
+    bool next(int64_t after, int64_t& instance) const;
+
+    /// \brief Find the first instance after a time.
+    /// \param after The time.
+    /// \param instance The first instance strictly after the time.
+    /// \returns false if there are no more instances.
+    bool next(const Poco::Timestamp& after, Poco::Timestamp& instance) const;
+
+    /// \brief Get the instances in a time range.
+    /// \param start The start of the range, inclusive.
+    /// \param end The end of the range, exclusive.
+    /// \returns the instances, in order.
+    std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                              const Poco::Timestamp& end) const;
+
+    /// \returns an Iterator pointing to the first instance.
+    Iterator begin() const;
+
+    /// \brief Get an iterator without visiting the earlier instances.
+    /// \param time The time.
+    /// \returns an Iterator pointing to the first instance at or after the
+    ///          given time.
+    Iterator begin(const Poco::Timestamp& time) const;
+
+    /// \returns a past-the-end Iterator.
+    Iterator end() const;
+
+private:
+    /// \brief A BYDAY value with an ordinal, e.g. -1FR.
+    struct OrdinalWeekday
+    {
+        /// \brief The week of the month or year, negative from the end.
+        int ordinal = 0;
+
+        /// \brief The day of the week [0, 6], where 0 is Sunday.
+        int weekday = 0;
+    };
+
+    /// \brief Parse an RRULE value.
+    /// \returns false and sets error if the rule is invalid.
+    bool parse(const std::string& rule, std::string& error);
+
+    /// \brief Fill in the defaults that RFC 5545 derives from the start.
+    void applyDefaults();
+
+    /// \returns the FREQ unit (second, minute, ..., year) that contains a
+    ///          time in seconds.
+    int64_t getUnit(int64_t seconds) const;
+
+    /// \returns the first second of a FREQ unit.
+    int64_t getUnitStart(int64_t unit) const;
+
+    /// \returns the index of the first period that starts at or after a
+    ///          unit, but not before the given period.
+    int64_t getPeriodAtOrAfter(int64_t unit, int64_t period) const;
+
+    /// \brief Find the first period with instances at or after a time.
+    /// \param from The earliest instance to keep, in microseconds.
+    /// \param instances The instances found, in order.
+    /// \param limit The maximum number of instances to find.
+    /// \returns false if there are no more instances.
+    bool seek(int64_t from,
+              std::vector<int64_t>& instances,
+              std::size_t limit) const;
+
+    /// \brief Expand one period.
+    /// \param period The period index.
+    /// \param from The earliest instance to keep, in microseconds.
+    /// \param instances The instances found, in order.
+    /// \param nextPeriod The index of the next period that can match.
+    /// \param limit The maximum number of instances to find.
+    /// \returns false if the period starts after the last instance.
+    bool expand(int64_t period,
+                int64_t from,
+                std::vector<int64_t>& instances,
+                int64_t& nextPeriod,
+                std::size_t limit) const;
+
+    /// \returns true iff a day matches the day rule parts.
+    /// \param day The day in days since 1970-01-01.
+    /// \param failedMonth Set to true if the day failed BYMONTH.
+    bool matchesDay(int64_t day, bool& failedMonth) const;
+
+    /// \returns true iff the start of a sub-daily unit matches BYHOUR,
+    ///          BYMINUTE and BYSECOND.
+    /// \param seconds The start of the unit in seconds.
+    /// \param next Set to the next second that might match.
+    bool matchesTime(int64_t seconds, int64_t& next) const;
+
+    /// \returns the first day of week 1 of a year.
+    int64_t getFirstWeekDay(int64_t year) const;
+
+    /// \returns true iff an instance is excluded.
+    bool isExcluded(int64_t instance) const;
+
+    /// \brief True iff the rule is valid.
+    bool _valid = false;
+
+    /// \brief The start time in microseconds.
+    Poco::Timestamp _start;
+
+    /// \brief The FREQ.
+    Frequency _frequency = DAILY;
+
+    /// \brief The INTERVAL.
+    int _interval = 1;
+
+    /// \brief The COUNT, or 0 if there is none.
+    std::size_t _count = 0;
+
+    /// \brief The last possible instance in microseconds.
+    int64_t _until = INT64_MAX;
+
+    /// \brief The first day of the week [0, 6], where 0 is Sunday.
+    int _weekStart = 1;
+
+    /// \brief Bit n is set for each value n of BYSECOND.
+    uint64_t _bySecond = 0;
+
+    /// \brief Bit n is set for each value n of BYMINUTE.
+    uint64_t _byMinute = 0;
+
+    /// \brief Bit n is set for each value n of BYHOUR.
+    uint32_t _byHour = 0;
+
+    /// \brief Bit n is set for each weekday n of BYDAY without an ordinal.
+    uint32_t _byWeekday = 0;
+
+    /// \brief The BYDAY values with an ordinal.
+    std::vector<OrdinalWeekday> _byOrdinalWeekday;
+
+    /// \brief Bit n is set for each positive value n of BYMONTHDAY.
+    uint32_t _byMonthDay = 0;
+
+    /// \brief Bit n is set for each negative value -n of BYMONTHDAY.
+    uint32_t _byNegativeMonthDay = 0;
+
+    /// \brief The BYYEARDAY values.
+    std::vector<int> _byYearDay;
+
+    /// \brief The BYWEEKNO values.
+    std::vector<int> _byWeekNo;
+
+    /// \brief Bit n is set for each value n of BYMONTH.
+    uint32_t _byMonth = 0;
+
+    /// \brief The BYSETPOS values.
+    std::vector<int> _bySetPos;
+
+    /// \brief The sorted times within a period, in seconds from the start
+    ///        of the period's day, hour or minute.
+    std::vector<int> _times;
+
+    /// \brief The start of the first period in FREQ units.
+    int64_t _startUnit = 0;
+
+    /// \brief The index of the last period that fits in a Poco::Timestamp.
+    int64_t _lastPeriod = 0;
+
+    /// \brief The microseconds after the second of the start.
+    int64_t _fraction = 0;
+
+    /// \brief The sorted excluded instances.
+    std::vector<int64_t> _exclusions;
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <cstring>
+#include <stdint.h>
+#include <thread>
+#include <type_traits>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A value that is written rarely and read often by many threads.
+///
+/// A SeqLock publishes a small trivially copyable value, such as a group
+/// of fields that must be read together, without a mutex.  Readers never
+/// block writers.  A reader that overlaps a write retries, so load() always
+/// returns a value that was stored as a whole.  Writers are serialized by
+/// the sequence number.
+///
+/// \tparam T The trivially copyable value type.
+template <typename T>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "The value must be trivially copyable.");
+
+    /// \brief Create a SeqLock.
+    /// \param value The initial value.
+    explicit SeqLock(const T& value = T());
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator = (const SeqLock&) = delete;
+
+    /// \returns a consistent copy of the value.
+    T load() const;
+
+    /// \brief Replace the value.
+    /// \param value The new value.
+    void store(const T& value);
+
+private:
+    enum
+    {
+        /// \brief The number of 64-bit words that hold the value.
+        WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t)
+    };
+
+    /// \brief Odd while a write is in progress.
+    std::atomic<uint64_t> _sequence;
+
+    /// \brief The value, stored in atomic words so that a read that
+    ///        overlaps a write is not a data race.
+    std::atomic<uint64_t> _words[WORDS];
+
+};
+
+
+template <typename T>
+SeqLock<T>::SeqLock(const T& value):
+    _sequence(0)
+{
+    for (std::atomic<uint64_t>& word: _words)
+    {
+        word.store(0, std::memory_order_relaxed);
+    }
+
+    store(value);
+}
+
+
+template <typename T>
+T SeqLock<T>::load() const
+{
+    uint64_t words[WORDS];
+
+    for (;;)
+    {
+        const uint64_t sequence = _sequence.load(std::memory_order_acquire);
+
+        if (0 == (sequence & 1))
+        {
+            for (std::size_t i = 0; i < WORDS; ++i)
+            {
+                words[i] = _words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (_sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                break;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+}
+
+
+template <typename T>
+void SeqLock<T>::store(const T& value)
+{
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(T));
+
+    uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+
+    while ((sequence & 1)
+        || !_sequence.compare_exchange_weak(sequence,
+                                            sequence + 1,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+    {
+        std::this_thread::yield();
+        sequence = _sequence.load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < WORDS; ++i)
+    {
+        _words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <stdint.h>
+#include "ofx/Time/Calendar.h"
+#include "ofx/Time/Period.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A Period with a single field and amount fixed at compile time.
+///
+/// A StaticPeriod carries its field and amount in its type, so the Utils
+/// overloads that accept it reduce to constant additions and divisions that
+/// the compiler can fold or turn into multiply-shift sequences.
+///
+/// A StaticPeriod converts implicitly to a Period, so it can be used anywhere
+/// a Period is expected.
+///
+/// \code{.cpp}
+/// typedef ofxTime::StaticPeriod<ofxTime::Period::MINUTE, 15> QuarterHour;
+///
+/// Poco::Timestamp next = ofxTime::Utils::add(now, QuarterHour());
+/// Poco::Timestamp slot = ofxTime::Utils::floor(now, QuarterHour());
+/// \endcode
+///
+/// \tparam FIELD The Period::Field.
+/// \tparam AMOUNT The amount of the field.  The amount can be negative.
+template <Period::Field FIELD, int64_t AMOUNT>
+class StaticPeriod
+{
+public:
+    /// \brief True if the field has a fixed length (MICROSECOND through WEEK).
+    static constexpr bool IS_FIXED = FIELD < Period::MONTH;
+
+    /// \brief The length of a fixed period in microseconds, 0 otherwise.
+    static constexpr int64_t MICROSECONDS = AMOUNT * Period::getFieldMicroseconds(FIELD);
+
+    /// \returns the equivalent runtime Period.
+    constexpr operator Period() const noexcept
+    {
+        return Period(FIELD, AMOUNT);
+    }
+
+    /// \returns the Period::Field.
+    static constexpr Period::Field field() noexcept
+    {
+        return FIELD;
+    }
+
+    /// \returns the amount of the field.
+    static constexpr int64_t amount() noexcept
+    {
+        return AMOUNT;
+    }
+
+    /// \brief Add this period to a time.
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the resulting time in microseconds since the epoch.
+    static constexpr int64_t add(int64_t microseconds) noexcept
+    {
+        return IS_FIXED ? microseconds + MICROSECONDS
+             : FIELD == Period::YEAR ? Calendar::addYears(microseconds, AMOUNT)
+             : Calendar::addMonths(microseconds, AMOUNT);
+    }
+
+    /// \brief Round a time down to a multiple of the period.
+    ///
+    /// Equivalent to Utils::floor(const Poco::Timestamp&, const Poco::Timespan&)
+    /// for fixed periods.  MONTH and YEAR periods round down to the start of
+    /// the calendar month or year, ignoring AMOUNT.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the rounded time in microseconds since the epoch.
+    static constexpr int64_t floor(int64_t microseconds) noexcept
+    {
+        return IS_FIXED ? (microseconds / DIVISOR) * DIVISOR
+             : FIELD == Period::YEAR ? Calendar::floorYear(microseconds)
+             : Calendar::floorMonth(microseconds);
+    }
+
+    /// \brief Round a time up to a multiple of the period.
+    ///
+    /// Equivalent to Utils::ceiling(const Poco::Timestamp&, const Poco::Timespan&)
+    /// for fixed periods.  MONTH and YEAR periods round up to the start of a
+    /// calendar month or year, ignoring AMOUNT.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the rounded time in microseconds since the epoch.
+    static constexpr int64_t ceiling(int64_t microseconds) noexcept
+    {
+        return IS_FIXED ? ((microseconds + DIVISOR - 1) / DIVISOR) * DIVISOR
+             : FIELD == Period::YEAR ? Calendar::ceilingYear(microseconds)
+             : Calendar::ceilingMonth(microseconds);
+    }
+
+    /// \brief Round a time to a multiple of the period.
+    ///
+    /// Equivalent to Utils::round(const Poco::Timestamp&, const Poco::Timespan&)
+    /// for fixed periods.  MONTH and YEAR periods round to the nearest start of
+    /// a calendar month or year, ignoring AMOUNT.
+    ///
+    /// \param microseconds The time in microseconds since the epoch.
+    /// \returns the rounded time in microseconds since the epoch.
+    static constexpr int64_t round(int64_t microseconds) noexcept
+    {
+        return IS_FIXED ? ((microseconds + (DIVISOR / 2) + 1) / DIVISOR) * DIVISOR
+             : FIELD == Period::YEAR ? Calendar::roundYear(microseconds)
+             : Calendar::roundMonth(microseconds);
+    }
+
+private:
+    /// \brief The rounding divisor, never 0 so calendar periods still compile.
+    static constexpr int64_t DIVISOR = IS_FIXED ? MICROSECONDS : 1;
+
+};
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+constexpr bool StaticPeriod<FIELD, AMOUNT>::IS_FIXED;
+
+template <Period::Field FIELD, int64_t AMOUNT>
+constexpr int64_t StaticPeriod<FIELD, AMOUNT>::MICROSECONDS;
+
+template <Period::Field FIELD, int64_t AMOUNT>
+constexpr int64_t StaticPeriod<FIELD, AMOUNT>::DIVISOR;
+
+
+} } // namespace ofx::Time
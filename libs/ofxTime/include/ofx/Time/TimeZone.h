@@ -0,0 +1,388 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Poco/LocalDateTime.h"
+#include "Poco/Timestamp.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A time zone loaded once from a TZif file.
+///
+/// Poco::LocalDateTime asks the C library for the time zone differential
+/// of the process time zone on every conversion.  A TimeZone instead reads
+/// the zone's transition table from the system zoneinfo database (see
+/// `man tzfile`) once and converts between UTC and local time with a binary
+/// search of the sorted transition times, so conversions do not lock, call
+/// into the C library or depend on the `TZ` environment variable.  Any
+/// number of zones can be used at the same time.
+///
+/// Times after the last transition in the file follow the POSIX `TZ` rule
+/// at the end of the file.  The rule is expanded into the transition table
+/// for 400 years, after which the Gregorian calendar, and therefore the
+/// rule, repeats exactly, so later times are mapped back into the table.
+///
+/// Leap second records are ignored.  All times are in microseconds since
+/// the epoch and all offsets are in seconds east of UTC, the same sign as
+/// Poco::LocalDateTime::tzd().
+///
+/// \code{.cpp}
+/// std::shared_ptr<const ofxTime::TimeZone> zone = ofxTime::TimeZone::get("America/Chicago");
+///
+/// if (zone)
+/// {
+///     Poco::Timestamp now;
+///     Poco::Timestamp midnight = ofxTime::Utils::floor(now, ofxTime::Period::DAY, *zone);
+/// }
+/// \endcode
+///
+/// For more information, please see:
+///   - https://www.rfc-editor.org/rfc/rfc8536
+///   - https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/V1_chap08.html
+class TimeZone
+{
+public:
+    /// \brief How to convert local times that never occur because the
+    ///        clocks were set forward.
+    enum NonexistentPolicy
+    {
+        /// \brief Move the time forward by the length of the gap, as when
+        ///        a wall clock is set forward.
+        NONEXISTENT_SHIFT_FORWARD,
+        /// \brief Move the time back by the length of the gap.
+        NONEXISTENT_SHIFT_BACKWARD,
+        /// \brief Use the first time after the gap, i.e. the transition.
+        NONEXISTENT_NEXT_VALID,
+        /// \brief Use the last time before the gap.
+        NONEXISTENT_PREVIOUS_VALID,
+        /// \brief Drop the time.
+        NONEXISTENT_SKIP
+    };
+
+    /// \brief How to convert local times that occur twice because the
+    ///        clocks were set back.
+    enum AmbiguousPolicy
+    {
+        /// \brief Use the first occurrence.
+        AMBIGUOUS_EARLIER,
+        /// \brief Use the second occurrence.
+        AMBIGUOUS_LATER,
+        /// \brief Use both occurrences, earlier first.
+        AMBIGUOUS_BOTH,
+        /// \brief Drop the time.
+        AMBIGUOUS_SKIP
+    };
+
+    /// \brief How a local time maps to UTC.
+    struct Resolution
+    {
+        /// \brief The kinds of local times.
+        enum Type
+        {
+            /// \brief The local time occurs exactly once.
+            UNIQUE,
+            /// \brief The local time occurs twice, because the clocks were
+            ///        set back.
+            AMBIGUOUS,
+            /// \brief The local time never occurs, because the clocks were
+            ///        set forward.
+            NONEXISTENT
+        };
+
+        /// \brief The kind of local time.
+        Type type = UNIQUE;
+
+        /// \brief The offset before the nearest transition, in seconds.
+        ///
+        /// For UNIQUE times this is the offset in effect.
+        int offsetBefore = 0;
+
+        /// \brief The offset after the nearest transition, in seconds.
+        ///
+        /// For UNIQUE times this is the offset in effect.
+        int offsetAfter = 0;
+
+        /// \brief The UTC time of the transition in microseconds since the
+        ///        epoch.
+        ///
+        /// Only meaningful for AMBIGUOUS and NONEXISTENT times.
+        int64_t transition = 0;
+
+        /// \brief Convert the local time to UTC.
+        /// \param local The local time that was resolved.
+        /// \param nonexistent The policy for NONEXISTENT times.
+        /// \param ambiguous The policy for AMBIGUOUS times.
+        /// \param utc The output UTC times, which must have room for two.
+        /// \returns the number of UTC times written, from zero to two.
+        std::size_t toUtc(int64_t local,
+                          NonexistentPolicy nonexistent,
+                          AmbiguousPolicy ambiguous,
+                          int64_t* utc) const;
+    };
+
+    /// \brief Get a time zone from the registry, loading it if needed.
+    ///
+    /// Names are looked up in the directory given by the `TZDIR`
+    /// environment variable, or `/usr/share/zoneinfo`.  Absolute paths are
+    /// loaded directly.  If no file exists, the name is parsed as a POSIX
+    /// `TZ` rule such as `EST5EDT,M3.2.0,M11.1.0`.
+    ///
+    /// Zones are loaded once and shared.  This function is thread-safe.
+    ///
+    /// \param name The zone name, e.g. "Europe/Berlin".
+    /// \returns the zone, or nullptr if it could not be loaded.
+    static std::shared_ptr<const TimeZone> get(const std::string& name);
+
+    /// \brief Get the time zone of the process.
+    ///
+    /// This is the zone named by the `TZ` environment variable, or
+    /// `/etc/localtime` if `TZ` is not set, at the time of the first call.
+    /// UTC is used if the zone cannot be loaded.
+    ///
+    /// \returns the zone.
+    static std::shared_ptr<const TimeZone> local();
+
+    /// \returns the UTC time zone.
+    static std::shared_ptr<const TimeZone> utc();
+
+    /// \brief Create a time zone from the contents of a TZif file.
+    /// \param name The name of the zone.
+    /// \param data The file contents.
+    /// \param size The number of bytes in the file.
+    /// \returns the zone, or nullptr if the data is not a valid TZif file.
+    static std::shared_ptr<const TimeZone> fromTZif(const std::string& name,
+                                                    const char* data,
+                                                    std::size_t size);
+
+    /// \brief Create a time zone from a POSIX `TZ` rule.
+    ///
+    /// The rule applies to all times.  If a daylight saving time zone is
+    /// given without a rule, the current United States rule is used.
+    ///
+    /// \param rule The rule, e.g. "CET-1CEST,M3.5.0,M10.5.0/3".
+    /// \returns the zone, or nullptr if the rule is invalid.
+    static std::shared_ptr<const TimeZone> fromPosix(const std::string& rule);
+
+    /// \returns the name of the zone.
+    const std::string& getName() const;
+
+    /// \returns the POSIX `TZ` rule for times after the last transition, or
+    ///          an empty string if the file has none.
+    const std::string& getRule() const;
+
+    /// \brief Get the offset from UTC at a time.
+    /// \param utc The UTC time in microseconds since the epoch.
+    /// \returns the offset in seconds east of UTC.
+    int getOffset(int64_t utc) const;
+
+    /// \brief Determine if daylight saving time is in effect at a time.
+    /// \param utc The UTC time in microseconds since the epoch.
+    /// \returns true iff daylight saving time is in effect.
+    bool isDST(int64_t utc) const;
+
+    /// \brief Get the abbreviation of the zone at a time.
+    /// \param utc The UTC time in microseconds since the epoch.
+    /// \returns the abbreviation, e.g. "CEST".
+    const std::string& getAbbreviation(int64_t utc) const;
+
+    /// \brief Convert a UTC time to local time.
+    /// \param utc The UTC time in microseconds since the epoch.
+    /// \returns the local time in microseconds since the local epoch.
+    int64_t toLocal(int64_t utc) const;
+
+    /// \brief Convert a local time to UTC.
+    ///
+    /// Ambiguous and nonexistent local times are converted using the offset
+    /// before the transition.  Ambiguous times therefore resolve to the
+    /// earlier UTC time and nonexistent times are moved forward by the
+    /// length of the gap, as when a wall clock is set forward.
+    ///
+    /// \param local The local time in microseconds since the local epoch.
+    /// \returns the UTC time in microseconds since the epoch.
+    int64_t toUtc(int64_t local) const;
+
+    /// \brief Determine how a local time maps to UTC.
+    /// \param local The local time in microseconds since the local epoch.
+    /// \returns the resolution.
+    Resolution resolve(int64_t local) const;
+
+    /// \brief Determine how a local time maps to UTC, and the local times
+    ///        that map the same way.
+    ///
+    /// Callers that convert many nearby local times can skip resolve()
+    /// while the times stay in [first, last).
+    ///
+    /// \param local The local time in microseconds since the local epoch.
+    /// \param first The first local time with the same UNIQUE offset.
+    /// \param last The local time after the last local time with the same
+    ///        UNIQUE offset.  first == last for other resolutions.
+    /// \returns the resolution.
+    Resolution resolve(int64_t local, int64_t& first, int64_t& last) const;
+
+    /// \brief Convert a local time to UTC with the given policies.
+    /// \param local The local time in microseconds since the local epoch.
+    /// \param nonexistent The policy for nonexistent local times.
+    /// \param ambiguous The policy for ambiguous local times.
+    /// \param utc The output UTC times, which must have room for two.
+    /// \returns the number of UTC times written, from zero to two.
+    std::size_t toUtc(int64_t local,
+                      NonexistentPolicy nonexistent,
+                      AmbiguousPolicy ambiguous,
+                      int64_t* utc) const;
+
+    /// \brief Convert an array of UTC times to local time.
+    ///
+    /// Sorted input is converted without a search while the times stay
+    /// between the same two transitions.
+    ///
+    /// \param utc The UTC times in microseconds since the epoch.
+    /// \param local The output local times, which may be the input array.
+    /// \param size The number of times.
+    void toLocal(const int64_t* utc, int64_t* local, std::size_t size) const;
+
+    /// \brief Convert an array of local times to UTC.
+    /// \param local The local times in microseconds since the local epoch.
+    /// \param utc The output UTC times, which may be the input array.
+    /// \param size The number of times.
+    /// \sa toUtc(int64_t) const
+    void toUtc(const int64_t* local, int64_t* utc, std::size_t size) const;
+
+    /// \brief Convert a Poco::Timestamp to a Poco::LocalDateTime in this zone.
+    /// \param timestamp The UTC time.
+    /// \returns the local date and time.
+    Poco::LocalDateTime toLocalDateTime(const Poco::Timestamp& timestamp) const;
+
+    /// \returns the number of transitions, including those expanded from
+    ///          the rule.
+    std::size_t getTransitionCount() const;
+
+    /// \brief The number of seconds in 400 Gregorian years.
+    static const int64_t CYCLE_SECONDS;
+
+private:
+    /// \brief A local time type.
+    struct Type
+    {
+        /// \brief The offset in seconds east of UTC.
+        int offset = 0;
+
+        /// \brief True iff this is daylight saving time.
+        bool isDST = false;
+
+        /// \brief The abbreviation.
+        std::string abbreviation;
+
+        bool operator == (const Type& other) const
+        {
+            return offset == other.offset
+                && isDST == other.isDST
+                && abbreviation == other.abbreviation;
+        }
+    };
+
+    /// \brief A POSIX `TZ` rule.
+    struct Rule;
+
+    TimeZone();
+
+    /// \brief Create a time zone from the contents of a TZif file.
+    /// \returns the zone, or nullptr if the data is invalid.
+    static std::shared_ptr<TimeZone> parseTZif(const std::string& name,
+                                               const char* data,
+                                               std::size_t size);
+
+    /// \brief Create a time zone from a POSIX `TZ` rule.
+    /// \returns the zone, or nullptr if the rule is invalid.
+    static std::shared_ptr<TimeZone> parsePosix(const std::string& name,
+                                                const std::string& rule);
+
+    /// \brief Load a time zone by name or path without logging.
+    static std::shared_ptr<TimeZone> load(const std::string& name);
+
+    /// \brief Find or add a type.
+    /// \returns the index of the type.
+    std::size_t addType(const Type& type);
+
+    /// \brief Append a transition to the table.
+    void addTransition(int64_t seconds, std::size_t type);
+
+    /// \brief Expand a rule into the table and set up the cycle.
+    void applyRule(const Rule& rule, int64_t firstYear, bool cycleBefore);
+
+    /// \brief Build the offset and local time tables from the transitions.
+    void finish();
+
+    /// \brief Map a time into the expanded table.
+    /// \param seconds The time in seconds, updated in place.
+    /// \returns the number of seconds subtracted.
+    int64_t reduce(int64_t& seconds) const;
+
+    /// \brief Get the first and last seconds that reduce() maps by the
+    ///        same amount as a reduced time.
+    void getCycleRange(int64_t shift, int64_t& first, int64_t& last) const;
+
+    /// \returns the index into _offsets of a reduced UTC time in seconds.
+    std::size_t findOffsetIndex(int64_t seconds) const;
+
+    /// \brief Resolve a local time in seconds.
+    /// \param seconds The local time in seconds since the local epoch.
+    /// \param first The first local second with the same UNIQUE offset.
+    /// \param last The local second after the last second with the same
+    ///        UNIQUE offset.  first == last for other resolutions.
+    Resolution resolveSeconds(int64_t seconds,
+                              int64_t& first,
+                              int64_t& last) const;
+
+    /// \brief The name of the zone.
+    std::string _name;
+
+    /// \brief The POSIX rule for times after the last transition.
+    std::string _rule;
+
+    /// \brief The local time types.
+    std::vector<Type> _types;
+
+    /// \brief The UTC transition times in seconds, sorted.
+    std::vector<int64_t> _transitions;
+
+    /// \brief The type in effect before the first transition and after
+    ///        each transition.
+    std::vector<uint16_t> _typeIndices;
+
+    /// \brief The offset in effect before the first transition and after
+    ///        each transition.
+    std::vector<int> _offsets;
+
+    /// \brief The first local time in seconds affected by each transition.
+    std::vector<int64_t> _localTransitions;
+
+    /// \brief The number of transitions read from the file.
+    std::size_t _fileTransitions = 0;
+
+    /// \brief The first UTC second of the repeating part of the table.
+    int64_t _cycleStart = 0;
+
+    /// \brief The UTC second after the repeating part of the table.
+    int64_t _cycleEnd = INT64_MAX;
+
+    /// \brief True iff times before _cycleStart also repeat.
+    bool _cycleBefore = false;
+
+};
+
+
+} } // namespace ofx::Time
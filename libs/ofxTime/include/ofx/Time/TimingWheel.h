@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+#include "Poco/Timespan.h"
+#include "Poco/Timestamp.h"
+#include "ofx/Time/Period.h"
+#include "ofx/Time/WorkStealingPool.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A hierarchical timing wheel of one-shot and periodic timers.
+///
+/// Time is divided into ticks of a fixed resolution.  The wheel has eight
+/// levels of 256 slots.  A timer is stored in the slot of the level that
+/// matches the highest tick digit in which its deadline differs from the
+/// current tick, so scheduling and cancelling a timer are O(1).  When the
+/// current tick reaches a slot of a higher level, its timers are moved down
+/// to the lower levels, so each timer is moved at most eight times.
+/// advance() skips directly to the next occupied slot, so idle time costs
+/// nothing.
+///
+/// Timers are kept in a slab and are referred to by a Timer handle that
+/// holds the slab index and a generation count, so a handle to a timer
+/// that has fired or been cancelled is never mistaken for a newer timer.
+///
+/// Timers fire during the first advance() at or after the end of the tick
+/// that contains their deadline, so they fire up to one resolution late
+/// and never early.  The nth deadline of a periodic timer is its first
+/// deadline plus n times its Period using Utils::add(), so calendar fields
+/// such as MONTH are supported and a timer that starts on the 31st of a
+/// month returns to the 31st whenever it can.  Deadlines that were missed
+/// entirely are skipped.
+///
+/// Callbacks run on the thread that calls advance(), or are passed to an
+/// Executor, such as a WorkStealingPool.  They are called without any lock
+/// held, so they may schedule and cancel timers.
+///
+/// \code{.cpp}
+/// ofxTime::WorkStealingPool pool;
+/// ofxTime::TimingWheel wheel(Poco::Timespan(0, 0, 0, 0, 1000));
+/// wheel.setExecutor(pool);
+///
+/// Poco::Timestamp now;
+///
+/// wheel.schedule(ofxTime::Utils::add(now, ofxTime::Period::Minute()),
+///                ofxTime::Period::Minute(),
+///                [](const Poco::Timestamp& deadline) {
+///                    // ...
+///                });
+///
+/// // Typically once per frame.
+/// wheel.advance(Poco::Timestamp());
+/// \endcode
+///
+/// For more information, please see:
+///   - http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf
+class TimingWheel
+{
+public:
+    /// \brief A function called with the deadline of a timer that fired.
+    typedef std::function<void(const Poco::Timestamp& deadline)> Callback;
+
+    /// \brief A function that runs a task, now or later.
+    typedef std::function<void(std::function<void()> task)> Executor;
+
+    /// \brief A handle to a scheduled timer.  0 is never a valid handle.
+    typedef uint64_t Timer;
+
+    /// \brief Create a TimingWheel.
+    /// \param resolution The length of a tick, which must be positive.
+    /// \param start The start of the first tick.
+    TimingWheel(const Poco::Timespan& resolution,
+                const Poco::Timestamp& start = Poco::Timestamp());
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator = (const TimingWheel&) = delete;
+
+    /// \brief Schedule a one-shot timer.
+    /// \param deadline The time at which the timer fires.
+    /// \param callback The function to call.
+    /// \returns the timer handle.
+    Timer schedule(const Poco::Timestamp& deadline, Callback callback);
+
+    /// \brief Schedule a periodic timer.
+    /// \param deadline The time at which the timer first fires.
+    /// \param period The time between deadlines.
+    /// \param callback The function to call.
+    /// \returns the timer handle, or 0 if the period is not positive.
+    Timer schedule(const Poco::Timestamp& deadline,
+                   const Period& period,
+                   Callback callback);
+
+    /// \brief Cancel a timer.
+    ///
+    /// A callback that has already been passed to the executor still runs.
+    ///
+    /// \param timer The timer handle.
+    /// \returns true iff the timer was scheduled.
+    bool cancel(Timer timer);
+
+    /// \returns true iff the timer is scheduled.
+    bool isScheduled(Timer timer) const;
+
+    /// \brief Fire the timers that are due.
+    /// \param now The current time.
+    /// \returns the number of callbacks fired.
+    std::size_t advance(const Poco::Timestamp& now);
+
+    /// \brief Get the next time at which advance() has work to do.
+    ///
+    /// No timer fires before this time, so an event loop can sleep until
+    /// it.  Timers that are far in the future may need to be moved down a
+    /// level before then, so it may be earlier than the next deadline.
+    ///
+    /// \param time The next time.
+    /// \returns false if no timers are scheduled.
+    bool getNextTime(Poco::Timestamp& time) const;
+
+    /// \returns the number of scheduled timers.
+    std::size_t size() const;
+
+    /// \returns the length of a tick.
+    Poco::Timespan getResolution() const;
+
+    /// \brief Set the executor used to run callbacks.
+    /// \param executor The executor, or an empty function to run callbacks
+    ///        on the thread that calls advance().
+    void setExecutor(Executor executor);
+
+    /// \brief Run callbacks on a WorkStealingPool.
+    /// \param pool The pool, which must outlive the TimingWheel.
+    void setExecutor(WorkStealingPool& pool);
+
+private:
+    enum
+    {
+        /// \brief The number of bits of the tick per level.
+        SLOT_BITS = 8,
+        /// \brief The number of slots per level.
+        SLOTS = 1 << SLOT_BITS,
+        /// \brief The number of levels, enough for a 64 bit tick.
+        LEVELS = 64 / SLOT_BITS
+    };
+
+    /// \brief The re-arm state of a periodic timer.
+    struct Repeat
+    {
+        /// \brief The time between deadlines.
+        Period period;
+
+        /// \brief The first deadline in microseconds.
+        Poco::Timestamp::TimeVal first = 0;
+
+        /// \brief The number of periods from first to the current deadline.
+        int64_t count = 0;
+    };
+
+    /// \brief A timer in the slab.
+    struct Entry
+    {
+        /// \brief The tick at which the timer fires.
+        int64_t tick = 0;
+
+        /// \brief The deadline in microseconds.
+        Poco::Timestamp::TimeVal deadline = 0;
+
+        /// \brief The function to call.
+        Callback callback;
+
+        /// \brief The re-arm state of a periodic timer, or nullptr.
+        std::unique_ptr<Repeat> repeat;
+
+        /// \brief Incremented each time the entry is released.
+        uint32_t generation = 0;
+
+        /// \brief The slot holding the timer, level * SLOTS + index, or -1
+        ///        if the entry is free.
+        int32_t slot = -1;
+
+        /// \brief The position of the timer in its slot.
+        int32_t position = 0;
+    };
+
+    /// \brief Add a timer to the slab and the wheel.
+    Timer add(Poco::Timestamp::TimeVal deadline,
+              const Period* period,
+              Callback callback);
+
+    /// \brief Set the deadline of a periodic timer to the first one after
+    ///        a time.
+    /// \returns false if the period does not advance the deadline.
+    static bool rearm(Entry& entry, Poco::Timestamp::TimeVal now);
+
+    /// \returns the first tick whose end is at or after the deadline, but
+    ///          not before the next tick.
+    int64_t getDeadlineTick(Poco::Timestamp::TimeVal deadline) const;
+
+    /// \returns the index of the entry of a handle, or -1.
+    int32_t find(Timer timer) const;
+
+    /// \brief Add an entry to the slot for its tick.
+    void link(int32_t index);
+
+    /// \brief Remove an entry from its slot.
+    void unlink(int32_t index);
+
+    /// \brief Release an entry back to the slab.
+    void release(int32_t index);
+
+    /// \returns the next tick after the current tick with an occupied slot,
+    ///          or limit if there is none before it.
+    int64_t getNextTick(int64_t limit) const;
+
+    /// \brief Protects the wheel.
+    mutable std::mutex _mutex;
+
+    /// \brief The start of tick 0 in microseconds.
+    Poco::Timestamp::TimeVal _origin = 0;
+
+    /// \brief The length of a tick in microseconds.
+    Poco::Timestamp::TimeVal _resolution = 1;
+
+    /// \brief The last tick processed.
+    int64_t _current = 0;
+
+    /// \brief The slab of timers, which never moves an entry as it grows.
+    std::deque<Entry> _entries;
+
+    /// \brief The indices of the free entries.
+    std::vector<int32_t> _free;
+
+    /// \brief The entries in each slot, in no particular order.
+    ///
+    /// An entry is removed from the middle of a slot by moving the last
+    /// entry into its place, so adding an entry touches no other entry.
+    std::vector<std::vector<int32_t>> _slots;
+
+    /// \brief A bit per slot that is set iff the slot is occupied.
+    uint64_t _occupied[LEVELS][SLOTS / 64];
+
+    /// \brief The number of scheduled timers.
+    std::size_t _size = 0;
+
+    /// \brief The executor, or an empty function.
+    Executor _executor;
+
+};
+
+
+} } // namespace ofx::Time
@@ -8,6 +8,7 @@
 #pragma once
 
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cstdlib>
@@ -17,8 +18,13 @@
 #include "Poco/LocalDateTime.h"
 #include "Poco/Timespan.h"
 #include "Poco/Timestamp.h"
+#include "ofx/Time/Calendar.h"
+#include "ofx/Time/InstanceRange.h"
 #include "ofx/Time/Interval.h"
+#include "ofx/Time/LocalInstanceRange.h"
 #include "ofx/Time/Period.h"
+#include "ofx/Time/StaticPeriod.h"
+#include "ofx/Time/TimeZone.h"
 #include "ofLog.h"
 
 
@@ -35,6 +41,11 @@ namespace Time {
 /// rounding.  The UTC equivalent of a Poco::LocalDateTime can then be
 /// extracted using the toUtcTimestamp() or toUtcDateTime() functions.
 ///
+/// Poco::LocalDateTime always uses the process time zone and queries the C
+/// library on each conversion.  The overloads that take a TimeZone instead
+/// round and add in the local time of any zone using its cached transition
+/// table.
+///
 /// Notes:
 ///   - Negative years (years preceding 1 BC) are not supported, thus
 ///     "truncation" (floor toward zero) is not supported.
@@ -53,6 +64,9 @@ public:
     /// Get a fixed number of instances beginning with the "start" time.
     /// Increments are defined by a Period.
     ///
+    /// If the Period is fixed (see Period::isFixed()), the instances are
+    /// computed directly as an arithmetic progression.
+    ///
     /// \param start The starting time.
     /// \param numInstances The number of instances to get.
     /// \param period The instance increment size.
@@ -76,7 +90,8 @@ public:
                                                      const Period& period);
         ///< Get all instances beginning with the "start" time that happen before
         ///< the given "end" time.
-        ///< Increments are defined by a Period.
+        ///< Increments are defined by a Period.  For fixed periods the number
+        ///< of instances is computed up front.
 
     static std::vector<Poco::Timestamp> getInstances(const Interval& Interval,
                                                      const Period& period);
@@ -85,6 +100,221 @@ public:
         ///< Interval's "end" time.  Increments are
         ///< defined by an amount and a DateTimeField.
 
+    /// \brief Write a fixed number of instances to an output iterator.
+    ///
+    /// Equivalent to getInstances(start, numInstances, period), but no
+    /// intermediate std::vector is allocated.
+    ///
+    /// \param start The starting time.
+    /// \param numInstances The number of instances to get.
+    /// \param period The instance increment size.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       std::size_t numInstances,
+                                       const Period& period,
+                                       OutputIterator out);
+
+    /// \brief Write the instances within a Poco::Timespan to an output iterator.
+    /// \param start The starting time.
+    /// \param timespan The duration after start within which instances occur.
+    /// \param period The instance increment size.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       const Poco::Timespan& timespan,
+                                       const Period& period,
+                                       OutputIterator out);
+
+    /// \brief Write the instances before the "end" time to an output iterator.
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       const Poco::Timestamp& end,
+                                       const Period& period,
+                                       OutputIterator out);
+
+    /// \brief Write the instances within an Interval to an output iterator.
+    /// \param interval The Interval to generate instances within.
+    /// \param period The instance increment size.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Interval& interval,
+                                       const Period& period,
+                                       OutputIterator out);
+
+    /// \brief Replace the contents of a vector with the given instances.
+    ///
+    /// The vector is cleared but keeps its capacity, so a single buffer can be
+    /// reused across calls.  Any allocator is supported, including
+    /// std::pmr::polymorphic_allocator.
+    ///
+    /// \param range The instances to store.
+    /// \param results The vector to fill.
+    template <typename Allocator>
+    static void getInstances(const InstanceRange& range,
+                             std::vector<Poco::Timestamp, Allocator>& results);
+
+    /// \brief Get a fixed number of instances stepped in local time.
+    ///
+    /// Each instance is the local time of "start" in the given zone
+    /// advanced by the Period, converted to UTC with the given policies.
+    /// See LocalInstanceRange for details.
+    ///
+    /// \param start The starting time.
+    /// \param numInstances The number of instances to get.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns a vector of time stamps.
+    static std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                                     std::size_t numInstances,
+                                                     const Period& period,
+                                                     const TimeZone& zone,
+                                                     TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                                     TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Get the instances within a Poco::Timespan stepped in local time.
+    /// \param start The starting time.
+    /// \param timespan The duration after start within which instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns a vector of time stamps.
+    static std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                                     const Poco::Timespan& timespan,
+                                                     const Period& period,
+                                                     const TimeZone& zone,
+                                                     TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                                     TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Get the instances before the "end" time stepped in local time.
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns a vector of time stamps.
+    static std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                                     const Poco::Timestamp& end,
+                                                     const Period& period,
+                                                     const TimeZone& zone,
+                                                     TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                                     TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Get the instances within an Interval stepped in local time.
+    /// \param interval The Interval to generate instances within.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns a vector of time stamps.
+    static std::vector<Poco::Timestamp> getInstances(const Interval& interval,
+                                                     const Period& period,
+                                                     const TimeZone& zone,
+                                                     TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                                     TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Write a fixed number of instances stepped in local time to an
+    ///        output iterator.
+    ///
+    /// Equivalent to getInstances(start, numInstances, period, zone), but no
+    /// intermediate std::vector is allocated.
+    ///
+    /// \param start The starting time.
+    /// \param numInstances The number of instances to get.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       std::size_t numInstances,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       OutputIterator out,
+                                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Write the instances within a Poco::Timespan stepped in local
+    ///        time to an output iterator.
+    /// \param start The starting time.
+    /// \param timespan The duration after start within which instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       const Poco::Timespan& timespan,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       OutputIterator out,
+                                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Write the instances before the "end" time stepped in local
+    ///        time to an output iterator.
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Poco::Timestamp& start,
+                                       const Poco::Timestamp& end,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       OutputIterator out,
+                                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Write the instances within an Interval stepped in local time
+    ///        to an output iterator.
+    /// \param interval The Interval to generate instances within.
+    /// \param period The instance increment size in local time.
+    /// \param zone The time zone.
+    /// \param out The output iterator that receives each Poco::Timestamp.
+    /// \param nonexistent The policy for local times that never occur.
+    /// \param ambiguous The policy for local times that occur twice.
+    /// \returns the output iterator one past the last instance written.
+    template <typename OutputIterator>
+    static OutputIterator getInstances(const Interval& interval,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       OutputIterator out,
+                                       TimeZone::NonexistentPolicy nonexistent = TimeZone::NONEXISTENT_SHIFT_FORWARD,
+                                       TimeZone::AmbiguousPolicy ambiguous = TimeZone::AMBIGUOUS_EARLIER);
+
+    /// \brief Replace the contents of a vector with the given local time
+    ///        instances.
+    ///
+    /// The vector is cleared but keeps its capacity, so a single buffer can be
+    /// reused across calls.
+    ///
+    /// \param range The instances to store.
+    /// \param results The vector to fill.
+    template <typename Allocator>
+    static void getInstances(const LocalInstanceRange& range,
+                             std::vector<Poco::Timestamp, Allocator>& results);
+
     static Poco::Timestamp toUtcTimestamp(const Poco::LocalDateTime& localDateTime);
         ///< Converts a Poco::LocalDateTime to
         ///< its UTC Poco::Timestamp equivalent.
@@ -99,10 +329,23 @@ public:
     static Poco::DateTime add(const Poco::DateTime& time,
                               const Period& period);
         ///< Add an arbitrary period to the given Poco::DateTime.
+        ///< YEAR and MONTH fields are added first using calendar arithmetic
+        ///< (see Calendar::addYears() and Calendar::addMonths()), followed by
+        ///< the fixed-length fields.
 
     static Poco::Timestamp add(const Poco::Timestamp& time,
                                const Period& period);
         ///< Add an arbitrary period to the given Poco::Timestamp.
+        ///< This operates directly on epoch microseconds and does not
+        ///< construct any Poco::DateTime objects.
+
+    static Poco::Timestamp add(const Poco::Timestamp& time,
+                               const Period& period,
+                               const TimeZone& zone);
+        ///< Add an arbitrary period to the given Poco::Timestamp.
+        ///< YEAR and MONTH fields are added to the local time in the given
+        ///< zone, so that the local time of day is preserved, followed by
+        ///< the fixed-length fields.
 
     static Poco::LocalDateTime addMicroseconds(const Poco::LocalDateTime& time,
                                                int64_t amount);
@@ -275,6 +518,83 @@ public:
                                  const Poco::Timespan& timespan);
         ///< Rounds a Poco::Timestamp down based on a given Poco::Timespan.
 
+    static Poco::Timestamp round(const Poco::Timestamp& timestamp,
+                                 const Poco::Timespan& timespan,
+                                 const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp based on a given Poco::Timespan in the
+        ///< local time of the given zone.  The result is converted back to
+        ///< UTC as for round(const Poco::Timestamp&, Period::Field,
+        ///< const TimeZone&).
+
+    static Poco::Timestamp ceiling(const Poco::Timestamp& timestamp,
+                                   const Poco::Timespan& timespan,
+                                   const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp up based on a given Poco::Timespan in
+        ///< the local time of the given zone.  The result is converted back
+        ///< to UTC as for round(const Poco::Timestamp&, Period::Field,
+        ///< const TimeZone&).
+
+    static Poco::Timestamp floor(const Poco::Timestamp& timestamp,
+                                 const Poco::Timespan& timespan,
+                                 const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp down based on a given Poco::Timespan in
+        ///< the local time of the given zone.  The result is converted back
+        ///< to UTC as for round(const Poco::Timestamp&, Period::Field,
+        ///< const TimeZone&).
+
+    /// \brief Round an array of timestamps based on a given Poco::Timespan.
+    ///
+    /// Each result is bit-identical to round(const Poco::Timestamp&,
+    /// const Poco::Timespan&).  The divisor is converted to a multiply-shift
+    /// reciprocal once per call and AVX2 or AVX-512 is used when available.
+    ///
+    /// \param timestamps The input timestamps in epoch microseconds.
+    /// \param results The output array, which may be the input array.
+    /// \param size The number of timestamps.
+    /// \param timespan The timespan to round to.
+    static void round(const int64_t* timestamps,
+                      int64_t* results,
+                      std::size_t size,
+                      const Poco::Timespan& timespan);
+
+    /// \brief Round an array of timestamps up based on a given Poco::Timespan.
+    /// \param timestamps The input timestamps in epoch microseconds.
+    /// \param results The output array, which may be the input array.
+    /// \param size The number of timestamps.
+    /// \param timespan The timespan to round to.
+    /// \sa round(const int64_t*, int64_t*, std::size_t, const Poco::Timespan&)
+    static void ceiling(const int64_t* timestamps,
+                        int64_t* results,
+                        std::size_t size,
+                        const Poco::Timespan& timespan);
+
+    /// \brief Round an array of timestamps down based on a given Poco::Timespan.
+    /// \param timestamps The input timestamps in epoch microseconds.
+    /// \param results The output array, which may be the input array.
+    /// \param size The number of timestamps.
+    /// \param timespan The timespan to round to.
+    /// \sa round(const int64_t*, int64_t*, std::size_t, const Poco::Timespan&)
+    static void floor(const int64_t* timestamps,
+                      int64_t* results,
+                      std::size_t size,
+                      const Poco::Timespan& timespan);
+
+    /// \brief Extract a calendar field from an array of timestamps.
+    ///
+    /// Each result is equal to the matching Poco::DateTime accessor (e.g.
+    /// Poco::DateTime::hour()) in UTC, but no Poco::DateTime is constructed.
+    /// The timestamps are processed in chunks on the stack with vectorised
+    /// integer calendar math, so nothing is allocated or locked.
+    ///
+    /// \param timestamps The input timestamps in epoch microseconds.
+    /// \param results The output field values.
+    /// \param size The number of timestamps.
+    /// \param field The field to extract.
+    static void extractFields(const int64_t* timestamps,
+                              int32_t* results,
+                              std::size_t size,
+                              Calendar::Field field);
+
     static Poco::LocalDateTime round(const Poco::LocalDateTime& localDateTime,
                                      Period::Field field);
         ///< Rounds a Poco::LocalDateTime based on a given DateTimeField.
@@ -302,14 +622,119 @@ public:
     static Poco::Timestamp round(const Poco::Timestamp& timestamp,
                                  Period::Field field);
         ///< Rounds a Poco::Timestamp based on a given DateTimeField.
+        ///< MONTH and YEAR round to the nearest exact calendar month or
+        ///< year start (see Calendar::roundMonth()).  Times halfway between
+        ///< two boundaries are rounded up.
 
     static Poco::Timestamp ceiling(const Poco::Timestamp& timestamp,
                                    Period::Field field);
         ///< Rounds a Poco::Timestamp up based on a given DateTimeField.
+        ///< MONTH and YEAR round up to the first microsecond of the next
+        ///< calendar month or year.
 
     static Poco::Timestamp floor(const Poco::Timestamp& timestamp,
                                  Period::Field field);
         ///< Rounds a Poco::Timestamp down based on a given DateTimeField.
+        ///< MONTH and YEAR round down to the first microsecond of the
+        ///< calendar month or year.
+
+    static Poco::Timestamp round(const Poco::Timestamp& timestamp,
+                                 Period::Field field,
+                                 const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp in the local time of the given zone.
+        ///< The result keeps the offset of the given time if that offset
+        ///< is valid at the result, so that rounding in a repeated hour
+        ///< stays in the same pass of that hour.  Otherwise the result is
+        ///< converted back to UTC with TimeZone::toUtc().
+
+    static Poco::Timestamp ceiling(const Poco::Timestamp& timestamp,
+                                   Period::Field field,
+                                   const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp up in the local time of the given zone.
+        ///< The result keeps the offset of the given time if that offset
+        ///< is valid at the result, so that rounding in a repeated hour
+        ///< stays in the same pass of that hour.  Otherwise the result is
+        ///< converted back to UTC with TimeZone::toUtc().
+
+    static Poco::Timestamp floor(const Poco::Timestamp& timestamp,
+                                 Period::Field field,
+                                 const TimeZone& zone);
+        ///< Rounds a Poco::Timestamp down in the local time of the given
+        ///< zone (e.g. to local midnight for DAY).
+        ///< The result keeps the offset of the given time if that offset
+        ///< is valid at the result, so that rounding in a repeated hour
+        ///< stays in the same pass of that hour.  Otherwise the result is
+        ///< converted back to UTC with TimeZone::toUtc().
+
+    /// \brief Get a fixed number of instances of a StaticPeriod.
+    /// \param start The starting time.
+    /// \param numInstances The number of instances to get.
+    /// \param period The instance increment size.
+    /// \returns a vector of time stamps.
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                                     std::size_t numInstances,
+                                                     StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Get all instances of a StaticPeriod before the "end" time.
+    /// \param start The starting time.
+    /// \param end The time before which all instances occur.
+    /// \param period The instance increment size.
+    /// \returns a vector of time stamps.
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static std::vector<Poco::Timestamp> getInstances(const Poco::Timestamp& start,
+                                                     const Poco::Timestamp& end,
+                                                     StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Add a StaticPeriod to the given Poco::Timestamp.
+    ///
+    /// Fixed fields compile to a single constant add.
+    ///
+    /// \param time The time to add to.
+    /// \param period The period to add.
+    /// \returns the resulting time.
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static Poco::Timestamp add(const Poco::Timestamp& time,
+                               StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Add a StaticPeriod to the given Poco::DateTime.
+    /// \param time The time to add to.
+    /// \param period The period to add.
+    /// \returns the resulting time.
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static Poco::DateTime add(const Poco::DateTime& time,
+                              StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Rounds a Poco::Timestamp based on a StaticPeriod.
+    ///
+    /// Fixed fields round to a multiple of the period length using a
+    /// constant divisor.  MONTH and YEAR periods must have an amount of 1
+    /// and are equivalent to round(timestamp, field).
+    ///
+    /// \param timestamp The time to round.
+    /// \param period The period to round to.
+    /// \returns the rounded time.
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static Poco::Timestamp round(const Poco::Timestamp& timestamp,
+                                 StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Rounds a Poco::Timestamp up based on a StaticPeriod.
+    /// \param timestamp The time to round.
+    /// \param period The period to round to.
+    /// \returns the rounded time.
+    /// \sa round(const Poco::Timestamp&, StaticPeriod<FIELD, AMOUNT>)
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static Poco::Timestamp ceiling(const Poco::Timestamp& timestamp,
+                                   StaticPeriod<FIELD, AMOUNT> period);
+
+    /// \brief Rounds a Poco::Timestamp down based on a StaticPeriod.
+    /// \param timestamp The time to round.
+    /// \param period The period to round to.
+    /// \returns the rounded time.
+    /// \sa round(const Poco::Timestamp&, StaticPeriod<FIELD, AMOUNT>)
+    template <Period::Field FIELD, int64_t AMOUNT>
+    static Poco::Timestamp floor(const Poco::Timestamp& timestamp,
+                                 StaticPeriod<FIELD, AMOUNT> period);
 
     static int countLeapDaysBetweenYears(int64_t startYear, int64_t endYear);
         ///< Counts the number of leap days between two years.
@@ -344,6 +769,246 @@ public:
 };
 
 
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   std::size_t numInstances,
+                                   const Period& period,
+                                   OutputIterator out)
+{
+    InstanceRange range(start, numInstances, period);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   const Poco::Timespan& timespan,
+                                   const Period& period,
+                                   OutputIterator out)
+{
+    InstanceRange range(start, timespan, period);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   const Poco::Timestamp& end,
+                                   const Period& period,
+                                   OutputIterator out)
+{
+    InstanceRange range(start, end, period);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Interval& interval,
+                                   const Period& period,
+                                   OutputIterator out)
+{
+    InstanceRange range(interval, period);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   std::size_t numInstances,
+                                   const Period& period,
+                                   const TimeZone& zone,
+                                   OutputIterator out,
+                                   TimeZone::NonexistentPolicy nonexistent,
+                                   TimeZone::AmbiguousPolicy ambiguous)
+{
+    LocalInstanceRange range(start, numInstances, period, zone, nonexistent, ambiguous);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   const Poco::Timespan& timespan,
+                                   const Period& period,
+                                   const TimeZone& zone,
+                                   OutputIterator out,
+                                   TimeZone::NonexistentPolicy nonexistent,
+                                   TimeZone::AmbiguousPolicy ambiguous)
+{
+    LocalInstanceRange range(start, timespan, period, zone, nonexistent, ambiguous);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Poco::Timestamp& start,
+                                   const Poco::Timestamp& end,
+                                   const Period& period,
+                                   const TimeZone& zone,
+                                   OutputIterator out,
+                                   TimeZone::NonexistentPolicy nonexistent,
+                                   TimeZone::AmbiguousPolicy ambiguous)
+{
+    LocalInstanceRange range(start, end, period, zone, nonexistent, ambiguous);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename OutputIterator>
+OutputIterator Utils::getInstances(const Interval& interval,
+                                   const Period& period,
+                                   const TimeZone& zone,
+                                   OutputIterator out,
+                                   TimeZone::NonexistentPolicy nonexistent,
+                                   TimeZone::AmbiguousPolicy ambiguous)
+{
+    LocalInstanceRange range(interval, period, zone, nonexistent, ambiguous);
+    return std::copy(range.begin(), range.end(), out);
+}
+
+
+template <typename Allocator>
+void Utils::getInstances(const InstanceRange& range,
+                         std::vector<Poco::Timestamp, Allocator>& results)
+{
+    results.clear();
+
+    if (range.getPeriod().isFixed())
+    {
+        results.reserve(range.size());
+    }
+
+    for (const Poco::Timestamp& t: range)
+    {
+        results.push_back(t);
+    }
+}
+
+
+template <typename Allocator>
+void Utils::getInstances(const LocalInstanceRange& range,
+                         std::vector<Poco::Timestamp, Allocator>& results)
+{
+    results.clear();
+
+    for (const Poco::Timestamp& t: range)
+    {
+        results.push_back(t);
+    }
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
+                                                 std::size_t numInstances,
+                                                 StaticPeriod<FIELD, AMOUNT>)
+{
+    typedef StaticPeriod<FIELD, AMOUNT> Step;
+
+    std::vector<Poco::Timestamp> results;
+    results.reserve(numInstances);
+
+    Poco::Timestamp::TimeVal t = start.epochMicroseconds();
+
+    for (std::size_t i = 0; i < numInstances; ++i)
+    {
+        results.push_back(Poco::Timestamp(t));
+        t = Step::add(t);
+    }
+
+    return results;
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
+                                                 const Poco::Timestamp& end,
+                                                 StaticPeriod<FIELD, AMOUNT> period)
+{
+    typedef StaticPeriod<FIELD, AMOUNT> Step;
+
+    static_assert(AMOUNT > 0, "The period must be positive.");
+
+    if (Step::IS_FIXED)
+    {
+        std::size_t numInstances = 0;
+
+        if (end > start)
+        {
+            numInstances = std::size_t((end - start - 1) / Step::MICROSECONDS + 1);
+        }
+
+        return getInstances(start, numInstances, period);
+    }
+
+    std::vector<Poco::Timestamp> results;
+
+    for (Poco::Timestamp::TimeVal t = start.epochMicroseconds();
+         t < end.epochMicroseconds();
+         t = Step::add(t))
+    {
+        results.push_back(Poco::Timestamp(t));
+    }
+
+    return results;
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+Poco::Timestamp Utils::add(const Poco::Timestamp& time,
+                           StaticPeriod<FIELD, AMOUNT>)
+{
+    return StaticPeriod<FIELD, AMOUNT>::add(time.epochMicroseconds());
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+Poco::DateTime Utils::add(const Poco::DateTime& time,
+                          StaticPeriod<FIELD, AMOUNT> period)
+{
+    return add(time.timestamp(), period);
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
+                             StaticPeriod<FIELD, AMOUNT>)
+{
+    typedef StaticPeriod<FIELD, AMOUNT> Step;
+
+    static_assert(Step::IS_FIXED || AMOUNT == 1,
+                  "Calendar periods can only be rounded to a single unit.");
+
+    return Step::round(timestamp.epochMicroseconds());
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
+                               StaticPeriod<FIELD, AMOUNT>)
+{
+    typedef StaticPeriod<FIELD, AMOUNT> Step;
+
+    static_assert(Step::IS_FIXED || AMOUNT == 1,
+                  "Calendar periods can only be rounded to a single unit.");
+
+    return Step::ceiling(timestamp.epochMicroseconds());
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
+                             StaticPeriod<FIELD, AMOUNT>)
+{
+    typedef StaticPeriod<FIELD, AMOUNT> Step;
+
+    static_assert(Step::IS_FIXED || AMOUNT == 1,
+                  "Calendar periods can only be rounded to a single unit.");
+
+    return Step::floor(timestamp.epochMicroseconds());
+}
+
+
 inline Poco::Timestamp& operator += (Poco::Timestamp& timestamp,
                                      const Period& period)
 {
@@ -374,6 +1039,23 @@ inline Poco::Timestamp operator + (const Poco::Timestamp& timestamp,
 }
 
 
+template <Period::Field FIELD, int64_t AMOUNT>
+inline Poco::Timestamp operator + (const Poco::Timestamp& timestamp,
+                                   StaticPeriod<FIELD, AMOUNT> period)
+{
+    return Utils::add(timestamp, period);
+}
+
+
+template <Period::Field FIELD, int64_t AMOUNT>
+inline Poco::Timestamp& operator += (Poco::Timestamp& timestamp,
+                                     StaticPeriod<FIELD, AMOUNT> period)
+{
+    timestamp = Utils::add(timestamp, period);
+    return timestamp;
+}
+
+
 inline Poco::DateTime operator + (const Poco::DateTime& dateTime,
                                   const Period& period)
 {
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A fixed size pool of threads that steal work from each other.
+///
+/// Each thread has its own queue of tasks.  Tasks submitted by a pool
+/// thread go to the back of its own queue and are run from the back, so
+/// related tasks stay on the same thread.  Tasks submitted by other
+/// threads are spread over the queues in turn.  A thread whose queue is
+/// empty takes tasks from the front of the other queues before it sleeps.
+///
+/// \code{.cpp}
+/// ofxTime::WorkStealingPool pool;
+///
+/// pool.submit([]() {
+///     // ...
+/// });
+/// \endcode
+///
+/// \note The destructor runs every task that has already been submitted
+/// before it joins the threads.
+class WorkStealingPool
+{
+public:
+    /// \brief A unit of work.
+    typedef std::function<void()> Task;
+
+    /// \brief Create a WorkStealingPool.
+    /// \param numThreads The number of threads, or 0 for one per hardware
+    ///        thread.
+    WorkStealingPool(std::size_t numThreads = 0);
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator = (const WorkStealingPool&) = delete;
+
+    /// \brief Run the remaining tasks and join the threads.
+    ~WorkStealingPool();
+
+    /// \brief Queue a task to run on one of the pool threads.
+    /// \param task The task.
+    void submit(Task task);
+
+    /// \returns the number of threads.
+    std::size_t getNumThreads() const;
+
+private:
+    /// \brief The queue and thread of one worker.
+    struct Worker
+    {
+        /// \brief Protects tasks.
+        std::mutex mutex;
+
+        /// \brief The queued tasks.
+        std::deque<Task> tasks;
+
+        /// \brief The thread.
+        std::thread thread;
+    };
+
+    /// \brief The loop run by each worker thread.
+    void run(std::size_t index);
+
+    /// \brief Take a task from a worker's own queue, or steal one.
+    /// \returns false if all of the queues are empty.
+    bool pop(std::size_t index, Task& task);
+
+    /// \brief The workers.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    /// \brief The number of queued tasks.
+    std::atomic<std::size_t> _pending;
+
+    /// \brief The next queue for tasks from outside the pool.
+    std::atomic<std::size_t> _next;
+
+    /// \brief True when the pool is being destroyed.
+    bool _isStopping = false;
+
+    /// \brief Protects _isStopping and the sleeping workers.
+    std::mutex _mutex;
+
+    /// \brief Signaled when a task is queued or the pool stops.
+    std::condition_variable _condition;
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,53 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Locale independent ASCII character classes.
+///
+/// These are equivalent to Poco::Ascii, but each test is a compare or two
+/// rather than a table lookup, so they can be inlined into the parsers.
+class Ascii
+{
+public:
+    /// \returns true iff the character is a decimal digit.
+    static bool isDigit(char c)
+    {
+        return unsigned(c - '0') < 10;
+    }
+
+    /// \returns true iff the character is an ASCII letter.
+    static bool isAlpha(char c)
+    {
+        return unsigned((c | 0x20) - 'a') < 26;
+    }
+
+    /// \returns true iff the character is a space, tab, line feed,
+    ///          vertical tab, form feed or carriage return.
+    static bool isSpace(char c)
+    {
+        return c == ' ' || unsigned(c - '\t') < 5;
+    }
+
+    /// \returns true iff the character is ASCII punctuation.
+    static bool isPunct(char c)
+    {
+        return (c >= '!' && c <= '/')
+            || (c >= ':' && c <= '@')
+            || (c >= '[' && c <= '`')
+            || (c >= '{' && c <= '~');
+    }
+
+};
+
+
+} } // namespace ofx::Time
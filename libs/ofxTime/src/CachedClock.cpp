@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/CachedClock.h"
+#include <chrono>
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+CachedClock::CachedClock(Clock::Source source,
+                         std::shared_ptr<const TimeZone> zone):
+    _clock(source),
+    _zone(zone ? zone : TimeZone::utc()),
+    _utc(0)
+{
+    update();
+}
+
+
+CachedClock::~CachedClock()
+{
+    stop();
+}
+
+
+void CachedClock::update()
+{
+    if (_clock.getSource() == Clock::TSC)
+    {
+        Clock::calibrate();
+    }
+
+    const int64_t utc = _clock.getMicroseconds();
+    const int64_t local = _zone->toLocal(utc);
+
+    LocalTime localTime;
+    localTime.microseconds = local;
+    localTime.offset = (local - utc) / 1000000;
+
+    _local.store(localTime);
+    _utc.store(utc, std::memory_order_relaxed);
+}
+
+
+void CachedClock::start(const Poco::Timespan& interval)
+{
+    if (interval.totalMicroseconds() <= 0)
+    {
+        ofLogError("CachedClock::start") << "The interval must be positive.";
+        return;
+    }
+
+    stop();
+
+    _isStopping = false;
+    _thread = std::thread(&CachedClock::run, this, interval.totalMicroseconds());
+}
+
+
+void CachedClock::stop()
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+
+    _condition.notify_one();
+    _thread.join();
+}
+
+
+int64_t CachedClock::getMicroseconds() const
+{
+    return _utc.load(std::memory_order_relaxed);
+}
+
+
+Poco::Timestamp CachedClock::now() const
+{
+    return Poco::Timestamp(_utc.load(std::memory_order_relaxed));
+}
+
+
+int64_t CachedClock::getLocalMicroseconds() const
+{
+    return _local.load().microseconds;
+}
+
+
+Poco::LocalDateTime CachedClock::getLocalDateTime() const
+{
+    const LocalTime local = _local.load();
+
+    return Poco::LocalDateTime(int(local.offset),
+                               Poco::DateTime(Poco::Timestamp(local.microseconds)),
+                               false);
+}
+
+
+const TimeZone& CachedClock::getTimeZone() const
+{
+    return *_zone;
+}
+
+
+void CachedClock::run(Poco::Timespan::TimeDiff interval)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_isStopping)
+    {
+        update();
+
+        _condition.wait_for(lock, std::chrono::microseconds(interval), [this]() {
+            return _isStopping;
+        });
+    }
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,231 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/CalendarTable.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief The first microsecond covered by the table.
+constexpr int64_t TABLE_START = Calendar::daysFromCivil(CalendarTable::FIRST_YEAR, 1, 1) * Calendar::MICROSECONDS_PER_DAY;
+
+/// \brief The first microsecond after the table.
+constexpr int64_t TABLE_END = Calendar::daysFromCivil(CalendarTable::LAST_YEAR + 1, 1, 1) * Calendar::MICROSECONDS_PER_DAY;
+
+/// \brief The mean Gregorian month, 146097 days / 4800 months.
+///
+/// Month starts never drift more than a few days from a multiple of the mean
+/// month, so dividing by it lands within one entry of the right month.
+constexpr int64_t MEAN_MONTH_MICROSECONDS = INT64_C(2629746000000);
+
+
+struct Table
+{
+    Table()
+    {
+        for (int i = 0; i <= CalendarTable::NUM_MONTHS; ++i)
+        {
+            starts[i] = Calendar::daysFromCivil(CalendarTable::FIRST_YEAR + i / 12, i % 12 + 1, 1) * Calendar::MICROSECONDS_PER_DAY;
+        }
+    }
+
+    /// \brief The month starts, with one extra entry for the end of the span.
+    alignas(64) int64_t starts[CalendarTable::NUM_MONTHS + 1];
+};
+
+
+/// \returns the month starts, building the table on first use.
+const int64_t* starts()
+{
+    static const Table table;
+    return table.starts;
+}
+
+
+/// \returns the index of the month containing a time within the table.
+inline int monthIndex(const int64_t* starts, int64_t microseconds)
+{
+    int i = int((microseconds - TABLE_START) / MEAN_MONTH_MICROSECONDS);
+    i = i < CalendarTable::NUM_MONTHS ? i : CalendarTable::NUM_MONTHS - 1;
+    i -= microseconds < starts[i];
+    i += microseconds >= starts[i + 1];
+    return i;
+}
+
+
+} // namespace
+
+
+bool CalendarTable::contains(int64_t microseconds)
+{
+    return microseconds >= TABLE_START && microseconds < TABLE_END;
+}
+
+
+int64_t CalendarTable::monthStart(int64_t year, int month)
+{
+    if (year >= FIRST_YEAR && year <= LAST_YEAR && month >= 1 && month <= 12)
+    {
+        return starts()[(year - FIRST_YEAR) * 12 + month - 1];
+    }
+
+    return Calendar::daysFromCivil(year, month, 1) * Calendar::MICROSECONDS_PER_DAY;
+}
+
+
+int64_t CalendarTable::yearStart(int64_t year)
+{
+    return monthStart(year, 1);
+}
+
+
+int64_t CalendarTable::floorMonth(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::floorMonth(microseconds);
+    }
+
+    const int64_t* table = starts();
+    return table[monthIndex(table, microseconds)];
+}
+
+
+int64_t CalendarTable::floorYear(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::floorYear(microseconds);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    return table[i - i % 12];
+}
+
+
+int64_t CalendarTable::ceilingMonth(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::ceilingMonth(microseconds);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    return table[i] == microseconds ? microseconds : table[i + 1];
+}
+
+
+int64_t CalendarTable::ceilingYear(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::ceilingYear(microseconds);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    i -= i % 12;
+    return table[i] == microseconds ? microseconds : table[i + 12];
+}
+
+
+int64_t CalendarTable::roundMonth(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::roundMonth(microseconds);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    return (microseconds - table[i]) < (table[i + 1] - microseconds) ? table[i] : table[i + 1];
+}
+
+
+int64_t CalendarTable::roundYear(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::roundYear(microseconds);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    i -= i % 12;
+    return (microseconds - table[i]) < (table[i + 12] - microseconds) ? table[i] : table[i + 12];
+}
+
+
+int64_t CalendarTable::addMonths(int64_t microseconds, int64_t months)
+{
+    if (!contains(microseconds) || months <= -NUM_MONTHS || months >= NUM_MONTHS)
+    {
+        return Calendar::addMonths(microseconds, months);
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    int64_t j = i + months;
+
+    if (j < 0 || j >= NUM_MONTHS)
+    {
+        return Calendar::addMonths(microseconds, months);
+    }
+
+    // Clamp the day of the month, keeping the time of day.
+    int64_t offset = microseconds - table[i];
+    int64_t length = table[j + 1] - table[j];
+
+    if (offset >= length)
+    {
+        offset = length - Calendar::MICROSECONDS_PER_DAY + offset % Calendar::MICROSECONDS_PER_DAY;
+    }
+
+    return table[j] + offset;
+}
+
+
+int64_t CalendarTable::addYears(int64_t microseconds, int64_t years)
+{
+    if (years <= -(NUM_MONTHS / 12) || years >= NUM_MONTHS / 12)
+    {
+        return Calendar::addYears(microseconds, years);
+    }
+
+    return addMonths(microseconds, years * 12);
+}
+
+
+Calendar::Date CalendarTable::date(int64_t microseconds)
+{
+    if (!contains(microseconds))
+    {
+        return Calendar::civilFromDays(Calendar::floorDivide(microseconds, Calendar::MICROSECONDS_PER_DAY));
+    }
+
+    const int64_t* table = starts();
+    int i = monthIndex(table, microseconds);
+    return Calendar::Date{ FIRST_YEAR + i / 12,
+                           i % 12 + 1,
+                           int((microseconds - table[i]) / Calendar::MICROSECONDS_PER_DAY) + 1 };
+}
+
+
+std::size_t CalendarTable::memorySize()
+{
+    return sizeof(Table);
+}
+
+
+} } // namespace ofx::Time
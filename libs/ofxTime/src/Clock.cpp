@@ -0,0 +1,411 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/Clock.h"
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "ofx/Time/SeqLock.h"
+
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define OFX_TIME_HAVE_TSC 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+        #include <x86intrin.h>
+    #endif
+#endif
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+#if defined(_WIN32)
+
+
+/// \returns a Windows FILETIME in microseconds since the epoch.
+inline int64_t toMicroseconds(const FILETIME& time)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+
+    // FILETIME counts 100 ns intervals since 1601-01-01.
+    return int64_t(value.QuadPart / 10) - INT64_C(11644473600000000);
+}
+
+
+#else
+
+
+/// \returns a POSIX clock in microseconds.
+inline int64_t getClockMicroseconds(clockid_t clock)
+{
+    timespec time;
+    clock_gettime(clock, &time);
+    return int64_t(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+}
+
+
+#endif
+
+
+/// \returns the precise real time in microseconds since the epoch.
+inline int64_t getRealtime()
+{
+#if defined(_WIN32)
+    FILETIME time;
+    GetSystemTimePreciseAsFileTime(&time);
+    return toMicroseconds(time);
+#else
+    return getClockMicroseconds(CLOCK_REALTIME);
+#endif
+}
+
+
+#if defined(OFX_TIME_HAVE_TSC)
+
+
+/// \returns the precise real time in nanoseconds since the epoch.
+inline int64_t getRealtimeNanoseconds()
+{
+#if defined(_WIN32)
+    FILETIME time;
+    GetSystemTimePreciseAsFileTime(&time);
+
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+
+    return (int64_t(value.QuadPart) - INT64_C(116444736000000000)) * 100;
+#else
+    timespec time;
+    clock_gettime(CLOCK_REALTIME, &time);
+    return int64_t(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+}
+
+
+/// \returns true iff the CPU has a time stamp counter that runs at a
+///          constant rate in every power state.
+bool hasInvariantTSC()
+{
+#if defined(_MSC_VER)
+    int registers[4] = { 0, 0, 0, 0 };
+    __cpuid(registers, 0x80000000);
+
+    if (unsigned(registers[0]) < 0x80000007)
+    {
+        return false;
+    }
+
+    __cpuid(registers, 0x80000007);
+    return 0 != (registers[3] & (1 << 8));
+#else
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+
+    if (0 == __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+
+    return 0 != (edx & (1 << 8));
+#endif
+}
+
+
+/// \brief A reading of the time stamp counter and the real time.
+struct Sample
+{
+    /// \brief The counter.
+    uint64_t ticks = 0;
+
+    /// \brief The real time in nanoseconds.
+    int64_t nanoseconds = 0;
+};
+
+
+/// \returns a reading in which the counter is taken next to the real time.
+Sample getSample()
+{
+    // The counter is read on both sides of the real time and the reading
+    // with the shortest gap is kept.  The first, cold read of the clock and
+    // any preemption give long gaps, so they are never kept.
+    Sample sample;
+    uint64_t shortest = std::numeric_limits<uint64_t>::max();
+
+    for (int i = 0; i < 8; ++i)
+    {
+        const uint64_t before = __rdtsc();
+        const int64_t nanoseconds = getRealtimeNanoseconds();
+        const uint64_t after = __rdtsc();
+
+        if (after >= before && after - before < shortest)
+        {
+            shortest = after - before;
+            sample.ticks = before + (after - before) / 2;
+            sample.nanoseconds = nanoseconds;
+        }
+    }
+
+    return sample;
+}
+
+
+/// \brief The relationship between the time stamp counter and real time.
+struct Calibration
+{
+    /// \brief The counter at the last fit.
+    uint64_t ticks = 0;
+
+    /// \brief The real time at the last fit in nanoseconds.
+    int64_t nanoseconds = 0;
+
+    /// \brief The number of nanoseconds per tick.
+    double nanosecondsPerTick = 0;
+};
+
+
+/// \brief Fits the time stamp counter to the real time.
+///
+/// The rate is measured from the first reading to the latest one, so it
+/// becomes more precise the longer the program runs.  Each fit also moves
+/// the origin to the latest reading, so the counter follows adjustments of
+/// the real time clock.
+class Calibrator
+{
+public:
+    Calibrator()
+    {
+        if (!hasInvariantTSC())
+        {
+            return;
+        }
+
+        // The first fit measures over 10 ms.  Each reading is good to
+        // about 100 ns, which puts the rate within about 10 parts per
+        // million of the real time rate.
+        _first = getSample();
+
+        Sample last = getSample();
+
+        while (last.nanoseconds - _first.nanoseconds < 10000000)
+        {
+            last = getSample();
+        }
+
+        if (last.ticks <= _first.ticks)
+        {
+            return;
+        }
+
+        Calibration calibration;
+        calibration.ticks = last.ticks;
+        calibration.nanoseconds = last.nanoseconds;
+        calibration.nanosecondsPerTick = double(last.nanoseconds - _first.nanoseconds)
+                                       / double(last.ticks - _first.ticks);
+
+        _calibration.store(calibration);
+        _isAvailable = true;
+    }
+
+    /// \returns true iff the time stamp counter can be used.
+    bool isAvailable() const
+    {
+        return _isAvailable;
+    }
+
+    /// \returns the time stamp counter in microseconds since the epoch.
+    int64_t getMicroseconds() const
+    {
+        const Calibration calibration = _calibration.load();
+        const int64_t ticks = int64_t(__rdtsc() - calibration.ticks);
+        return (calibration.nanoseconds + int64_t(double(ticks) * calibration.nanosecondsPerTick)) / 1000;
+    }
+
+    /// \brief Fit the counter to the real time, at most once per second.
+    void calibrate()
+    {
+        if (!_isAvailable)
+        {
+            return;
+        }
+
+        Calibration calibration = _calibration.load();
+
+        if (double(__rdtsc() - calibration.ticks) * calibration.nanosecondsPerTick < 1000000000.0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const Sample sample = getSample();
+
+        if (sample.ticks <= _first.ticks)
+        {
+            return;
+        }
+
+        const double nanosecondsPerTick = double(sample.nanoseconds - _first.nanoseconds)
+                                        / double(sample.ticks - _first.ticks);
+
+        // A rate more than 0.1% from the last one means that the real time
+        // clock was set, so the measurement starts again from here.
+        if (std::abs(nanosecondsPerTick / calibration.nanosecondsPerTick - 1) < 0.001)
+        {
+            calibration.nanosecondsPerTick = nanosecondsPerTick;
+        }
+        else
+        {
+            _first = sample;
+        }
+
+        calibration.ticks = sample.ticks;
+        calibration.nanoseconds = sample.nanoseconds;
+        _calibration.store(calibration);
+    }
+
+private:
+    /// \brief True iff the time stamp counter can be used.
+    bool _isAvailable = false;
+
+    /// \brief The reading that the rate is measured from.
+    Sample _first;
+
+    /// \brief The current fit.
+    SeqLock<Calibration> _calibration;
+
+    /// \brief Serializes calibrate().
+    std::mutex _mutex;
+
+};
+
+
+/// \returns the calibrator, which makes its first fit on the first call.
+Calibrator& getCalibrator()
+{
+    static Calibrator calibrator;
+    return calibrator;
+}
+
+
+#endif
+
+
+} // namespace
+
+
+Clock::Clock(Source source): _source(source)
+{
+}
+
+
+Clock::Source Clock::getSource() const
+{
+    return _source;
+}
+
+
+int64_t Clock::getMicroseconds() const
+{
+    return getMicroseconds(_source);
+}
+
+
+Poco::Timestamp Clock::now() const
+{
+    return Poco::Timestamp(getMicroseconds(_source));
+}
+
+
+int64_t Clock::getMicroseconds(Source source)
+{
+    switch(source)
+    {
+        case REALTIME_COARSE:
+        {
+#if defined(_WIN32)
+            FILETIME time;
+            GetSystemTimeAsFileTime(&time);
+            return toMicroseconds(time);
+#elif defined(CLOCK_REALTIME_COARSE)
+            return getClockMicroseconds(CLOCK_REALTIME_COARSE);
+#else
+            return getRealtime();
+#endif
+        }
+        case TSC:
+        {
+#if defined(OFX_TIME_HAVE_TSC)
+            const Calibrator& calibrator = getCalibrator();
+
+            if (calibrator.isAvailable())
+            {
+                return calibrator.getMicroseconds();
+            }
+#endif
+            return getRealtime();
+        }
+        case REALTIME:
+            break;
+    }
+
+    return getRealtime();
+}
+
+
+void Clock::calibrate()
+{
+#if defined(OFX_TIME_HAVE_TSC)
+    getCalibrator().calibrate();
+#endif
+}
+
+
+bool Clock::isAvailable(Source source)
+{
+    switch(source)
+    {
+        case REALTIME:
+            return true;
+        case REALTIME_COARSE:
+#if defined(_WIN32) || defined(CLOCK_REALTIME_COARSE)
+            return true;
+#else
+            return false;
+#endif
+        case TSC:
+#if defined(OFX_TIME_HAVE_TSC)
+            return getCalibrator().isAvailable();
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/ColumnParser.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include "ofLog.h"
+#include "MappedFile.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \returns a pointer past the next newline, or last.
+inline const char* nextLine(const char* p, const char* last)
+{
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', std::size_t(last - p)));
+    return newline ? newline + 1 : last;
+}
+
+
+/// \brief Call function(i) for each i in [0, count) on its own thread.
+///
+/// The calling thread runs the last call.
+template <typename Function>
+void forEachChunk(std::size_t count, Function function)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+
+    for (std::size_t i = 0; i + 1 < count; ++i)
+    {
+        threads.emplace_back(function, i);
+    }
+
+    function(count - 1);
+
+    for (std::thread& thread: threads)
+    {
+        thread.join();
+    }
+}
+
+
+} // namespace
+
+
+ColumnParser::ColumnParser(const CompiledParser& parser):
+    ColumnParser(parser, Settings())
+{
+}
+
+
+ColumnParser::ColumnParser(const CompiledParser& parser,
+                           const Settings& settings):
+    _parser(parser),
+    _settings(settings)
+{
+}
+
+
+const CompiledParser& ColumnParser::getParser() const
+{
+    return _parser;
+}
+
+
+const ColumnParser::Settings& ColumnParser::getSettings() const
+{
+    return _settings;
+}
+
+
+std::size_t ColumnParser::parse(const char* buffer,
+                                std::size_t size,
+                                Timestamps& timestamps,
+                                std::vector<Report>& reports) const
+{
+    const char* first = buffer;
+    const char* last = buffer + size;
+
+    for (std::size_t i = 0; i < _settings.headerLines && first != last; ++i)
+    {
+        first = nextLine(first, last);
+    }
+
+    // Split the input into chunks that start at the beginning of a line.
+    std::size_t threads = _settings.threads;
+
+    if (threads == 0)
+    {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const std::size_t remaining = std::size_t(last - first);
+    const std::size_t chunks = std::max<std::size_t>(1, std::min(threads, remaining / std::max<std::size_t>(_settings.minChunkSize, 1)));
+
+    reports.assign(chunks, Report());
+
+    const char* start = first;
+
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+        const char* end = i + 1 == chunks ? last : first + remaining / chunks * (i + 1);
+
+        // Finish the line containing the split point.
+        if (end != last && end != start && *(end - 1) != '\n')
+        {
+            end = nextLine(end, last);
+        }
+
+        end = std::max(end, start);
+
+        reports[i].offset = std::size_t(start - buffer);
+        reports[i].size = std::size_t(end - start);
+        start = end;
+    }
+
+    // Count the lines in each chunk in parallel.
+    forEachChunk(chunks, [&](std::size_t i) {
+        reports[i].lines = CompiledParser::countLines(buffer + reports[i].offset, reports[i].size);
+    });
+
+    std::size_t lines = 0;
+
+    for (Report& report: reports)
+    {
+        report.firstLine = lines;
+        lines += report.lines;
+    }
+
+    timestamps.resize(lines);
+
+    // Parse each chunk into its part of the output in parallel.
+    int64_t* output = timestamps.data();
+
+    forEachChunk(chunks, [&](std::size_t i) {
+        parseChunk(buffer, output, reports[i]);
+    });
+
+    std::size_t failures = 0;
+
+    for (const Report& report: reports)
+    {
+        failures += report.failures;
+    }
+
+    return failures;
+}
+
+
+bool ColumnParser::parseFile(const std::string& path,
+                             Timestamps& timestamps,
+                             std::vector<Report>& reports) const
+{
+    MappedFile file;
+
+    if (!file.open(path))
+    {
+        ofLogError("ColumnParser::parseFile") << "Unable to map " << path;
+        timestamps.clear();
+        reports.clear();
+        return false;
+    }
+
+    parse(file.data(), file.size(), timestamps, reports);
+    return true;
+}
+
+
+void ColumnParser::parseChunk(const char* buffer,
+                              int64_t* timestamps,
+                              Report& report) const
+{
+    const char* p = buffer + report.offset;
+    const char* end = p + report.size;
+
+    int64_t* output = timestamps + report.firstLine;
+
+    for (std::size_t line = 0; line < report.lines; ++line)
+    {
+        const char* next = nextLine(p, end);
+        const char* last = next;
+
+        if (last != p && *(last - 1) == '\n')
+        {
+            --last;
+        }
+
+        if (last != p && *(last - 1) == '\r')
+        {
+            --last;
+        }
+
+        // Find the column.
+        const char* field = p;
+
+        for (std::size_t column = 0; column < _settings.column && field != last; ++column)
+        {
+            const char* delimiter = static_cast<const char*>(std::memchr(field, _settings.delimiter, std::size_t(last - field)));
+            field = delimiter ? delimiter + 1 : last;
+        }
+
+        const char* fieldEnd = static_cast<const char*>(std::memchr(field, _settings.delimiter, std::size_t(last - field)));
+
+        if (!fieldEnd)
+        {
+            fieldEnd = last;
+        }
+
+        int64_t microseconds = 0;
+        int tzd = 0;
+
+        CompiledParser::Error error = _parser.parse(field, fieldEnd, microseconds, tzd);
+
+        output[line] = microseconds;
+
+        if (error != CompiledParser::SUCCESS)
+        {
+            if (report.failures == 0)
+            {
+                report.firstFailure = report.firstLine + line;
+                report.firstError = error;
+            }
+
+            ++report.failures;
+        }
+
+        p = next;
+    }
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,595 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/CompiledFormat.h"
+#include <cstring>
+#include "ofx/Time/Calendar.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief A name and its length.
+struct Name
+{
+    const char* text;
+    std::size_t length;
+};
+
+
+// These match Poco::DateTimeFormat::WEEKDAY_NAMES and MONTH_NAMES.
+const Name WEEKDAY_NAMES[7] = {
+    { "Sunday", 6 },
+    { "Monday", 6 },
+    { "Tuesday", 7 },
+    { "Wednesday", 9 },
+    { "Thursday", 8 },
+    { "Friday", 6 },
+    { "Saturday", 8 }
+};
+
+
+const Name MONTH_NAMES[12] = {
+    { "January", 7 },
+    { "February", 8 },
+    { "March", 5 },
+    { "April", 5 },
+    { "May", 3 },
+    { "June", 4 },
+    { "July", 4 },
+    { "August", 6 },
+    { "September", 9 },
+    { "October", 7 },
+    { "November", 8 },
+    { "December", 8 }
+};
+
+
+const char DIGIT_PAIRS[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+
+/// \brief Write a value in [0, 99] as two digits.
+inline char* writeTwoDigits(char* out, int value)
+{
+    std::memcpy(out, DIGIT_PAIRS + 2 * value, 2);
+    return out + 2;
+}
+
+
+/// \brief Write a value in [0, 999999] as six digits.
+inline char* writeSixDigits(char* out, int value)
+{
+    out = writeTwoDigits(out, value / 10000);
+    out = writeTwoDigits(out, value / 100 % 100);
+    return writeTwoDigits(out, value % 100);
+}
+
+
+/// \brief Write an integer padded to a minimum width.
+///
+/// This matches Poco::NumberFormatter::append() and append0(): with a fill
+/// of '0' the sign is written before the padding and counts toward the
+/// width, otherwise the padding is written before the sign.
+char* writeInteger(char* out, int64_t value, int width, char fill)
+{
+    char digits[24];
+    int count = 0;
+
+    uint64_t magnitude = value < 0 ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+
+    do
+    {
+        digits[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    while (magnitude != 0);
+
+    int size = count + (value < 0);
+
+    if (fill != '0')
+    {
+        for (; size < width; ++size)
+        {
+            *out++ = fill;
+        }
+    }
+
+    if (value < 0)
+    {
+        *out++ = '-';
+    }
+
+    if (fill == '0')
+    {
+        for (; size < width; ++size)
+        {
+            *out++ = '0';
+        }
+    }
+
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+
+    return out;
+}
+
+
+/// \brief Write a value that is usually in [0, 99], padded to two places.
+inline char* writePadded(char* out, int64_t value, char fill)
+{
+    if (value >= 10 && value < 100)
+    {
+        return writeTwoDigits(out, int(value));
+    }
+
+    return writeInteger(out, value, 2, fill);
+}
+
+
+/// \brief Write a time zone differential.
+/// \param separator true for the ISO 8601 form.
+char* writeTimeZone(char* out, int timeZoneDifferential, bool separator)
+{
+    if (timeZoneDifferential == Poco::DateTimeFormatter::UTC)
+    {
+        if (separator)
+        {
+            *out++ = 'Z';
+        }
+        else
+        {
+            std::memcpy(out, "GMT", 3);
+            out += 3;
+        }
+
+        return out;
+    }
+
+    int64_t differential = timeZoneDifferential;
+
+    *out++ = differential >= 0 ? '+' : '-';
+
+    if (differential < 0)
+    {
+        differential = -differential;
+    }
+
+    out = writeInteger(out, differential / 3600, 2, '0');
+
+    if (separator)
+    {
+        *out++ = ':';
+    }
+
+    return writeInteger(out, (differential % 3600) / 60, 2, '0');
+}
+
+
+} // namespace
+
+
+CompiledFormat::CompiledFormat(const std::string& fmt):
+    _format(fmt)
+{
+    auto it = fmt.begin();
+    auto end = fmt.end();
+
+    while (it != end)
+    {
+        char literal = *it;
+        Token::Type type = Token::LITERAL;
+
+        if (*it == '%')
+        {
+            if (++it == end)
+            {
+                break;
+            }
+
+            literal = *it;
+
+            switch(*it)
+            {
+                case 'w': type = Token::WEEKDAY_ABBREVIATED; break;
+                case 'W': type = Token::WEEKDAY_FULL; break;
+                case 'b': type = Token::MONTH_ABBREVIATED; break;
+                case 'B': type = Token::MONTH_FULL; break;
+                case 'd': type = Token::DAY_ZERO_PADDED; break;
+                case 'e': type = Token::DAY; break;
+                case 'f': type = Token::DAY_SPACE_PADDED; break;
+                case 'm': type = Token::MONTH_ZERO_PADDED; break;
+                case 'n': type = Token::MONTH; break;
+                case 'o': type = Token::MONTH_SPACE_PADDED; break;
+                case 'y': type = Token::YEAR_SHORT; break;
+                case 'Y': type = Token::YEAR; break;
+                case 'H': type = Token::HOUR; break;
+                case 'h': type = Token::HOUR_AMPM; break;
+                case 'a': type = Token::AMPM_LOWER; break;
+                case 'A': type = Token::AMPM_UPPER; break;
+                case 'M': type = Token::MINUTE; break;
+                case 'S': type = Token::SECOND; break;
+                case 's': type = Token::SECOND_FRACTION; break;
+                case 'i': type = Token::MILLISECOND; break;
+                case 'c': type = Token::DECISECOND; break;
+                case 'F': type = Token::MICROSECOND; break;
+                case 'z': type = Token::TIME_ZONE_ISO; break;
+                case 'Z': type = Token::TIME_ZONE_RFC; break;
+                default: break;
+            }
+        }
+
+        ++it;
+
+        if (type == Token::LITERAL)
+        {
+            // Merge adjacent literal characters into a single token.
+            if (_tokens.empty() || _tokens.back().type != Token::LITERAL)
+            {
+                _tokens.push_back({ Token::LITERAL, uint32_t(_literals.size()), 0 });
+            }
+
+            _literals += literal;
+            ++_tokens.back().length;
+        }
+        else
+        {
+            _tokens.push_back({ type, 0, 0 });
+
+            if (type <= Token::YEAR)
+            {
+                _usesDate = true;
+            }
+            else if (type < Token::TIME_ZONE_ISO)
+            {
+                _usesTime = true;
+            }
+        }
+    }
+
+    for (const Token& token: _tokens)
+    {
+        _maxSize += getMaxSize(token);
+    }
+}
+
+
+const std::string& CompiledFormat::getFormat() const
+{
+    return _format;
+}
+
+
+const std::vector<CompiledFormat::Token>& CompiledFormat::getTokens() const
+{
+    return _tokens;
+}
+
+
+const std::string& CompiledFormat::getLiterals() const
+{
+    return _literals;
+}
+
+
+std::size_t CompiledFormat::getMaxSize() const
+{
+    return _maxSize;
+}
+
+
+bool CompiledFormat::usesDate() const
+{
+    return _usesDate;
+}
+
+
+bool CompiledFormat::usesTime() const
+{
+    return _usesTime;
+}
+
+
+std::size_t CompiledFormat::format(int64_t microseconds,
+                                   char* buffer,
+                                   int timeZoneDifferential) const
+{
+    Fields fields;
+    setFields(fields, microseconds);
+    return std::size_t(write(fields, buffer, timeZoneDifferential) - buffer);
+}
+
+
+char* CompiledFormat::format(const Poco::Timestamp& timestamp,
+                             char* first,
+                             char* last,
+                             int timeZoneDifferential) const
+{
+    if (last - first >= std::ptrdiff_t(_maxSize))
+    {
+        return first + format(timestamp.epochMicroseconds(), first, timeZoneDifferential);
+    }
+
+    // The range may still be large enough for this particular time, so
+    // format one token at a time through a scratch buffer.
+    Fields fields;
+    setFields(fields, timestamp.epochMicroseconds());
+
+    char scratch[32];
+
+    for (const Token& token: _tokens)
+    {
+        const char* text = scratch;
+        std::size_t size = 0;
+
+        if (token.type == Token::LITERAL)
+        {
+            text = _literals.data() + token.offset;
+            size = token.length;
+        }
+        else
+        {
+            size = std::size_t(write(token, fields, scratch, timeZoneDifferential) - scratch);
+        }
+
+        if (std::size_t(last - first) < size)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(first, text, size);
+        first += size;
+    }
+
+    return first;
+}
+
+
+std::string CompiledFormat::format(const Poco::Timestamp& timestamp,
+                                   int timeZoneDifferential) const
+{
+    std::string result(_maxSize, '\0');
+    result.resize(format(timestamp.epochMicroseconds(), &result[0], timeZoneDifferential));
+    return result;
+}
+
+
+std::size_t CompiledFormat::format(const int64_t* timestamps,
+                                   std::size_t size,
+                                   char* buffer,
+                                   char separator,
+                                   int timeZoneDifferential) const
+{
+    char* out = buffer;
+
+    Fields fields;
+
+    int64_t previousDays = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        int64_t days = timestamps[i] / Calendar::MICROSECONDS_PER_DAY;
+        int64_t timeOfDay = timestamps[i] % Calendar::MICROSECONDS_PER_DAY;
+
+        if (timeOfDay < 0)
+        {
+            timeOfDay += Calendar::MICROSECONDS_PER_DAY;
+            --days;
+        }
+
+        // Recompute the date only when the day changes.
+        if (_usesDate && (i == 0 || days != previousDays))
+        {
+            setDate(fields, days);
+            previousDays = days;
+        }
+
+        setTime(fields, timeOfDay);
+
+        out = write(fields, out, timeZoneDifferential);
+        *out++ = separator;
+    }
+
+    return std::size_t(out - buffer);
+}
+
+
+void CompiledFormat::setFields(Fields& fields, int64_t microseconds) const
+{
+    // Split without forming days * MICROSECONDS_PER_DAY, which overflows
+    // for the earliest times.
+    int64_t days = microseconds / Calendar::MICROSECONDS_PER_DAY;
+    int64_t timeOfDay = microseconds % Calendar::MICROSECONDS_PER_DAY;
+
+    if (timeOfDay < 0)
+    {
+        timeOfDay += Calendar::MICROSECONDS_PER_DAY;
+        --days;
+    }
+
+    if (_usesDate)
+    {
+        setDate(fields, days);
+    }
+
+    setTime(fields, timeOfDay);
+}
+
+
+void CompiledFormat::setDate(Fields& fields, int64_t days)
+{
+    const Calendar::Date date = Calendar::civilFromDays(days);
+    fields.year = date.year;
+    fields.month = date.month;
+    fields.day = date.day;
+    fields.dayOfWeek = Calendar::dayOfWeek(days);
+}
+
+
+void CompiledFormat::setTime(Fields& fields, int64_t timeOfDay)
+{
+    const int seconds = int(timeOfDay / 1000000);
+    const int fraction = int(timeOfDay % 1000000);
+
+    fields.hour = seconds / 3600;
+    fields.minute = seconds / 60 % 60;
+    fields.second = seconds % 60;
+    fields.millisecond = fraction / 1000;
+    fields.microsecond = fraction % 1000;
+}
+
+
+char* CompiledFormat::write(const Fields& fields,
+                            char* out,
+                            int timeZoneDifferential) const
+{
+    for (const Token& token: _tokens)
+    {
+        out = write(token, fields, out, timeZoneDifferential);
+    }
+
+    return out;
+}
+
+
+char* CompiledFormat::write(const Token& token,
+                            const Fields& fields,
+                            char* out,
+                            int timeZoneDifferential) const
+{
+    switch(token.type)
+    {
+        case Token::LITERAL:
+            std::memcpy(out, _literals.data() + token.offset, token.length);
+            return out + token.length;
+        case Token::WEEKDAY_ABBREVIATED:
+            std::memcpy(out, WEEKDAY_NAMES[fields.dayOfWeek].text, 3);
+            return out + 3;
+        case Token::WEEKDAY_FULL:
+        {
+            const Name& name = WEEKDAY_NAMES[fields.dayOfWeek];
+            std::memcpy(out, name.text, name.length);
+            return out + name.length;
+        }
+        case Token::MONTH_ABBREVIATED:
+            std::memcpy(out, MONTH_NAMES[fields.month - 1].text, 3);
+            return out + 3;
+        case Token::MONTH_FULL:
+        {
+            const Name& name = MONTH_NAMES[fields.month - 1];
+            std::memcpy(out, name.text, name.length);
+            return out + name.length;
+        }
+        case Token::DAY_ZERO_PADDED:
+            return writeTwoDigits(out, fields.day);
+        case Token::DAY:
+            return writeInteger(out, fields.day, 0, ' ');
+        case Token::DAY_SPACE_PADDED:
+            return writePadded(out, fields.day, ' ');
+        case Token::MONTH_ZERO_PADDED:
+            return writeTwoDigits(out, fields.month);
+        case Token::MONTH:
+            return writeInteger(out, fields.month, 0, ' ');
+        case Token::MONTH_SPACE_PADDED:
+            return writePadded(out, fields.month, ' ');
+        case Token::YEAR_SHORT:
+            return writePadded(out, fields.year % 100, '0');
+        case Token::YEAR:
+            if (fields.year >= 1000 && fields.year < 10000)
+            {
+                out = writeTwoDigits(out, int(fields.year / 100));
+                return writeTwoDigits(out, int(fields.year % 100));
+            }
+            return writeInteger(out, fields.year, 4, '0');
+        case Token::HOUR:
+            return writeTwoDigits(out, fields.hour);
+        case Token::HOUR_AMPM:
+            return writeTwoDigits(out, fields.hour < 1 ? 12 : (fields.hour > 12 ? fields.hour - 12 : fields.hour));
+        case Token::AMPM_LOWER:
+            *out++ = fields.hour < 12 ? 'a' : 'p';
+            *out++ = 'm';
+            return out;
+        case Token::AMPM_UPPER:
+            *out++ = fields.hour < 12 ? 'A' : 'P';
+            *out++ = 'M';
+            return out;
+        case Token::MINUTE:
+            return writeTwoDigits(out, fields.minute);
+        case Token::SECOND:
+            return writeTwoDigits(out, fields.second);
+        case Token::SECOND_FRACTION:
+            out = writeTwoDigits(out, fields.second);
+            *out++ = '.';
+            return writeSixDigits(out, fields.millisecond * 1000 + fields.microsecond);
+        case Token::MILLISECOND:
+            *out++ = char('0' + fields.millisecond / 100);
+            return writeTwoDigits(out, fields.millisecond % 100);
+        case Token::DECISECOND:
+            *out++ = char('0' + fields.millisecond / 100);
+            return out;
+        case Token::MICROSECOND:
+            return writeSixDigits(out, fields.millisecond * 1000 + fields.microsecond);
+        case Token::TIME_ZONE_ISO:
+            return writeTimeZone(out, timeZoneDifferential, true);
+        case Token::TIME_ZONE_RFC:
+            return writeTimeZone(out, timeZoneDifferential, false);
+    }
+
+    return out;
+}
+
+
+std::size_t CompiledFormat::getMaxSize(const Token& token)
+{
+    switch(token.type)
+    {
+        case Token::LITERAL:
+            return token.length;
+        case Token::WEEKDAY_FULL:
+        case Token::MONTH_FULL:
+            return 9;
+        case Token::YEAR_SHORT:
+            return 3;
+        case Token::YEAR:
+            // The years of all int64_t microsecond times fit in 6 digits.
+            return 7;
+        case Token::SECOND_FRACTION:
+            return 9;
+        case Token::MICROSECOND:
+            return 6;
+        case Token::TIME_ZONE_ISO:
+        case Token::TIME_ZONE_RFC:
+            // A sign, up to 6 digits of hours, a separator and the minutes.
+            return 10;
+        case Token::DECISECOND:
+            return 1;
+        case Token::WEEKDAY_ABBREVIATED:
+        case Token::MONTH_ABBREVIATED:
+        case Token::MILLISECOND:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+
+} } // namespace ofx::Time
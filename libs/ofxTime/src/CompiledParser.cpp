@@ -0,0 +1,696 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/CompiledParser.h"
+#include <cstring>
+#include "ofx/Time/Calendar.h"
+#include "Ascii.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief Load eight characters with the first in the lowest byte.
+inline uint64_t load(const char* p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+
+/// \brief Convert eight ASCII digits with the first in the lowest byte.
+inline uint32_t convertEightDigits(uint64_t value)
+{
+    value = (value & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561 >> 8;
+    value = (value & UINT64_C(0x00FF00FF00FF00FF)) * 6553601 >> 16;
+    return uint32_t((value & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001) >> 32);
+}
+
+
+const int64_t POWERS_OF_10[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+
+/// \brief Append digits to a field.
+///
+/// Like Poco, a field that is parsed more than once accumulates digits.
+/// Values saturate well beyond any valid field so they cannot overflow.
+inline void append(int64_t& field, int64_t value, int digits)
+{
+    if (field < 1000000000)
+    {
+        field = field * POWERS_OF_10[digits] + value;
+    }
+}
+
+
+/// \brief Read exactly width digits in a single register.
+///
+/// Eight characters must remain.  The next width characters are validated
+/// and converted together.
+///
+/// \returns false, consuming nothing, unless all width characters are digits.
+inline bool parseDigits(const char*& p, int width, int64_t& field)
+{
+    const uint64_t mask = (uint64_t(1) << (8 * width)) - 1;
+    const uint64_t value = load(p) & mask;
+
+    // Every masked byte must be in ['0', '9'].
+    const uint64_t zeros = UINT64_C(0x3030303030303030) & mask;
+    const uint64_t high = UINT64_C(0xF0F0F0F0F0F0F0F0) & mask;
+
+    if ((value & high) != zeros
+     || ((value + (UINT64_C(0x0606060606060606) & mask)) & high) != zeros)
+    {
+        return false;
+    }
+
+    p += width;
+    append(field, convertEightDigits(value << (64 - 8 * width)), width);
+    return true;
+}
+
+
+/// \brief Read up to width digits, as Poco's PARSE_NUMBER_N.
+inline void parseNumber(const char*& p, const char* last, int width, int64_t& field)
+{
+    if (last - p >= 8 && parseDigits(p, width, field))
+    {
+        return;
+    }
+
+    for (int i = 0; i < width && p != last && Ascii::isDigit(*p); ++i)
+    {
+        append(field, *p++ - '0', 1);
+    }
+}
+
+
+/// \brief Read fractional digits scaled to width, as Poco's PARSE_FRACTIONAL_N.
+inline void parseFraction(const char*& p, const char* last, int width, int64_t& field)
+{
+    if (last - p >= 8 && parseDigits(p, width, field))
+    {
+        return;
+    }
+
+    int i = 0;
+
+    for (; i < width && p != last && Ascii::isDigit(*p); ++i)
+    {
+        append(field, *p++ - '0', 1);
+    }
+
+    for (; i < width; ++i)
+    {
+        append(field, 0, 1);
+    }
+}
+
+
+inline void skipJunk(const char*& p, const char* last)
+{
+    while (p != last && !Ascii::isDigit(*p))
+    {
+        ++p;
+    }
+}
+
+
+inline void skipDigits(const char*& p, const char* last)
+{
+    while (p != last && Ascii::isDigit(*p))
+    {
+        ++p;
+    }
+}
+
+
+const char* const MONTH_NAMES[12] = {
+    "january",
+    "february",
+    "march",
+    "april",
+    "may",
+    "june",
+    "july",
+    "august",
+    "september",
+    "october",
+    "november",
+    "december"
+};
+
+
+/// \returns the month [1, 12] whose name starts with the next word, or 0.
+int parseMonth(const char*& p, const char* last)
+{
+    while (p != last && (Ascii::isSpace(*p) || Ascii::isPunct(*p)))
+    {
+        ++p;
+    }
+
+    const char* word = p;
+
+    while (p != last && Ascii::isAlpha(*p))
+    {
+        ++p;
+    }
+
+    const std::size_t length = std::size_t(p - word);
+
+    if (length < 3)
+    {
+        return 0;
+    }
+
+    for (int month = 0; month < 12; ++month)
+    {
+        const char* name = MONTH_NAMES[month];
+        std::size_t i = 0;
+
+        while (i < length && name[i] != '\0' && (word[i] | 0x20) == name[i])
+        {
+            ++i;
+        }
+
+        if (i == length)
+        {
+            return month + 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/// \brief A time zone designator recognized by Poco::DateTimeParser.
+struct Zone
+{
+    const char* designator;
+    std::size_t length;
+    int timeZoneDifferential;
+};
+
+
+const Zone ZONES[] = {
+    { "Z", 1, 0 },
+    { "UT", 2, 0 },
+    { "GMT", 3, 0 },
+    { "BST", 3, 1 * 3600 },
+    { "IST", 3, 1 * 3600 },
+    { "WET", 3, 0 },
+    { "WEST", 4, 1 * 3600 },
+    { "CET", 3, 1 * 3600 },
+    { "CEST", 4, 2 * 3600 },
+    { "EET", 3, 2 * 3600 },
+    { "EEST", 4, 3 * 3600 },
+    { "MSK", 3, 3 * 3600 },
+    { "MSD", 3, 4 * 3600 },
+    { "NST", 3, -3 * 3600 - 1800 },
+    { "NDT", 3, -2 * 3600 - 1800 },
+    { "AST", 3, -4 * 3600 },
+    { "ADT", 3, -3 * 3600 },
+    { "EST", 3, -5 * 3600 },
+    { "EDT", 3, -4 * 3600 },
+    { "CST", 3, -6 * 3600 },
+    { "CDT", 3, -5 * 3600 },
+    { "MST", 3, -7 * 3600 },
+    { "MDT", 3, -6 * 3600 },
+    { "PST", 3, -8 * 3600 },
+    { "PDT", 3, -7 * 3600 },
+    { "AKST", 4, -9 * 3600 },
+    { "AKDT", 4, -8 * 3600 },
+    { "HST", 3, -10 * 3600 },
+    { "AEST", 4, 10 * 3600 },
+    { "AEDT", 4, 11 * 3600 },
+    { "ACST", 4, 9 * 3600 + 1800 },
+    { "ACDT", 4, 10 * 3600 + 1800 },
+    { "AWST", 4, 8 * 3600 },
+    { "AWDT", 4, 9 * 3600 }
+};
+
+
+/// \returns the time zone differential in seconds, as Poco's parseTZD().
+int parseTimeZone(const char*& p, const char* last)
+{
+    int result = 0;
+
+    while (p != last && Ascii::isSpace(*p))
+    {
+        ++p;
+    }
+
+    if (p == last)
+    {
+        return result;
+    }
+
+    if (Ascii::isAlpha(*p))
+    {
+        const char* designator = p++;
+
+        for (int i = 1; i < 4 && p != last && Ascii::isAlpha(*p); ++i)
+        {
+            ++p;
+        }
+
+        const std::size_t length = std::size_t(p - designator);
+
+        for (const Zone& zone: ZONES)
+        {
+            if (zone.length == length
+             && std::memcmp(zone.designator, designator, length) == 0)
+            {
+                result = zone.timeZoneDifferential;
+                break;
+            }
+        }
+    }
+
+    if (p != last && (*p == '+' || *p == '-'))
+    {
+        const int sign = *p++ == '+' ? 1 : -1;
+
+        int64_t hours = 0;
+        parseNumber(p, last, 2, hours);
+
+        if (p != last && *p == ':')
+        {
+            ++p;
+        }
+
+        int64_t minutes = 0;
+        parseNumber(p, last, 2, minutes);
+
+        result += sign * int(hours * 3600 + minutes * 60);
+    }
+
+    return result;
+}
+
+
+/// \returns the hour adjusted for an AM/PM designator, or -1.
+int64_t parseAMPM(const char*& p, const char* last, int64_t hour)
+{
+    while (p != last && (Ascii::isSpace(*p) || Ascii::isPunct(*p)))
+    {
+        ++p;
+    }
+
+    const char* designator = p;
+
+    while (p != last && Ascii::isAlpha(*p))
+    {
+        ++p;
+    }
+
+    if (p - designator == 2 && (designator[1] | 0x20) == 'm')
+    {
+        if ((designator[0] | 0x20) == 'a')
+        {
+            return hour == 12 ? 0 : hour;
+        }
+        else if ((designator[0] | 0x20) == 'p')
+        {
+            return hour < 12 ? hour + 12 : hour;
+        }
+    }
+
+    return -1;
+}
+
+
+} // namespace
+
+
+CompiledParser::CompiledParser(const std::string& fmt):
+    _format(fmt)
+{
+    auto it = fmt.begin();
+    auto end = fmt.end();
+
+    while (it != end)
+    {
+        // Literal characters do not consume input.
+        if (*it++ != '%' || it == end)
+        {
+            continue;
+        }
+
+        switch(*it++)
+        {
+            case 'w':
+            case 'W':
+                _steps.push_back(SKIP_WEEKDAY);
+                break;
+            case 'b':
+            case 'B':
+                _steps.push_back(MONTH_NAME);
+                break;
+            case 'd':
+            case 'e':
+            case 'f':
+                _steps.push_back(DAY);
+                break;
+            case 'm':
+            case 'n':
+            case 'o':
+                _steps.push_back(MONTH);
+                break;
+            case 'y':
+                _steps.push_back(YEAR_SHORT);
+                break;
+            case 'Y':
+                _steps.push_back(YEAR);
+                break;
+            case 'r':
+                _steps.push_back(YEAR_ANY);
+                break;
+            case 'H':
+            case 'h':
+                _steps.push_back(HOUR);
+                break;
+            case 'a':
+            case 'A':
+                _steps.push_back(AMPM);
+                break;
+            case 'M':
+                _steps.push_back(MINUTE);
+                break;
+            case 'S':
+                _steps.push_back(SECOND);
+                break;
+            case 's':
+                _steps.push_back(SECOND_FRACTION);
+                break;
+            case 'i':
+                _steps.push_back(MILLISECOND);
+                break;
+            case 'c':
+                _steps.push_back(DECISECOND);
+                break;
+            case 'F':
+                _steps.push_back(FRACTION);
+                break;
+            case 'z':
+            case 'Z':
+                _steps.push_back(TIME_ZONE);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+const std::string& CompiledParser::getFormat() const
+{
+    return _format;
+}
+
+
+CompiledParser::Error CompiledParser::parse(const char* first,
+                                            const char* last,
+                                            int64_t& microseconds,
+                                            int& timeZoneDifferential) const
+{
+    if (_format.empty() || first == last)
+    {
+        return EMPTY;
+    }
+
+    int64_t year = 0;
+    int64_t month = 0;
+    int64_t day = 0;
+    int64_t hour = 0;
+    int64_t minute = 0;
+    int64_t second = 0;
+    int64_t millisecond = 0;
+    int64_t microsecond = 0;
+    int tzd = 0;
+
+    const char* p = first;
+
+    for (Step step: _steps)
+    {
+        if (p == last)
+        {
+            break;
+        }
+
+        switch(step)
+        {
+            case SKIP_WEEKDAY:
+                while (p != last && Ascii::isSpace(*p))
+                {
+                    ++p;
+                }
+                while (p != last && Ascii::isAlpha(*p))
+                {
+                    ++p;
+                }
+                break;
+            case MONTH_NAME:
+                month = parseMonth(p, last);
+                if (month == 0)
+                {
+                    return INVALID_MONTH;
+                }
+                break;
+            case DAY:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, day);
+                break;
+            case MONTH:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, month);
+                break;
+            case YEAR_SHORT:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, year);
+                year += year >= 69 ? 1900 : 2000;
+                break;
+            case YEAR:
+                skipJunk(p, last);
+                parseNumber(p, last, 4, year);
+                break;
+            case YEAR_ANY:
+                skipJunk(p, last);
+                for (; p != last && Ascii::isDigit(*p); ++p)
+                {
+                    append(year, *p - '0', 1);
+                }
+                if (year < 1000)
+                {
+                    year += year >= 69 ? 1900 : 2000;
+                }
+                break;
+            case HOUR:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, hour);
+                break;
+            case AMPM:
+                hour = parseAMPM(p, last, hour);
+                if (hour < 0)
+                {
+                    return INVALID_AMPM;
+                }
+                break;
+            case MINUTE:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, minute);
+                break;
+            case SECOND:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, second);
+                break;
+            case SECOND_FRACTION:
+                skipJunk(p, last);
+                parseNumber(p, last, 2, second);
+                if (p != last && (*p == '.' || *p == ','))
+                {
+                    ++p;
+                    parseFraction(p, last, 3, millisecond);
+                    parseFraction(p, last, 3, microsecond);
+                    skipDigits(p, last);
+                }
+                break;
+            case MILLISECOND:
+                skipJunk(p, last);
+                parseNumber(p, last, 3, millisecond);
+                break;
+            case DECISECOND:
+                skipJunk(p, last);
+                parseNumber(p, last, 1, millisecond);
+                millisecond *= 100;
+                break;
+            case FRACTION:
+                skipJunk(p, last);
+                parseFraction(p, last, 3, millisecond);
+                parseFraction(p, last, 3, microsecond);
+                skipDigits(p, last);
+                break;
+            case TIME_ZONE:
+                tzd = parseTimeZone(p, last);
+                break;
+        }
+    }
+
+    if (month == 0)
+    {
+        month = 1;
+    }
+
+    if (day == 0)
+    {
+        day = 1;
+    }
+
+    // The same limits as Poco::DateTime::isValid().
+    if (year < 0 || year > 9999
+     || month < 1 || month > 12
+     || day < 1 || day > Calendar::daysInMonth(year, int(month))
+     || hour > 23
+     || minute > 59
+     || second > 60
+     || millisecond > 999
+     || microsecond > 999)
+    {
+        return OUT_OF_RANGE;
+    }
+
+    const int64_t seconds = ((Calendar::daysFromCivil(year, int(month), int(day)) * 24 + hour) * 60 + minute) * 60 + second - tzd;
+
+    microseconds = seconds * 1000000 + millisecond * 1000 + microsecond;
+    timeZoneDifferential = tzd;
+
+    return SUCCESS;
+}
+
+
+CompiledParser::Error CompiledParser::parse(const std::string& text,
+                                            Poco::Timestamp& timestamp,
+                                            int& timeZoneDifferential) const
+{
+    int64_t microseconds = 0;
+
+    Error error = parse(text.data(), text.data() + text.size(), microseconds, timeZoneDifferential);
+
+    if (error == SUCCESS)
+    {
+        timestamp = Poco::Timestamp(microseconds);
+    }
+
+    return error;
+}
+
+
+std::size_t CompiledParser::parse(const char* buffer,
+                                  std::size_t size,
+                                  int64_t* timestamps,
+                                  Error* errors,
+                                  int* timeZoneDifferentials) const
+{
+    const char* p = buffer;
+    const char* end = buffer + size;
+
+    std::size_t line = 0;
+    std::size_t count = 0;
+
+    while (p != end)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p)));
+        const char* next = newline ? newline + 1 : end;
+        const char* last = newline ? newline : end;
+
+        if (last != p && *(last - 1) == '\r')
+        {
+            --last;
+        }
+
+        int64_t microseconds = 0;
+        int tzd = 0;
+
+        Error error = parse(p, last, microseconds, tzd);
+
+        timestamps[line] = microseconds;
+
+        if (errors)
+        {
+            errors[line] = error;
+        }
+
+        if (timeZoneDifferentials)
+        {
+            timeZoneDifferentials[line] = tzd;
+        }
+
+        count += error == SUCCESS;
+        ++line;
+        p = next;
+    }
+
+    return count;
+}
+
+
+std::size_t CompiledParser::countLines(const char* buffer, std::size_t size)
+{
+    const char* p = buffer;
+    const char* end = buffer + size;
+
+    std::size_t count = 0;
+
+    while (p != end)
+    {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p)));
+
+        ++count;
+
+        if (!newline)
+        {
+            break;
+        }
+
+        p = newline + 1;
+    }
+
+    return count;
+}
+
+
+const char* CompiledParser::toString(Error error)
+{
+    switch(error)
+    {
+        case SUCCESS:
+            return "Success";
+        case EMPTY:
+            return "Empty format or input";
+        case INVALID_MONTH:
+            return "Not a valid month name";
+        case INVALID_AMPM:
+            return "Not a valid AM/PM designator";
+        case OUT_OF_RANGE:
+            return "Date/time component out of range";
+    }
+
+    return "Unknown error";
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/Coroutine.h"
+
+
+#if defined(OFX_TIME_HAVE_COROUTINES)
+
+
+#include <exception>
+#include "ofx/Time/Utils.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+void Coroutine::promise_type::unhandled_exception() noexcept
+{
+    try
+    {
+        throw;
+    }
+    catch (const std::exception& exception)
+    {
+        ofLogError("Coroutine::promise_type::unhandled_exception") << exception.what();
+    }
+    catch (...)
+    {
+        ofLogError("Coroutine::promise_type::unhandled_exception") << "Unknown exception.";
+    }
+}
+
+
+Ticker::Ticker(const Period& period, const Poco::Timestamp& first, EventLoop& loop):
+    _period(period),
+    _first(first),
+    _isValidPeriod(Utils::add(first, period) > first),
+    _loop(&loop)
+{
+    if (!_isValidPeriod)
+    {
+        ofLogError("Ticker::Ticker") << "The period must be positive.";
+    }
+}
+
+
+SleepAwaitable Ticker::next()
+{
+    if (!_isValidPeriod)
+    {
+        return SleepAwaitable();
+    }
+
+    const Poco::Timestamp now;
+
+    Poco::Timestamp time = Utils::add(_first, _period * _count);
+
+    if (time < now)
+    {
+        if (_period.isFixed())
+        {
+            // Skip the missed ticks in one step.
+            const int64_t length = _period.getFixedMicroseconds();
+            _count = (now - _first - 1) / length + 1;
+            time = _first + _count * length;
+        }
+        else
+        {
+            while (time < now)
+            {
+                time = Utils::add(_first, _period * ++_count);
+            }
+        }
+    }
+
+    ++_count;
+
+    return SleepAwaitable(time, *_loop);
+}
+
+
+Ticker every(const Period& period, EventLoop& loop)
+{
+    return Ticker(period, Utils::add(Poco::Timestamp(), period), loop);
+}
+
+
+} } // namespace ofx::Time
+
+
+#endif
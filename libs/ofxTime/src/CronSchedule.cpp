@@ -0,0 +1,608 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/CronSchedule.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <sstream>
+#include "ofx/Time/Bits.h"
+#include "ofx/Time/Calendar.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+const int64_t MICROSECONDS_PER_SECOND = 1000000;
+const int64_t SECONDS_PER_DAY = 86400;
+
+
+const char* const MONTH_NAMES[] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+};
+
+
+const char* const WEEKDAY_NAMES[] = { "SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT" };
+
+
+/// \returns the lowest set bit of a mask at or above a bit, or -1.
+inline int nextBit(uint64_t mask, int bit)
+{
+    if (bit >= 64)
+    {
+        return -1;
+    }
+
+    const uint64_t word = mask >> bit;
+    return 0 == word ? -1 : bit + Bits::lowestBit(word);
+}
+
+
+/// \brief Parse a number or, if names is not null, a name.
+bool parseValue(const std::string& text,
+                int minimum,
+                const char* const* names,
+                int numNames,
+                int& value)
+{
+    for (int i = 0; i < numNames; ++i)
+    {
+        if (text == names[i])
+        {
+            value = minimum + i;
+            return true;
+        }
+    }
+
+    if (text.empty() || text.size() > 4)
+    {
+        return false;
+    }
+
+    value = 0;
+
+    for (char c: text)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(c)))
+        {
+            return false;
+        }
+
+        value = value * 10 + (c - '0');
+    }
+
+    return true;
+}
+
+
+/// \brief Parse a cron field into a bitmask.
+bool parseField(const std::string& text,
+                int minimum,
+                int maximum,
+                const char* const* names,
+                int numNames,
+                bool allowQuestionMark,
+                uint64_t& mask)
+{
+    std::size_t begin = 0;
+
+    for (;;)
+    {
+        const std::size_t end = text.find(',', begin);
+        const std::string item = text.substr(begin, end - begin);
+        const std::size_t slash = item.find('/');
+        const std::string range = item.substr(0, slash);
+
+        int first = minimum;
+        int last = maximum;
+        int step = 1;
+
+        if (slash != std::string::npos
+         && (!parseValue(item.substr(slash + 1), 0, nullptr, 0, step) || step == 0))
+        {
+            return false;
+        }
+
+        if (range == "*" || (allowQuestionMark && range == "?"))
+        {
+            // The whole range.
+        }
+        else
+        {
+            const std::size_t dash = range.find('-');
+
+            if (!parseValue(range.substr(0, dash), minimum, names, numNames, first))
+            {
+                return false;
+            }
+
+            if (dash != std::string::npos)
+            {
+                if (!parseValue(range.substr(dash + 1), minimum, names, numNames, last))
+                {
+                    return false;
+                }
+            }
+            else if (slash == std::string::npos)
+            {
+                last = first;
+            }
+        }
+
+        if (first < minimum || last > maximum || first > last)
+        {
+            return false;
+        }
+
+        for (int value = first; value <= last; value += step)
+        {
+            mask |= uint64_t(1) << value;
+        }
+
+        if (end == std::string::npos)
+        {
+            return true;
+        }
+
+        begin = end + 1;
+    }
+}
+
+
+} // namespace
+
+
+CronSchedule::CronSchedule()
+{
+}
+
+
+CronSchedule::CronSchedule(const std::string& expression):
+    _expression(expression)
+{
+    std::string error;
+
+    if (!parse(expression, error))
+    {
+        ofLogError("CronSchedule::CronSchedule") << error << ": " << expression;
+        return;
+    }
+
+    _valid = true;
+
+    // The calendar repeats every 400 years, so a schedule that does not
+    // fire within 400 years never fires, e.g. "0 0 30 2 *".
+    int64_t fire = 0;
+    _hasFires = find(1970, 1, 1, 0, fire);
+}
+
+
+bool CronSchedule::isValid() const
+{
+    return _valid;
+}
+
+
+const std::string& CronSchedule::getExpression() const
+{
+    return _expression;
+}
+
+
+bool CronSchedule::matches(const Poco::Timestamp& time) const
+{
+    const int64_t microseconds = time.epochMicroseconds();
+    const int64_t seconds = Calendar::floorDivide(microseconds, MICROSECONDS_PER_SECOND);
+
+    if (!_valid || seconds * MICROSECONDS_PER_SECOND != microseconds)
+    {
+        return false;
+    }
+
+    const int64_t day = Calendar::floorDivide(seconds, SECONDS_PER_DAY);
+    const int secondOfDay = int(seconds - day * SECONDS_PER_DAY);
+    const Calendar::Date date = Calendar::civilFromDays(day);
+
+    return ((_seconds >> (secondOfDay % 60)) & 1) != 0
+        && ((_minutes >> (secondOfDay / 60 % 60)) & 1) != 0
+        && ((_hours >> (secondOfDay / 3600)) & 1) != 0
+        && ((_months >> date.month) & 1) != 0
+        && getNextDay(date.year, date.month, date.day) == date.day;
+}
+
+
+bool CronSchedule::next(int64_t after, int64_t& fire) const
+{
+    if (!_hasFires)
+    {
+        return false;
+    }
+
+    const int64_t second = Calendar::floorDivide(after, MICROSECONDS_PER_SECOND) + 1;
+    const int64_t day = Calendar::floorDivide(second, SECONDS_PER_DAY);
+    const Calendar::Date date = Calendar::civilFromDays(day);
+
+    return find(date.year, date.month, date.day, int(second - day * SECONDS_PER_DAY), fire);
+}
+
+
+bool CronSchedule::next(const Poco::Timestamp& after, Poco::Timestamp& fire) const
+{
+    int64_t microseconds = 0;
+
+    if (!next(after.epochMicroseconds(), microseconds))
+    {
+        return false;
+    }
+
+    fire = microseconds;
+    return true;
+}
+
+
+bool CronSchedule::next(const Poco::Timestamp& after,
+                        const TimeZone& zone,
+                        Poco::Timestamp& fire) const
+{
+    const int64_t utcAfter = after.epochMicroseconds();
+    int64_t local = zone.toLocal(utcAfter);
+    int64_t localFire = 0;
+    int64_t utcFire = std::numeric_limits<int64_t>::max();
+
+    // Fixed-time schedules fire only in the first pass of a repeated hour.
+    const TimeZone::AmbiguousPolicy ambiguous = _isFixedTime ? TimeZone::AMBIGUOUS_EARLIER
+                                                             : TimeZone::AMBIGUOUS_BOTH;
+
+    if (!_isFixedTime)
+    {
+        const TimeZone::Resolution resolution = zone.resolve(local);
+
+        // From the first pass of a repeated hour, the second pass starts
+        // before the local times that follow the time, so search it too.
+        if (resolution.type == TimeZone::Resolution::AMBIGUOUS
+         && utcAfter < resolution.transition)
+        {
+            const int64_t offset = resolution.offsetAfter * MICROSECONDS_PER_SECOND;
+
+            if (next(resolution.transition + offset - 1, localFire))
+            {
+                utcFire = localFire - offset;
+            }
+        }
+    }
+
+    while (next(local, localFire))
+    {
+        int64_t utc[2];
+        const std::size_t count = zone.toUtc(localFire, TimeZone::NONEXISTENT_NEXT_VALID, ambiguous, utc);
+
+        // Skip UTC times that have passed, e.g. the first pass of a
+        // repeated hour when the time is in the second pass.
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (utc[i] > utcAfter)
+            {
+                fire = std::min(utc[i], utcFire);
+                return true;
+            }
+        }
+
+        local = localFire;
+    }
+
+    if (utcFire != std::numeric_limits<int64_t>::max())
+    {
+        fire = utcFire;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool CronSchedule::next(const Poco::LocalDateTime& after, Poco::LocalDateTime& fire) const
+{
+    std::shared_ptr<const TimeZone> zone = TimeZone::local();
+    Poco::Timestamp utcFire;
+
+    if (!next(after.utc().timestamp(), *zone, utcFire))
+    {
+        return false;
+    }
+
+    fire = zone->toLocalDateTime(utcFire);
+    return true;
+}
+
+
+std::vector<Poco::Timestamp> CronSchedule::getInstances(const Poco::Timestamp& start,
+                                                        const Poco::Timestamp& end) const
+{
+    std::vector<Poco::Timestamp> instances;
+
+    if (start.epochMicroseconds() == std::numeric_limits<int64_t>::min())
+    {
+        return instances;
+    }
+
+    int64_t fire = start.epochMicroseconds() - 1;
+
+    while (next(fire, fire) && fire < end.epochMicroseconds())
+    {
+        instances.push_back(fire);
+    }
+
+    return instances;
+}
+
+
+void CronSchedule::next(const CronSchedule* schedules,
+                        std::size_t size,
+                        int64_t after,
+                        int64_t* fires)
+{
+    const int64_t second = Calendar::floorDivide(after, MICROSECONDS_PER_SECOND) + 1;
+    const int64_t day = Calendar::floorDivide(second, SECONDS_PER_DAY);
+    const int secondOfDay = int(second - day * SECONDS_PER_DAY);
+    const Calendar::Date date = Calendar::civilFromDays(day);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (!schedules[i]._hasFires
+         || !schedules[i].find(date.year, date.month, date.day, secondOfDay, fires[i]))
+        {
+            fires[i] = std::numeric_limits<int64_t>::max();
+        }
+    }
+}
+
+
+bool CronSchedule::parse(const std::string& expression, std::string& error)
+{
+    std::string text(expression);
+
+    std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+        return char(std::toupper(static_cast<unsigned char>(c)));
+    });
+
+    std::istringstream stream(text);
+    std::vector<std::string> fields;
+    std::string field;
+
+    while (stream >> field)
+    {
+        fields.push_back(field);
+    }
+
+    if (fields.size() == 1 && fields[0][0] == '@')
+    {
+        const std::string& name = fields[0];
+        std::string macro;
+
+        if (name == "@YEARLY" || name == "@ANNUALLY")
+        {
+            macro = "0 0 1 1 *";
+        }
+        else if (name == "@MONTHLY")
+        {
+            macro = "0 0 1 * *";
+        }
+        else if (name == "@WEEKLY")
+        {
+            macro = "0 0 * * 0";
+        }
+        else if (name == "@DAILY" || name == "@MIDNIGHT")
+        {
+            macro = "0 0 * * *";
+        }
+        else if (name == "@HOURLY")
+        {
+            macro = "0 * * * *";
+        }
+        else
+        {
+            error = "Unsupported macro " + name;
+            return false;
+        }
+
+        return parse(macro, error);
+    }
+
+    if (fields.size() == 5)
+    {
+        fields.insert(fields.begin(), "0");
+    }
+    else if (fields.size() != 6)
+    {
+        error = "Expected 5 or 6 fields";
+        return false;
+    }
+
+    const char* const fieldNames[] = {
+        "second", "minute", "hour", "day of month", "month", "day of week"
+    };
+
+    uint64_t daysOfWeek = 0;
+
+    const bool isFieldValid[] = {
+        parseField(fields[0], 0, 59, nullptr, 0, false, _seconds),
+        parseField(fields[1], 0, 59, nullptr, 0, false, _minutes),
+        parseField(fields[2], 0, 23, nullptr, 0, false, _hours),
+        parseField(fields[3], 1, 31, nullptr, 0, true, _daysOfMonth),
+        parseField(fields[4], 1, 12, MONTH_NAMES, 12, false, _months),
+        parseField(fields[5], 0, 7, WEEKDAY_NAMES, 7, true, daysOfWeek)
+    };
+
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        if (!isFieldValid[i])
+        {
+            error = "Invalid " + std::string(fieldNames[i]) + " field " + fields[i];
+            return false;
+        }
+    }
+
+    // Both 0 and 7 are Sunday.
+    _daysOfWeek = (daysOfWeek | (daysOfWeek >> 7)) & 0x7F;
+    _isAnyDayOfMonth = fields[3][0] == '*' || fields[3][0] == '?';
+    _isAnyDayOfWeek = fields[5][0] == '*' || fields[5][0] == '?';
+    _isFixedTime = fields[0][0] != '*' && fields[1][0] != '*' && fields[2][0] != '*';
+
+    return true;
+}
+
+
+bool CronSchedule::find(int64_t year,
+                        int month,
+                        int day,
+                        int secondOfDay,
+                        int64_t& fire) const
+{
+    const int64_t lastYear = year + 400;
+    const int64_t lastDay = std::numeric_limits<int64_t>::max() / MICROSECONDS_PER_SECOND / SECONDS_PER_DAY - 1;
+
+    int hour = secondOfDay / 3600;
+    int minute = secondOfDay / 60 % 60;
+    int second = secondOfDay % 60;
+
+    while (year <= lastYear)
+    {
+        if (((_months >> month) & 1) == 0 || day > 31)
+        {
+            const int nextMonth = nextBit(_months, ((_months >> month) & 1) == 0 ? month : month + 1);
+
+            if (nextMonth < 0)
+            {
+                ++year;
+                month = Bits::lowestBit(_months);
+            }
+            else
+            {
+                month = nextMonth;
+            }
+
+            day = 1;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        const int matchedDay = getNextDay(year, month, day);
+
+        if (matchedDay == 0)
+        {
+            // No day matches in the rest of this month.
+            day = 32;
+            continue;
+        }
+
+        if (matchedDay != day)
+        {
+            day = matchedDay;
+            hour = minute = second = 0;
+        }
+
+        const int matchedHour = nextBit(_hours, hour);
+
+        if (matchedHour < 0)
+        {
+            ++day;
+            hour = minute = second = 0;
+            continue;
+        }
+
+        if (matchedHour != hour)
+        {
+            hour = matchedHour;
+            minute = second = 0;
+        }
+
+        const int matchedMinute = nextBit(_minutes, minute);
+
+        if (matchedMinute < 0)
+        {
+            ++hour;
+            minute = second = 0;
+            continue;
+        }
+
+        if (matchedMinute != minute)
+        {
+            minute = matchedMinute;
+            second = 0;
+        }
+
+        const int matchedSecond = nextBit(_seconds, second);
+
+        if (matchedSecond < 0)
+        {
+            ++minute;
+            second = 0;
+            continue;
+        }
+
+        const int64_t days = Calendar::daysFromCivil(year, month, day);
+
+        if (days > lastDay)
+        {
+            return false;
+        }
+
+        fire = (days * SECONDS_PER_DAY
+              + hour * 3600
+              + minute * 60
+              + matchedSecond) * MICROSECONDS_PER_SECOND;
+
+        return true;
+    }
+
+    return false;
+}
+
+
+int CronSchedule::getNextDay(int64_t year, int month, int day) const
+{
+    const int length = Calendar::daysInMonth(year, month);
+    const int firstWeekday = Calendar::dayOfWeek(Calendar::daysFromCivil(year, month, 1));
+    const uint64_t daysOfWeek = _daysOfWeek | (_daysOfWeek << 7);
+
+    while (day <= length)
+    {
+        const int weekday = (firstWeekday + day - 1) % 7;
+        const int byWeekday = day + nextBit(daysOfWeek, weekday) - weekday;
+        int byMonthDay = nextBit(_daysOfMonth, day);
+
+        if (byMonthDay < 0)
+        {
+            byMonthDay = std::numeric_limits<int>::max();
+        }
+
+        if (!_isAnyDayOfMonth && !_isAnyDayOfWeek)
+        {
+            // Either field may match.
+            const int next = std::min(byMonthDay, byWeekday);
+            return next <= length ? next : 0;
+        }
+
+        // Both fields must match.
+        if (byMonthDay == byWeekday)
+        {
+            return byMonthDay <= length ? byMonthDay : 0;
+        }
+
+        day = std::max(byMonthDay, byWeekday);
+    }
+
+    return 0;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,273 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "Divider.h"
+#include "SIMD.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief Divide the 128 bit value (high, low) by divisor.
+///
+/// Only used when building a Divider, so a simple shift-subtract loop is
+/// sufficient.  Requires high < divisor so that the quotient fits in 64 bits.
+uint64_t divide128(uint64_t high, uint64_t low, uint64_t divisor, uint64_t& remainder)
+{
+    uint64_t quotient = 0;
+
+    for (int i = 63; i >= 0; --i)
+    {
+        uint64_t carry = high >> 63;
+        high = (high << 1) | ((low >> i) & 1);
+        quotient <<= 1;
+
+        if (carry || high >= divisor)
+        {
+            high -= divisor;
+            quotient |= 1;
+        }
+    }
+
+    remainder = high;
+    return quotient;
+}
+
+
+void divideMultiplyScalar(const Divider& divider,
+                          const int64_t* in,
+                          int64_t* out,
+                          std::size_t size,
+                          int64_t bias)
+{
+    uint64_t divisor = uint64_t(divider.divisor());
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        int64_t x = int64_t(uint64_t(in[i]) + uint64_t(bias));
+        out[i] = int64_t(uint64_t(divider.divide(x)) * divisor);
+    }
+}
+
+
+#if defined(OFX_TIME_HAVE_AVX2)
+
+
+/// \returns the high 64 bits of each 64 x 64 bit lane product.
+OFX_TIME_TARGET_AVX2 inline __m256i multiplyHigh(__m256i a, __m256i bLo, __m256i bHi)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i aHi = _mm256_srli_epi64(a, 32);
+    __m256i loLo = _mm256_mul_epu32(a, bLo);
+    __m256i loHi = _mm256_mul_epu32(a, bHi);
+    __m256i hiLo = _mm256_mul_epu32(aHi, bLo);
+    __m256i hiHi = _mm256_mul_epu32(aHi, bHi);
+    __m256i t = _mm256_add_epi64(hiLo, _mm256_srli_epi64(loLo, 32));
+    __m256i w = _mm256_add_epi64(_mm256_and_si256(t, mask), loHi);
+    return _mm256_add_epi64(_mm256_add_epi64(hiHi, _mm256_srli_epi64(t, 32)),
+                            _mm256_srli_epi64(w, 32));
+}
+
+
+/// \returns the low 64 bits of each 64 x 64 bit lane product.
+OFX_TIME_TARGET_AVX2 inline __m256i multiplyLow(__m256i a, __m256i bLo, __m256i bHi)
+{
+    __m256i aHi = _mm256_srli_epi64(a, 32);
+    __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a, bHi), _mm256_mul_epu32(aHi, bLo));
+    return _mm256_add_epi64(_mm256_mul_epu32(a, bLo), _mm256_slli_epi64(cross, 32));
+}
+
+
+OFX_TIME_TARGET_AVX2 void divideMultiplyAVX2(const Divider& divider,
+                                             uint64_t magic,
+                                             int shift,
+                                             const int64_t* in,
+                                             int64_t* out,
+                                             std::size_t size,
+                                             int64_t bias)
+{
+    const uint64_t divisor = uint64_t(divider.divisor());
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i biasV = _mm256_set1_epi64x(bias);
+    const __m256i magicLo = _mm256_set1_epi64x(int64_t(magic & 0xFFFFFFFF));
+    const __m256i magicHi = _mm256_set1_epi64x(int64_t(magic >> 32));
+    const __m256i divisorLo = _mm256_set1_epi64x(int64_t(divisor & 0xFFFFFFFF));
+    const __m256i divisorHi = _mm256_set1_epi64x(int64_t(divisor >> 32));
+    const __m128i shiftV = _mm_cvtsi32_si128(shift);
+
+    std::size_t i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m256i x = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), biasV);
+        __m256i sign = _mm256_cmpgt_epi64(zero, x);
+        __m256i magnitude = _mm256_sub_epi64(_mm256_xor_si256(x, sign), sign);
+        __m256i q = multiplyHigh(magnitude, magicLo, magicHi);
+        __m256i t = _mm256_add_epi64(_mm256_srli_epi64(_mm256_sub_epi64(magnitude, q), 1), q);
+        q = _mm256_srl_epi64(t, shiftV);
+        q = _mm256_sub_epi64(_mm256_xor_si256(q, sign), sign);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), multiplyLow(q, divisorLo, divisorHi));
+    }
+
+    divideMultiplyScalar(divider, in + i, out + i, size - i, bias);
+}
+
+
+#endif
+
+
+#if defined(OFX_TIME_HAVE_AVX512)
+
+
+// GCC reports false positives from within its own AVX-512 headers when the
+// intrinsics are used in target attribute functions (GCC bug 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+
+/// \returns the high 64 bits of each 64 x 64 bit lane product.
+OFX_TIME_TARGET_AVX512 inline __m512i multiplyHigh(__m512i a, __m512i bLo, __m512i bHi)
+{
+    const __m512i mask = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i aHi = _mm512_srli_epi64(a, 32);
+    __m512i loLo = _mm512_mul_epu32(a, bLo);
+    __m512i loHi = _mm512_mul_epu32(a, bHi);
+    __m512i hiLo = _mm512_mul_epu32(aHi, bLo);
+    __m512i hiHi = _mm512_mul_epu32(aHi, bHi);
+    __m512i t = _mm512_add_epi64(hiLo, _mm512_srli_epi64(loLo, 32));
+    __m512i w = _mm512_add_epi64(_mm512_and_si512(t, mask), loHi);
+    return _mm512_add_epi64(_mm512_add_epi64(hiHi, _mm512_srli_epi64(t, 32)),
+                            _mm512_srli_epi64(w, 32));
+}
+
+
+/// \returns the low 64 bits of each 64 x 64 bit lane product.
+OFX_TIME_TARGET_AVX512 inline __m512i multiplyLow(__m512i a, __m512i bLo, __m512i bHi)
+{
+    __m512i aHi = _mm512_srli_epi64(a, 32);
+    __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(a, bHi), _mm512_mul_epu32(aHi, bLo));
+    return _mm512_add_epi64(_mm512_mul_epu32(a, bLo), _mm512_slli_epi64(cross, 32));
+}
+
+
+OFX_TIME_TARGET_AVX512 void divideMultiplyAVX512(const Divider& divider,
+                                                 uint64_t magic,
+                                                 int shift,
+                                                 const int64_t* in,
+                                                 int64_t* out,
+                                                 std::size_t size,
+                                                 int64_t bias)
+{
+    const uint64_t divisor = uint64_t(divider.divisor());
+    const __m512i biasV = _mm512_set1_epi64(bias);
+    const __m512i magicLo = _mm512_set1_epi64(int64_t(magic & 0xFFFFFFFF));
+    const __m512i magicHi = _mm512_set1_epi64(int64_t(magic >> 32));
+    const __m512i divisorLo = _mm512_set1_epi64(int64_t(divisor & 0xFFFFFFFF));
+    const __m512i divisorHi = _mm512_set1_epi64(int64_t(divisor >> 32));
+    const __m128i shiftV = _mm_cvtsi32_si128(shift);
+
+    std::size_t i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        __m512i x = _mm512_add_epi64(_mm512_loadu_si512(in + i), biasV);
+        __m512i sign = _mm512_srai_epi64(x, 63);
+        __m512i magnitude = _mm512_sub_epi64(_mm512_xor_si512(x, sign), sign);
+        __m512i q = multiplyHigh(magnitude, magicLo, magicHi);
+        __m512i t = _mm512_add_epi64(_mm512_srli_epi64(_mm512_sub_epi64(magnitude, q), 1), q);
+        q = _mm512_srl_epi64(t, shiftV);
+        q = _mm512_sub_epi64(_mm512_xor_si512(q, sign), sign);
+        _mm512_storeu_si512(out + i, multiplyLow(q, divisorLo, divisorHi));
+    }
+
+    divideMultiplyScalar(divider, in + i, out + i, size - i, bias);
+}
+
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+
+#endif
+
+
+} // namespace
+
+
+Divider::Divider(int64_t divisor):
+    _divisor(divisor),
+    _magic(0),
+    _shift(0)
+{
+    uint64_t d = uint64_t(divisor);
+
+    int log2 = 63;
+
+    while (0 == (d >> log2))
+    {
+        --log2;
+    }
+
+    if (0 == (d & (d - 1)))
+    {
+        // Powers of two reduce to a shift: the multiply contributes nothing
+        // and the pre-shift in divide() supplies one of the bits.
+        _magic = 0;
+        _shift = log2 - 1;
+    }
+    else
+    {
+        uint64_t remainder = 0;
+        uint64_t proposed = divide128(uint64_t(1) << log2, 0, d, remainder);
+
+        proposed += proposed;
+        uint64_t twiceRemainder = remainder + remainder;
+
+        if (twiceRemainder >= d || twiceRemainder < remainder)
+        {
+            proposed += 1;
+        }
+
+        _magic = proposed + 1;
+        _shift = log2;
+    }
+}
+
+
+void Divider::divideMultiply(const int64_t* in,
+                             int64_t* out,
+                             std::size_t size,
+                             int64_t bias) const
+{
+#if defined(OFX_TIME_HAVE_AVX512)
+    if (SIMD::hasAVX512())
+    {
+        divideMultiplyAVX512(*this, _magic, _shift, in, out, size, bias);
+        return;
+    }
+#endif
+
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        divideMultiplyAVX2(*this, _magic, _shift, in, out, size, bias);
+        return;
+    }
+#endif
+
+    divideMultiplyScalar(*this, in, out, size, bias);
+}
+
+
+} } // namespace ofx::Time
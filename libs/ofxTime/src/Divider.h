@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Division by a runtime-invariant positive divisor.
+///
+/// The divisor is converted once into a multiply-shift reciprocal so that
+/// each division costs a multiply, a few shifts and adds rather than a
+/// hardware divide.  Results are identical to the `/` operator (truncation
+/// toward zero).  The reciprocal is the "branchfree" unsigned form described
+/// by libdivide, applied to the magnitude of the numerator.
+///
+/// For more information, please see:
+///   - https://libdivide.com
+///   - Granlund & Montgomery, "Division by Invariant Integers using
+///     Multiplication", PLDI 1994.
+class Divider
+{
+public:
+    /// \brief Create a Divider.
+    /// \param divisor The divisor, must be > 1.
+    explicit Divider(int64_t divisor);
+
+    /// \returns the divisor.
+    int64_t divisor() const
+    {
+        return _divisor;
+    }
+
+    /// \brief Divide an unsigned value.
+    /// \param numerator The numerator.
+    /// \returns numerator / divisor.
+    uint64_t divide(uint64_t numerator) const
+    {
+        uint64_t q = multiplyHigh(_magic, numerator);
+        return (((numerator - q) >> 1) + q) >> _shift;
+    }
+
+    /// \brief Divide a signed value, truncating toward zero.
+    /// \param numerator The numerator.
+    /// \returns numerator / divisor.
+    int64_t divide(int64_t numerator) const
+    {
+        uint64_t sign = uint64_t(numerator >> 63);
+        uint64_t magnitude = (uint64_t(numerator) ^ sign) - sign;
+        return int64_t((divide(magnitude) ^ sign) - sign);
+    }
+
+    /// \brief Compute `((in[i] + bias) / divisor) * divisor` for an array.
+    ///
+    /// This is the common form of Utils::floor(), ceiling() and round() for
+    /// Poco::Timespan values.  AVX2 or AVX-512 is used when available.  The
+    /// input and output may be the same array.
+    ///
+    /// \param in The input values.
+    /// \param out The output values.
+    /// \param size The number of values.
+    /// \param bias The value added to each input before dividing.
+    void divideMultiply(const int64_t* in,
+                        int64_t* out,
+                        std::size_t size,
+                        int64_t bias) const;
+
+    /// \returns the high 64 bits of the 128 bit product of a and b.
+    static uint64_t multiplyHigh(uint64_t a, uint64_t b)
+    {
+#if defined(__SIZEOF_INT128__)
+        // __int128 is a GNU extension, which -Wpedantic warns about.
+        __extension__ typedef unsigned __int128 uint128_t;
+        return uint64_t((static_cast<uint128_t>(a) * b) >> 64);
+#else
+        uint64_t aLo = a & 0xFFFFFFFF;
+        uint64_t aHi = a >> 32;
+        uint64_t bLo = b & 0xFFFFFFFF;
+        uint64_t bHi = b >> 32;
+        uint64_t t = aHi * bLo + ((aLo * bLo) >> 32);
+        uint64_t w = (t & 0xFFFFFFFF) + aLo * bHi;
+        return aHi * bHi + (t >> 32) + (w >> 32);
+#endif
+    }
+
+private:
+    /// \brief The divisor.
+    int64_t _divisor;
+
+    /// \brief The reciprocal multiplier.
+    uint64_t _magic;
+
+    /// \brief The final right shift.
+    int _shift;
+
+};
+
+
+} } // namespace ofx::Time
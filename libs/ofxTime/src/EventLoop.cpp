@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/EventLoop.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief The longest single wait in run(), in microseconds.
+///
+/// std::condition_variable::wait_for() converts to a nanosecond deadline,
+/// which overflows for waits of a few hundred years, so longer waits are
+/// made in steps.
+const Poco::Timestamp::TimeDiff MAX_WAIT = Poco::Timespan::HOURS;
+
+
+/// \brief The loop running on the current thread, if any.
+thread_local EventLoop* currentLoop = nullptr;
+
+
+/// \brief Sets the current loop for the lifetime of the object.
+class CurrentLoop
+{
+public:
+    CurrentLoop(EventLoop* loop): _previous(currentLoop)
+    {
+        currentLoop = loop;
+    }
+
+    ~CurrentLoop()
+    {
+        currentLoop = _previous;
+    }
+
+private:
+    EventLoop* _previous = nullptr;
+
+};
+
+
+} // namespace
+
+
+EventLoop::EventLoop(const Poco::Timespan& resolution):
+    _wheel(resolution)
+{
+}
+
+
+TimingWheel::Timer EventLoop::schedule(const Poco::Timestamp& deadline, Task task)
+{
+    TimingWheel::Timer timer = _wheel.schedule(deadline, [task](const Poco::Timestamp&) {
+        task();
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isChanged = true;
+    }
+
+    _condition.notify_one();
+    return timer;
+}
+
+
+bool EventLoop::cancel(TimingWheel::Timer timer)
+{
+    return _wheel.cancel(timer);
+}
+
+
+void EventLoop::post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+
+    _condition.notify_one();
+}
+
+
+std::size_t EventLoop::poll()
+{
+    CurrentLoop current(this);
+
+    std::vector<Task> tasks;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        tasks.swap(_tasks);
+    }
+
+    for (Task& task: tasks)
+    {
+        task();
+    }
+
+    return tasks.size() + _wheel.advance(Poco::Timestamp());
+}
+
+
+void EventLoop::run()
+{
+    CurrentLoop current(this);
+
+    for (;;)
+    {
+        poll();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_isStopping)
+        {
+            _isStopping = false;
+            return;
+        }
+
+        if (!_tasks.empty())
+        {
+            continue;
+        }
+
+        Poco::Timestamp next;
+
+        if (!_wheel.getNextTime(next))
+        {
+            return;
+        }
+
+        _isChanged = false;
+
+        const Poco::Timestamp::TimeDiff wait = std::min(next - Poco::Timestamp(), MAX_WAIT);
+
+        if (wait > 0)
+        {
+            _condition.wait_for(lock, std::chrono::microseconds(wait), [this]() {
+                return _isStopping || _isChanged || !_tasks.empty();
+            });
+        }
+    }
+}
+
+
+void EventLoop::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+
+    _condition.notify_one();
+}
+
+
+bool EventLoop::empty() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tasks.empty() && 0 == _wheel.size();
+}
+
+
+EventLoop& EventLoop::getCurrent()
+{
+    return currentLoop ? *currentLoop : getDefault();
+}
+
+
+EventLoop& EventLoop::getDefault()
+{
+    static EventLoop loop;
+    return loop;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,257 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "FieldExtractor.h"
+#include <algorithm>
+#include "SIMD.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+enum
+{
+    /// \brief The number of times processed per chunk.
+    CHUNK_SIZE = 256
+};
+
+
+/// \brief The number of 400 year eras added to every day number.
+///
+/// Any int64_t microsecond time is within about 300,000 years of the epoch,
+/// so after the shift every day number is positive and fits in 32 bits.
+constexpr uint32_t ERA_SHIFT = 10000;
+
+/// \brief The day shift for civil dates, 0000-03-01 is day 0.
+constexpr uint32_t CIVIL_SHIFT = 719468 + 146097 * ERA_SHIFT;
+
+/// \brief The day shift for weekdays, 1970-01-01 was a Thursday.
+constexpr uint32_t WEEKDAY_SHIFT = 7 * 300000000u + 4;
+
+
+/// \brief A chunk of times split into 32 bit parts.
+///
+/// Only the days are filled for date fields and only the seconds and
+/// microseconds for time fields.
+struct Chunk
+{
+    /// \brief The days since 1970-01-01.
+    int32_t days[CHUNK_SIZE];
+
+    /// \brief The seconds since the start of the day.
+    uint32_t seconds[CHUNK_SIZE];
+
+    /// \brief The microseconds since the start of the second.
+    uint32_t microseconds[CHUNK_SIZE];
+
+    /// \brief The extracted fields.
+    int32_t results[CHUNK_SIZE];
+};
+
+
+OFX_TIME_ALWAYS_INLINE void split(const int64_t* timestamps,
+                                  std::size_t size,
+                                  Calendar::Field field,
+                                  Chunk& chunk)
+{
+    if (field < Calendar::HOUR)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            chunk.days[i] = int32_t(Calendar::floorDivide(timestamps[i], Calendar::MICROSECONDS_PER_DAY));
+        }
+
+        std::fill(chunk.days + size, chunk.days + CHUNK_SIZE, 0);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            uint64_t time = uint64_t(timestamps[i] - Calendar::floorDivide(timestamps[i], Calendar::MICROSECONDS_PER_DAY) * Calendar::MICROSECONDS_PER_DAY);
+            uint64_t seconds = time / 1000000;
+            chunk.seconds[i] = uint32_t(seconds);
+            chunk.microseconds[i] = uint32_t(time - seconds * 1000000);
+        }
+
+        std::fill(chunk.seconds + size, chunk.seconds + CHUNK_SIZE, 0);
+        std::fill(chunk.microseconds + size, chunk.microseconds + CHUNK_SIZE, 0);
+    }
+}
+
+
+/// \brief The parts of Calendar::civilFromDays() in 32 bit arithmetic.
+struct Civil
+{
+    /// \brief The 400 year era, offset by ERA_SHIFT.
+    uint32_t era;
+
+    /// \brief The year of the era [0, 399], starting in March.
+    uint32_t yearOfEra;
+
+    /// \brief The day of the year [0, 365], starting March 1.
+    uint32_t dayOfYear;
+
+    /// \brief The month [0, 11], starting in March.
+    uint32_t shiftedMonth;
+};
+
+
+OFX_TIME_ALWAYS_INLINE Civil civil(int32_t days)
+{
+    const uint32_t z = uint32_t(days) + CIVIL_SHIFT;
+    const uint32_t era = z / 146097;
+    const uint32_t dayOfEra = z - era * 146097;
+    const uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    return Civil{ era, yearOfEra, dayOfYear, (5 * dayOfYear + 2) / 153 };
+}
+
+
+OFX_TIME_ALWAYS_INLINE void compute(Chunk& chunk, Calendar::Field field)
+{
+    switch(field)
+    {
+        case Calendar::YEAR:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                Civil c = civil(chunk.days[i]);
+                chunk.results[i] = int32_t(c.yearOfEra + c.era * 400 + (c.shiftedMonth >= 10)) - int32_t(400 * ERA_SHIFT);
+            }
+            break;
+        case Calendar::MONTH:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                Civil c = civil(chunk.days[i]);
+                chunk.results[i] = int32_t(c.shiftedMonth < 10 ? c.shiftedMonth + 3 : c.shiftedMonth - 9);
+            }
+            break;
+        case Calendar::DAY:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                Civil c = civil(chunk.days[i]);
+                chunk.results[i] = int32_t(c.dayOfYear - (153 * c.shiftedMonth + 2) / 5 + 1);
+            }
+            break;
+        case Calendar::DAY_OF_WEEK:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t((uint32_t(chunk.days[i]) + WEEKDAY_SHIFT) % 7);
+            }
+            break;
+        case Calendar::DAY_OF_YEAR:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                // January and February belong to the next year of the era,
+                // so only March onwards depends on the leap day.
+                Civil c = civil(chunk.days[i]);
+                uint32_t leap = (c.yearOfEra % 4 == 0) & ((c.yearOfEra % 100 != 0) | (c.yearOfEra == 0));
+                chunk.results[i] = int32_t(c.shiftedMonth >= 10 ? c.dayOfYear - 305 : c.dayOfYear + 60 + leap);
+            }
+            break;
+        case Calendar::HOUR:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t(chunk.seconds[i] / 3600);
+            }
+            break;
+        case Calendar::MINUTE:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t(chunk.seconds[i] / 60 % 60);
+            }
+            break;
+        case Calendar::SECOND:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t(chunk.seconds[i] % 60);
+            }
+            break;
+        case Calendar::MILLISECOND:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t(chunk.microseconds[i] / 1000);
+            }
+            break;
+        case Calendar::MICROSECOND:
+            for (int i = 0; i < CHUNK_SIZE; ++i)
+            {
+                chunk.results[i] = int32_t(chunk.microseconds[i] % 1000);
+            }
+            break;
+        default:
+            std::fill(chunk.results, chunk.results + CHUNK_SIZE, 0);
+            break;
+    }
+}
+
+
+OFX_TIME_ALWAYS_INLINE void extractChunks(const int64_t* timestamps,
+                                          int32_t* results,
+                                          std::size_t size,
+                                          Calendar::Field field)
+{
+    Chunk chunk;
+
+    for (std::size_t offset = 0; offset < size; offset += CHUNK_SIZE)
+    {
+        std::size_t count = std::min<std::size_t>(CHUNK_SIZE, size - offset);
+        split(timestamps + offset, count, field, chunk);
+        compute(chunk, field);
+        std::copy(chunk.results, chunk.results + count, results + offset);
+    }
+}
+
+
+void extractScalar(const int64_t* timestamps,
+                   int32_t* results,
+                   std::size_t size,
+                   Calendar::Field field)
+{
+    extractChunks(timestamps, results, size, field);
+}
+
+
+#if defined(OFX_TIME_HAVE_AVX2)
+
+
+OFX_TIME_TARGET_AVX2 void extractAVX2(const int64_t* timestamps,
+                                      int32_t* results,
+                                      std::size_t size,
+                                      Calendar::Field field)
+{
+    extractChunks(timestamps, results, size, field);
+}
+
+
+#endif
+
+
+} // namespace
+
+
+void FieldExtractor::extract(const int64_t* timestamps,
+                             int32_t* results,
+                             std::size_t size,
+                             Calendar::Field field)
+{
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        extractAVX2(timestamps, results, size, field);
+        return;
+    }
+#endif
+
+    extractScalar(timestamps, results, size, field);
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <stdint.h>
+#include "ofx/Time/Calendar.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Batch extraction of calendar fields from epoch microseconds.
+///
+/// Timestamps are processed in fixed-size chunks on the stack.  Each chunk
+/// is first split into day numbers and times of day with 64 bit arithmetic,
+/// then the requested field is computed with a 32 bit version of
+/// Calendar::civilFromDays().  The 32 bit loops have a constant trip count
+/// and no branches, so the compiler vectorises them; an AVX2 build of the
+/// same loops is selected at runtime when available.
+class FieldExtractor
+{
+public:
+    /// \brief Extract a field from an array of times.
+    /// \param timestamps The input times in microseconds since the epoch.
+    /// \param results The output field values.
+    /// \param size The number of values.
+    /// \param field The field to extract.
+    static void extract(const int64_t* timestamps,
+                        int32_t* results,
+                        std::size_t size,
+                        Calendar::Field field);
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/IncrementalFormat.h"
+#include <cstring>
+#include <memory>
+#include "ofx/Time/Calendar.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+IncrementalFormat::IncrementalFormat(const std::string& fmt,
+                                     int timeZoneDifferential):
+    _format(fmt),
+    _timeZoneDifferential(timeZoneDifferential)
+{
+}
+
+
+std::size_t IncrementalFormat::format(int64_t microseconds, char* buffer)
+{
+    update(microseconds);
+    std::memcpy(buffer, _text.data(), _text.size());
+    return _text.size();
+}
+
+
+const std::string& IncrementalFormat::format(const Poco::Timestamp& timestamp)
+{
+    update(timestamp.epochMicroseconds());
+    return _text;
+}
+
+
+const CompiledFormat& IncrementalFormat::getCompiledFormat() const
+{
+    return _format;
+}
+
+
+int IncrementalFormat::getTimeZoneDifferential() const
+{
+    return _timeZoneDifferential;
+}
+
+
+std::size_t IncrementalFormat::getMaxSize() const
+{
+    return _format.getMaxSize();
+}
+
+
+IncrementalFormat& IncrementalFormat::getThreadLocal(const std::string& fmt,
+                                                     int timeZoneDifferential)
+{
+    thread_local std::vector<std::unique_ptr<IncrementalFormat>> formats;
+
+    for (std::unique_ptr<IncrementalFormat>& format: formats)
+    {
+        if (format->_timeZoneDifferential == timeZoneDifferential
+         && format->_format.getFormat() == fmt)
+        {
+            return *format;
+        }
+    }
+
+    formats.push_back(std::unique_ptr<IncrementalFormat>(new IncrementalFormat(fmt, timeZoneDifferential)));
+    return *formats.back();
+}
+
+
+void IncrementalFormat::update(int64_t microseconds)
+{
+    // Split without forming days * MICROSECONDS_PER_DAY, which overflows
+    // for the earliest times.
+    int64_t days = microseconds / Calendar::MICROSECONDS_PER_DAY;
+    int64_t timeOfDay = microseconds % Calendar::MICROSECONDS_PER_DAY;
+
+    if (timeOfDay < 0)
+    {
+        timeOfDay += Calendar::MICROSECONDS_PER_DAY;
+        --days;
+    }
+
+    CompiledFormat::Fields values = _values;
+    CompiledFormat::setTime(values, timeOfDay);
+
+    if (_hasText && (days == _days || !_format.usesDate()))
+    {
+        // Every time of day token has a fixed width, so the tokens for the
+        // fields that changed are rewritten in place.
+        const Level level = values.hour != _values.hour ? LEVEL_HOUR
+                          : values.minute != _values.minute ? LEVEL_MINUTE
+                          : values.second != _values.second ? LEVEL_SECOND
+                          : values.millisecond != _values.millisecond
+                         || values.microsecond != _values.microsecond ? LEVEL_FRACTION
+                          : LEVEL_NONE;
+
+        if (level != LEVEL_NONE)
+        {
+            for (const Field& field: _fields)
+            {
+                if (field.level >= level)
+                {
+                    _format.write(field.token, values, &_text[field.offset], _timeZoneDifferential);
+                }
+            }
+
+            _values = values;
+        }
+
+        return;
+    }
+
+    if (_format.usesDate())
+    {
+        CompiledFormat::setDate(values, days);
+    }
+
+    _text.resize(_format.getMaxSize());
+    _fields.clear();
+
+    char* first = &_text[0];
+    char* out = first;
+
+    for (const CompiledFormat::Token& token: _format.getTokens())
+    {
+        switch(token.type)
+        {
+            case CompiledFormat::Token::HOUR:
+            case CompiledFormat::Token::HOUR_AMPM:
+            case CompiledFormat::Token::AMPM_LOWER:
+            case CompiledFormat::Token::AMPM_UPPER:
+                _fields.push_back({ token, LEVEL_HOUR, std::size_t(out - first) });
+                break;
+            case CompiledFormat::Token::MINUTE:
+                _fields.push_back({ token, LEVEL_MINUTE, std::size_t(out - first) });
+                break;
+            case CompiledFormat::Token::SECOND:
+                _fields.push_back({ token, LEVEL_SECOND, std::size_t(out - first) });
+                break;
+            case CompiledFormat::Token::SECOND_FRACTION:
+            case CompiledFormat::Token::MILLISECOND:
+            case CompiledFormat::Token::DECISECOND:
+            case CompiledFormat::Token::MICROSECOND:
+                _fields.push_back({ token, LEVEL_FRACTION, std::size_t(out - first) });
+                break;
+            default:
+                break;
+        }
+
+        out = _format.write(token, values, out, _timeZoneDifferential);
+    }
+
+    _text.resize(std::size_t(out - first));
+    _values = values;
+    _days = days;
+    _hasText = true;
+}
+
+
+} } // namespace ofx::Time
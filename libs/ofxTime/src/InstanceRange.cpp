@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/InstanceRange.h"
+#include <algorithm>
+#include <limits>
+#include "ofx/Time/Utils.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+InstanceRange::Iterator::Iterator()
+{
+}
+
+
+InstanceRange::Iterator::Iterator(const InstanceRange* range):
+    _range(range),
+    _current(range->_start),
+    _index(0)
+{
+}
+
+
+InstanceRange::Iterator::reference InstanceRange::Iterator::operator * () const
+{
+    return _current;
+}
+
+
+InstanceRange::Iterator::pointer InstanceRange::Iterator::operator -> () const
+{
+    return &_current;
+}
+
+
+InstanceRange::Iterator& InstanceRange::Iterator::operator ++ ()
+{
+    if (_range->_isFixed)
+    {
+        _current += _range->_step;
+    }
+    else
+    {
+        _current = Utils::add(_current, _range->_period);
+    }
+
+    ++_index;
+
+    return *this;
+}
+
+
+InstanceRange::Iterator InstanceRange::Iterator::operator ++ (int)
+{
+    Iterator iterator(*this);
+    ++(*this);
+    return iterator;
+}
+
+
+bool InstanceRange::Iterator::operator == (const Iterator& other) const
+{
+    bool isDone = done();
+    bool isOtherDone = other.done();
+
+    if (isDone || isOtherDone)
+    {
+        return isDone == isOtherDone;
+    }
+
+    return _range == other._range && _index == other._index;
+}
+
+
+bool InstanceRange::Iterator::operator != (const Iterator& other) const
+{
+    return !(*this == other);
+}
+
+
+bool InstanceRange::Iterator::done() const
+{
+    return nullptr == _range
+        || _index >= _range->_numInstances
+        || _current >= _range->_end;
+}
+
+
+InstanceRange::InstanceRange(const Poco::Timestamp& start,
+                             std::size_t numInstances,
+                             const Period& period):
+    _start(start),
+    _end(std::numeric_limits<Poco::Timestamp::TimeVal>::max()),
+    _numInstances(numInstances),
+    _period(period),
+    _isFixed(period.isFixed()),
+    _step(period.getFixedMicroseconds())
+{
+}
+
+
+InstanceRange::InstanceRange(const Poco::Timestamp& start,
+                             const Poco::Timespan& timespan,
+                             const Period& period):
+    InstanceRange(start, start + timespan.totalMicroseconds(), period)
+{
+}
+
+
+InstanceRange::InstanceRange(const Poco::Timestamp& start,
+                             const Poco::Timestamp& end,
+                             const Period& period):
+    _start(start),
+    _end(end),
+    _numInstances(std::numeric_limits<std::size_t>::max()),
+    _period(period),
+    _isFixed(period.isFixed()),
+    _step(period.getFixedMicroseconds())
+{
+}
+
+
+InstanceRange::InstanceRange(const Interval& interval, const Period& period):
+    InstanceRange(interval.getStart(), interval.getEnd(), period)
+{
+}
+
+
+InstanceRange::Iterator InstanceRange::begin() const
+{
+    return Iterator(this);
+}
+
+
+InstanceRange::Iterator InstanceRange::end() const
+{
+    return Iterator();
+}
+
+
+bool InstanceRange::empty() const
+{
+    return begin() == end();
+}
+
+
+std::size_t InstanceRange::size() const
+{
+    if (_isFixed && _step > 0)
+    {
+        if (_end <= _start)
+        {
+            return 0;
+        }
+
+        // Unsigned arithmetic keeps the span exact for any start and end.
+        uint64_t span = uint64_t(_end.epochMicroseconds()) - uint64_t(_start.epochMicroseconds());
+        uint64_t step = uint64_t(_step);
+        uint64_t count = span / step + (span % step != 0 ? 1 : 0);
+
+        return std::size_t(std::min<uint64_t>(count, _numInstances));
+    }
+
+    return std::size_t(std::distance(begin(), end()));
+}
+
+
+const Period& InstanceRange::getPeriod() const
+{
+    return _period;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,376 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/IntervalColumn.h"
+#include <iterator>
+#include "SIMD.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief Compute one bitmask word for up to 64 Intervals.
+inline uint64_t compareWordScalar(const int64_t* starts,
+                                  const int64_t* ends,
+                                  std::size_t size,
+                                  int64_t lower,
+                                  int64_t upper)
+{
+    uint64_t word = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        word |= uint64_t((starts[i] <= lower) & (ends[i] >= upper)) << i;
+    }
+
+    return word;
+}
+
+
+void compareScalar(const int64_t* starts,
+                   const int64_t* ends,
+                   std::size_t size,
+                   int64_t lower,
+                   int64_t upper,
+                   uint64_t* mask)
+{
+    for (std::size_t offset = 0; offset < size; offset += 64)
+    {
+        std::size_t count = size - offset < 64 ? size - offset : 64;
+        mask[offset / 64] = compareWordScalar(starts + offset, ends + offset, count, lower, upper);
+    }
+}
+
+
+void subtractScalar(const int64_t* starts,
+                    const int64_t* ends,
+                    std::size_t size,
+                    int64_t* results)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        results[i] = ends[i] - starts[i];
+    }
+}
+
+
+#if defined(OFX_TIME_HAVE_AVX2)
+
+
+OFX_TIME_TARGET_AVX2 void compareAVX2(const int64_t* starts,
+                                      const int64_t* ends,
+                                      std::size_t size,
+                                      int64_t lower,
+                                      int64_t upper,
+                                      uint64_t* mask)
+{
+    const __m256i lowerV = _mm256_set1_epi64x(lower);
+    const __m256i upperV = _mm256_set1_epi64x(upper);
+
+    std::size_t offset = 0;
+
+    for (; offset + 64 <= size; offset += 64)
+    {
+        uint64_t word = 0;
+
+        for (std::size_t i = 0; i < 64; i += 4)
+        {
+            __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(starts + offset + i));
+            __m256i end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ends + offset + i));
+
+            // A lane fails if start > lower or upper > end.
+            __m256i fail = _mm256_or_si256(_mm256_cmpgt_epi64(start, lowerV),
+                                           _mm256_cmpgt_epi64(upperV, end));
+
+            uint64_t bits = uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(fail)));
+            word |= (~bits & 0xF) << i;
+        }
+
+        mask[offset / 64] = word;
+    }
+
+    if (offset < size)
+    {
+        mask[offset / 64] = compareWordScalar(starts + offset, ends + offset, size - offset, lower, upper);
+    }
+}
+
+
+OFX_TIME_TARGET_AVX2 void subtractAVX2(const int64_t* starts,
+                                       const int64_t* ends,
+                                       std::size_t size,
+                                       int64_t* results)
+{
+    std::size_t i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m256i start = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(starts + i));
+        __m256i end = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ends + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), _mm256_sub_epi64(end, start));
+    }
+
+    subtractScalar(starts + i, ends + i, size - i, results + i);
+}
+
+
+#endif
+
+
+#if defined(OFX_TIME_HAVE_AVX512)
+
+
+OFX_TIME_TARGET_AVX512 void compareAVX512(const int64_t* starts,
+                                          const int64_t* ends,
+                                          std::size_t size,
+                                          int64_t lower,
+                                          int64_t upper,
+                                          uint64_t* mask)
+{
+    const __m512i lowerV = _mm512_set1_epi64(lower);
+    const __m512i upperV = _mm512_set1_epi64(upper);
+
+    std::size_t offset = 0;
+
+    for (; offset + 64 <= size; offset += 64)
+    {
+        uint64_t word = 0;
+
+        for (std::size_t i = 0; i < 64; i += 8)
+        {
+            __m512i start = _mm512_loadu_si512(starts + offset + i);
+            __m512i end = _mm512_loadu_si512(ends + offset + i);
+            __mmask8 bits = _mm512_cmple_epi64_mask(start, lowerV) & _mm512_cmpge_epi64_mask(end, upperV);
+            word |= uint64_t(bits) << i;
+        }
+
+        mask[offset / 64] = word;
+    }
+
+    if (offset < size)
+    {
+        mask[offset / 64] = compareWordScalar(starts + offset, ends + offset, size - offset, lower, upper);
+    }
+}
+
+
+#endif
+
+
+} // namespace
+
+
+IntervalColumn::IntervalColumn()
+{
+}
+
+
+IntervalColumn::IntervalColumn(const std::vector<Interval>& intervals)
+{
+    assign(intervals.data(), intervals.size());
+}
+
+
+void IntervalColumn::assign(const Interval* intervals, std::size_t size)
+{
+    _starts.resize(size);
+    _ends.resize(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        _starts[i] = intervals[i].getStartMicroseconds();
+        _ends[i] = intervals[i].getEndMicroseconds();
+    }
+}
+
+
+void IntervalColumn::push_back(const Interval& interval)
+{
+    _starts.push_back(interval.getStartMicroseconds());
+    _ends.push_back(interval.getEndMicroseconds());
+}
+
+
+void IntervalColumn::reserve(std::size_t size)
+{
+    _starts.reserve(size);
+    _ends.reserve(size);
+}
+
+
+void IntervalColumn::clear()
+{
+    _starts.clear();
+    _ends.clear();
+}
+
+
+std::size_t IntervalColumn::size() const
+{
+    return _starts.size();
+}
+
+
+bool IntervalColumn::empty() const
+{
+    return _starts.empty();
+}
+
+
+Interval IntervalColumn::operator [] (std::size_t index) const
+{
+    return Interval(_starts[index], _ends[index]);
+}
+
+
+const int64_t* IntervalColumn::getStarts() const
+{
+    return _starts.data();
+}
+
+
+const int64_t* IntervalColumn::getEnds() const
+{
+    return _ends.data();
+}
+
+
+std::vector<Interval> IntervalColumn::toIntervals() const
+{
+    std::vector<Interval> results(_starts.size());
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        results[i] = Interval(_starts[i], _ends[i]);
+    }
+
+    return results;
+}
+
+
+std::size_t IntervalColumn::getMaskSize() const
+{
+    return (_starts.size() + 63) / 64;
+}
+
+
+void IntervalColumn::contains(const Poco::Timestamp& time, uint64_t* mask) const
+{
+    compare(time.epochMicroseconds(), time.epochMicroseconds(), mask);
+}
+
+
+IntervalColumn::Mask IntervalColumn::contains(const Poco::Timestamp& time) const
+{
+    Mask mask(getMaskSize());
+    contains(time, mask.data());
+    return mask;
+}
+
+
+void IntervalColumn::contains(const Interval& interval, uint64_t* mask) const
+{
+    compare(interval.getStartMicroseconds(), interval.getEndMicroseconds(), mask);
+}
+
+
+IntervalColumn::Mask IntervalColumn::contains(const Interval& interval) const
+{
+    Mask mask(getMaskSize());
+    contains(interval, mask.data());
+    return mask;
+}
+
+
+void IntervalColumn::intersects(const Interval& interval, uint64_t* mask) const
+{
+    compare(interval.getEndMicroseconds(), interval.getStartMicroseconds(), mask);
+}
+
+
+IntervalColumn::Mask IntervalColumn::intersects(const Interval& interval) const
+{
+    Mask mask(getMaskSize());
+    intersects(interval, mask.data());
+    return mask;
+}
+
+
+void IntervalColumn::getTimespans(int64_t* timespans) const
+{
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        subtractAVX2(_starts.data(), _ends.data(), _starts.size(), timespans);
+        return;
+    }
+#endif
+
+    subtractScalar(_starts.data(), _ends.data(), _starts.size(), timespans);
+}
+
+
+std::vector<int64_t> IntervalColumn::getTimespans() const
+{
+    std::vector<int64_t> timespans(_starts.size());
+    getTimespans(timespans.data());
+    return timespans;
+}
+
+
+std::vector<std::size_t> IntervalColumn::toIndices(const Mask& mask)
+{
+    std::vector<std::size_t> results;
+    results.reserve(count(mask));
+    toIndices(mask.data(), mask.size(), std::back_inserter(results));
+    return results;
+}
+
+
+std::size_t IntervalColumn::count(const Mask& mask)
+{
+    std::size_t result = 0;
+
+    for (uint64_t word: mask)
+    {
+        for (; word != 0; word &= word - 1)
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+
+void IntervalColumn::compare(int64_t lower, int64_t upper, uint64_t* mask) const
+{
+#if defined(OFX_TIME_HAVE_AVX512)
+    if (SIMD::hasAVX512())
+    {
+        compareAVX512(_starts.data(), _ends.data(), _starts.size(), lower, upper, mask);
+        return;
+    }
+#endif
+
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        compareAVX2(_starts.data(), _ends.data(), _starts.size(), lower, upper, mask);
+        return;
+    }
+#endif
+
+    compareScalar(_starts.data(), _ends.data(), _starts.size(), lower, upper, mask);
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/IntervalIndex.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+IntervalIndex::IntervalIndex():
+    _rootLevel(-1)
+{
+}
+
+
+IntervalIndex::IntervalIndex(const std::vector<Interval>& intervals):
+    _rootLevel(-1)
+{
+    build(intervals);
+}
+
+
+void IntervalIndex::build(const std::vector<Interval>& intervals)
+{
+    build(intervals.data(), intervals.size());
+}
+
+
+void IntervalIndex::build(const Interval* intervals, std::size_t size)
+{
+    _nodes.resize(size);
+    _ends.resize(size);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        int64_t start = intervals[i].getStartMicroseconds();
+        int64_t end = intervals[i].getEndMicroseconds();
+        _nodes[i] = Node{ start, end, end, i };
+        _ends[i] = End{ end, i };
+    }
+
+    std::sort(_nodes.begin(), _nodes.end(), [](const Node& a, const Node& b) {
+        return a.start < b.start || (a.start == b.start && a.end < b.end);
+    });
+
+    std::sort(_ends.begin(), _ends.end(), [](const End& a, const End& b) {
+        return a.end < b.end;
+    });
+
+    _rootLevel = -1;
+
+    const int64_t n = int64_t(size);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    // Leaves are the even positions.  Each level k then covers the
+    // positions with k trailing one bits, whose children are x away.  The
+    // last node at each level may be missing a right subtree, which is
+    // stood in for by the largest end seen at the rightmost node so far.
+    int64_t lastIndex = 0;
+    int64_t last = 0;
+
+    for (int64_t i = 0; i < n; i += 2)
+    {
+        lastIndex = i;
+        last = _nodes[i].maxEnd = _nodes[i].end;
+    }
+
+    int level = 1;
+
+    for (; (int64_t(1) << level) <= n; ++level)
+    {
+        const int64_t x = int64_t(1) << (level - 1);
+        const int64_t step = x << 2;
+
+        for (int64_t i = (x << 1) - 1; i < n; i += step)
+        {
+            int64_t left = _nodes[i - x].maxEnd;
+            int64_t right = i + x < n ? _nodes[i + x].maxEnd : last;
+            _nodes[i].maxEnd = std::max(_nodes[i].end, std::max(left, right));
+        }
+
+        lastIndex = ((lastIndex >> level) & 1) ? lastIndex - x : lastIndex + x;
+
+        if (lastIndex < n && _nodes[lastIndex].maxEnd > last)
+        {
+            last = _nodes[lastIndex].maxEnd;
+        }
+    }
+
+    _rootLevel = level - 1;
+}
+
+
+void IntervalIndex::clear()
+{
+    _nodes.clear();
+    _ends.clear();
+    _rootLevel = -1;
+}
+
+
+std::size_t IntervalIndex::size() const
+{
+    return _nodes.size();
+}
+
+
+bool IntervalIndex::empty() const
+{
+    return _nodes.empty();
+}
+
+
+std::vector<std::size_t> IntervalIndex::stab(const Poco::Timestamp& time) const
+{
+    std::vector<std::size_t> results;
+    stab(time, std::back_inserter(results));
+    return results;
+}
+
+
+std::vector<std::size_t> IntervalIndex::overlap(const Interval& interval) const
+{
+    std::vector<std::size_t> results;
+    overlap(interval, std::back_inserter(results));
+    return results;
+}
+
+
+std::vector<std::size_t> IntervalIndex::nearest(const Poco::Timestamp& time,
+                                                std::size_t k) const
+{
+    std::vector<std::size_t> results;
+    results.reserve(std::min(k, _nodes.size()));
+    nearest(time, k, std::back_inserter(results));
+    return results;
+}
+
+
+} } // namespace ofx::Time
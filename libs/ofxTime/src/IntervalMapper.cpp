@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/IntervalMapper.h"
+#include <algorithm>
+#include "SIMD.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+#if defined(OFX_TIME_HAVE_AVX2)
+
+
+/// \brief Convert four int64_t lanes to correctly rounded doubles.
+///
+/// AVX2 has no 64 bit integer to double conversion, so the high and low
+/// parts are placed in the mantissas of two doubles with magic exponents,
+/// and then combined with a single rounding addition.
+OFX_TIME_TARGET_AVX2 inline __m256d toDouble(__m256i x)
+{
+    // 3 * 2^67 and 3 * 2^67 + 2^52.
+    const __m256d magicHigh = _mm256_set1_pd(442721857769029238784.0);
+    const __m256d magicAll = _mm256_set1_pd(442726361368656609280.0);
+    const __m256d magicLow = _mm256_set1_pd(4503599627370496.0);
+
+    __m256i high = _mm256_srai_epi32(x, 16);
+    high = _mm256_blend_epi16(high, _mm256_setzero_si256(), 0x33);
+    high = _mm256_add_epi64(high, _mm256_castpd_si256(magicHigh));
+    __m256i low = _mm256_blend_epi16(x, _mm256_castpd_si256(magicLow), 0x88);
+    __m256d highDouble = _mm256_sub_pd(_mm256_castsi256_pd(high), magicAll);
+    return _mm256_add_pd(highDouble, _mm256_castsi256_pd(low));
+}
+
+
+/// \brief Map four times.
+OFX_TIME_TARGET_AVX2 inline __m256d mapFour(const int64_t* timestamps,
+                                            __m256i start,
+                                            __m256d scale,
+                                            __m256d offset)
+{
+    __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(timestamps));
+    return _mm256_add_pd(_mm256_mul_pd(toDouble(_mm256_sub_epi64(t, start)), scale), offset);
+}
+
+
+OFX_TIME_TARGET_AVX2 std::size_t mapAVX2(const int64_t* timestamps,
+                                         double* results,
+                                         std::size_t size,
+                                         int64_t start,
+                                         double scale,
+                                         double offset,
+                                         double lower,
+                                         double upper,
+                                         bool clamp)
+{
+    const __m256i startV = _mm256_set1_epi64x(start);
+    const __m256d scaleV = _mm256_set1_pd(scale);
+    const __m256d offsetV = _mm256_set1_pd(offset);
+    const __m256d lowerV = _mm256_set1_pd(lower);
+    const __m256d upperV = _mm256_set1_pd(upper);
+
+    std::size_t i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m256d value = mapFour(timestamps + i, startV, scaleV, offsetV);
+
+        if (clamp)
+        {
+            value = _mm256_min_pd(_mm256_max_pd(value, lowerV), upperV);
+        }
+
+        _mm256_storeu_pd(results + i, value);
+    }
+
+    return i;
+}
+
+
+OFX_TIME_TARGET_AVX2 std::size_t mapAVX2(const int64_t* timestamps,
+                                         float* results,
+                                         std::size_t size,
+                                         int64_t start,
+                                         double scale,
+                                         double offset,
+                                         double lower,
+                                         double upper,
+                                         bool clamp)
+{
+    const __m256i startV = _mm256_set1_epi64x(start);
+    const __m256d scaleV = _mm256_set1_pd(scale);
+    const __m256d offsetV = _mm256_set1_pd(offset);
+    const __m256d lowerV = _mm256_set1_pd(lower);
+    const __m256d upperV = _mm256_set1_pd(upper);
+
+    std::size_t i = 0;
+
+    for (; i + 4 <= size; i += 4)
+    {
+        __m256d value = mapFour(timestamps + i, startV, scaleV, offsetV);
+
+        if (clamp)
+        {
+            value = _mm256_min_pd(_mm256_max_pd(value, lowerV), upperV);
+        }
+
+        _mm_storeu_ps(results + i, _mm256_cvtpd_ps(value));
+    }
+
+    return i;
+}
+
+
+#endif
+
+
+} // namespace
+
+
+IntervalMapper::IntervalMapper()
+{
+    set(Interval());
+}
+
+
+IntervalMapper::IntervalMapper(const Interval& interval,
+                               double outputMin,
+                               double outputMax,
+                               bool clamp)
+{
+    set(interval, outputMin, outputMax, clamp);
+}
+
+
+void IntervalMapper::set(const Interval& interval,
+                         double outputMin,
+                         double outputMax,
+                         bool clamp)
+{
+    _start = interval.getStartMicroseconds();
+    _end = interval.getEndMicroseconds();
+    _outputMin = outputMin;
+    _outputMax = outputMax;
+    _lower = std::min(outputMin, outputMax);
+    _upper = std::max(outputMin, outputMax);
+    _clamp = clamp;
+
+    double duration = double(_end - _start);
+    double range = outputMax - outputMin;
+
+    // An empty Interval or output range maps everything to the start.
+    _scale = duration > 0 ? range / duration : 0;
+    _inverseScale = range != 0 ? duration / range : 0;
+}
+
+
+Interval IntervalMapper::getInterval() const
+{
+    return Interval(_start, _end);
+}
+
+
+double IntervalMapper::getOutputMin() const
+{
+    return _outputMin;
+}
+
+
+double IntervalMapper::getOutputMax() const
+{
+    return _outputMax;
+}
+
+
+bool IntervalMapper::isClamped() const
+{
+    return _clamp;
+}
+
+
+void IntervalMapper::map(const int64_t* timestamps,
+                         double* results,
+                         std::size_t size) const
+{
+    std::size_t i = 0;
+
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        i = mapAVX2(timestamps, results, size, _start, _scale, _outputMin, _lower, _upper, _clamp);
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        results[i] = map(timestamps[i]);
+    }
+}
+
+
+void IntervalMapper::map(const int64_t* timestamps,
+                         float* results,
+                         std::size_t size) const
+{
+    std::size_t i = 0;
+
+#if defined(OFX_TIME_HAVE_AVX2)
+    if (SIMD::hasAVX2())
+    {
+        i = mapAVX2(timestamps, results, size, _start, _scale, _outputMin, _lower, _upper, _clamp);
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        results[i] = float(map(timestamps[i]));
+    }
+}
+
+
+void IntervalMapper::lerp(const double* values,
+                          int64_t* results,
+                          std::size_t size) const
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        results[i] = lerp(values[i]).epochMicroseconds();
+    }
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,366 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/IntervalSet.h"
+#include <algorithm>
+#include <limits>
+
+
+namespace ofx {
+namespace Time {
+
+
+IntervalSet::Iterator::Iterator()
+{
+}
+
+
+IntervalSet::Iterator::Iterator(std::map<int64_t, int64_t>::const_iterator iterator):
+    _iterator(iterator)
+{
+}
+
+
+IntervalSet::Iterator::reference IntervalSet::Iterator::operator * () const
+{
+    return Interval(_iterator->first, _iterator->second);
+}
+
+
+IntervalSet::Iterator& IntervalSet::Iterator::operator ++ ()
+{
+    ++_iterator;
+    return *this;
+}
+
+
+IntervalSet::Iterator IntervalSet::Iterator::operator ++ (int)
+{
+    Iterator iterator(*this);
+    ++(*this);
+    return iterator;
+}
+
+
+bool IntervalSet::Iterator::operator == (const Iterator& other) const
+{
+    return _iterator == other._iterator;
+}
+
+
+bool IntervalSet::Iterator::operator != (const Iterator& other) const
+{
+    return _iterator != other._iterator;
+}
+
+
+IntervalSet::IntervalSet()
+{
+}
+
+
+IntervalSet::IntervalSet(const std::vector<Interval>& intervals)
+{
+    std::vector<Interval> sorted(intervals);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (const Interval& interval: sorted)
+    {
+        append(interval.getStartMicroseconds(), interval.getEndMicroseconds());
+    }
+}
+
+
+void IntervalSet::insert(const Interval& interval)
+{
+    int64_t start = interval.getStartMicroseconds();
+    int64_t end = interval.getEndMicroseconds();
+
+    auto iter = _intervals.upper_bound(start);
+
+    // Merge with the preceding Interval.
+    if (iter != _intervals.begin())
+    {
+        auto previous = std::prev(iter);
+
+        if (touches(previous->second, start))
+        {
+            start = previous->first;
+            end = std::max(end, previous->second);
+            iter = _intervals.erase(previous);
+        }
+    }
+
+    // Merge with the following Intervals.
+    while (iter != _intervals.end() && touches(end, iter->first))
+    {
+        end = std::max(end, iter->second);
+        iter = _intervals.erase(iter);
+    }
+
+    _intervals.emplace_hint(iter, start, end);
+}
+
+
+void IntervalSet::erase(const Interval& interval)
+{
+    const int64_t start = interval.getStartMicroseconds();
+    const int64_t end = interval.getEndMicroseconds();
+
+    auto iter = _intervals.upper_bound(start);
+
+    // Trim or split the Interval that starts before the erased Interval.
+    if (iter != _intervals.begin())
+    {
+        auto previous = std::prev(iter);
+
+        if (previous->second >= start)
+        {
+            const int64_t previousEnd = previous->second;
+
+            if (previous->first < start)
+            {
+                previous->second = start - 1;
+            }
+            else
+            {
+                _intervals.erase(previous);
+            }
+
+            if (previousEnd > end)
+            {
+                _intervals.emplace_hint(iter, end + 1, previousEnd);
+                return;
+            }
+        }
+    }
+
+    // Remove or trim the Intervals that start within the erased Interval.
+    while (iter != _intervals.end() && iter->first <= end)
+    {
+        if (iter->second > end)
+        {
+            const int64_t remainingEnd = iter->second;
+            iter = _intervals.erase(iter);
+            _intervals.emplace_hint(iter, end + 1, remainingEnd);
+            return;
+        }
+
+        iter = _intervals.erase(iter);
+    }
+}
+
+
+void IntervalSet::clear()
+{
+    _intervals.clear();
+}
+
+
+bool IntervalSet::empty() const
+{
+    return _intervals.empty();
+}
+
+
+std::size_t IntervalSet::size() const
+{
+    return _intervals.size();
+}
+
+
+IntervalSet::Iterator IntervalSet::begin() const
+{
+    return Iterator(_intervals.begin());
+}
+
+
+IntervalSet::Iterator IntervalSet::end() const
+{
+    return Iterator(_intervals.end());
+}
+
+
+std::vector<Interval> IntervalSet::getIntervals() const
+{
+    return std::vector<Interval>(begin(), end());
+}
+
+
+bool IntervalSet::contains(const Poco::Timestamp& time) const
+{
+    return contains(Interval(time, time));
+}
+
+
+bool IntervalSet::contains(const Interval& interval) const
+{
+    auto iter = _intervals.upper_bound(interval.getStartMicroseconds());
+
+    return iter != _intervals.begin()
+        && std::prev(iter)->second >= interval.getEndMicroseconds();
+}
+
+
+bool IntervalSet::intersects(const Interval& interval) const
+{
+    auto iter = _intervals.upper_bound(interval.getEndMicroseconds());
+
+    return iter != _intervals.begin()
+        && std::prev(iter)->second >= interval.getStartMicroseconds();
+}
+
+
+std::vector<Interval> IntervalSet::gaps(const Interval& within) const
+{
+    std::vector<Interval> results;
+    gaps(within, std::back_inserter(results));
+    return results;
+}
+
+
+bool IntervalSet::operator == (const IntervalSet& other) const
+{
+    return _intervals == other._intervals;
+}
+
+
+bool IntervalSet::operator != (const IntervalSet& other) const
+{
+    return _intervals != other._intervals;
+}
+
+
+IntervalSet IntervalSet::setUnion(const IntervalSet& set0,
+                                  const IntervalSet& set1)
+{
+    IntervalSet result;
+
+    auto iter0 = set0._intervals.begin();
+    auto iter1 = set1._intervals.begin();
+
+    while (iter0 != set0._intervals.end() || iter1 != set1._intervals.end())
+    {
+        if (iter1 == set1._intervals.end()
+        || (iter0 != set0._intervals.end() && iter0->first <= iter1->first))
+        {
+            result.append(iter0->first, iter0->second);
+            ++iter0;
+        }
+        else
+        {
+            result.append(iter1->first, iter1->second);
+            ++iter1;
+        }
+    }
+
+    return result;
+}
+
+
+IntervalSet IntervalSet::setIntersection(const IntervalSet& set0,
+                                         const IntervalSet& set1)
+{
+    IntervalSet result;
+
+    auto iter0 = set0._intervals.begin();
+    auto iter1 = set1._intervals.begin();
+
+    while (iter0 != set0._intervals.end() && iter1 != set1._intervals.end())
+    {
+        int64_t start = std::max(iter0->first, iter1->first);
+        int64_t end = std::min(iter0->second, iter1->second);
+
+        if (start <= end)
+        {
+            result.append(start, end);
+        }
+
+        if (iter0->second < iter1->second)
+        {
+            ++iter0;
+        }
+        else
+        {
+            ++iter1;
+        }
+    }
+
+    return result;
+}
+
+
+IntervalSet IntervalSet::setDifference(const IntervalSet& set0,
+                                       const IntervalSet& set1)
+{
+    IntervalSet result;
+
+    auto iter1 = set1._intervals.begin();
+
+    for (const auto& interval: set0._intervals)
+    {
+        int64_t cursor = interval.first;
+        bool done = false;
+
+        while (iter1 != set1._intervals.end() && iter1->second < cursor)
+        {
+            ++iter1;
+        }
+
+        // An Interval of set1 that extends past this Interval may also
+        // overlap the next one, so it is not consumed.
+        for (auto iter = iter1; iter != set1._intervals.end() && iter->first <= interval.second; ++iter)
+        {
+            if (iter->first > cursor)
+            {
+                result.append(cursor, iter->first - 1);
+            }
+
+            if (iter->second >= interval.second)
+            {
+                done = true;
+                break;
+            }
+
+            cursor = iter->second + 1;
+        }
+
+        if (!done)
+        {
+            result.append(cursor, interval.second);
+        }
+    }
+
+    return result;
+}
+
+
+void IntervalSet::append(int64_t start, int64_t end)
+{
+    if (!_intervals.empty())
+    {
+        auto last = std::prev(_intervals.end());
+
+        if (touches(last->second, start))
+        {
+            last->second = std::max(last->second, end);
+            return;
+        }
+    }
+
+    _intervals.emplace_hint(_intervals.end(), start, end);
+}
+
+
+bool IntervalSet::touches(int64_t end, int64_t start)
+{
+    return start <= end
+        || (end != std::numeric_limits<int64_t>::max() && end + 1 == start);
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,286 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/LocalInstanceRange.h"
+#include <algorithm>
+#include <limits>
+#include "ofx/Time/Utils.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+LocalInstanceRange::Iterator::Iterator()
+{
+}
+
+
+LocalInstanceRange::Iterator::Iterator(const LocalInstanceRange* range):
+    _range(range),
+    _current(range->_start),
+    _local(range->_zone->toLocal(range->_start.epochMicroseconds())),
+    _index(0)
+{
+    resolve();
+}
+
+
+LocalInstanceRange::Iterator::reference LocalInstanceRange::Iterator::operator * () const
+{
+    return _current;
+}
+
+
+LocalInstanceRange::Iterator::pointer LocalInstanceRange::Iterator::operator -> () const
+{
+    return &_current;
+}
+
+
+LocalInstanceRange::Iterator& LocalInstanceRange::Iterator::operator ++ ()
+{
+    if (_hasLater)
+    {
+        _current = _later;
+        _hasLater = false;
+    }
+    else
+    {
+        step();
+        resolve();
+    }
+
+    ++_index;
+
+    return *this;
+}
+
+
+LocalInstanceRange::Iterator LocalInstanceRange::Iterator::operator ++ (int)
+{
+    Iterator iterator(*this);
+    ++(*this);
+    return iterator;
+}
+
+
+bool LocalInstanceRange::Iterator::operator == (const Iterator& other) const
+{
+    bool isDone = done();
+    bool isOtherDone = other.done();
+
+    if (isDone || isOtherDone)
+    {
+        return isDone == isOtherDone;
+    }
+
+    return _range == other._range && _index == other._index;
+}
+
+
+bool LocalInstanceRange::Iterator::operator != (const Iterator& other) const
+{
+    return !(*this == other);
+}
+
+
+int64_t LocalInstanceRange::Iterator::local() const
+{
+    return _local;
+}
+
+
+bool LocalInstanceRange::Iterator::done() const
+{
+    return nullptr == _range
+        || _index >= _range->_numInstances
+        || _current >= _range->_end;
+}
+
+
+void LocalInstanceRange::Iterator::step()
+{
+    if (_range->_isFixed)
+    {
+        _local += _range->_step;
+    }
+    else
+    {
+        _local = Utils::add(Poco::Timestamp(_local), _range->_period).epochMicroseconds();
+    }
+}
+
+
+void LocalInstanceRange::Iterator::resolve()
+{
+    for (;;)
+    {
+        // Most instances fall between the same two transitions as the last.
+        if (_local >= _first && _local < _last)
+        {
+            _current = _local - _offset;
+            return;
+        }
+
+        const TimeZone::Resolution resolution = _range->_zone->resolve(_local, _first, _last);
+
+        if (resolution.type == TimeZone::Resolution::UNIQUE)
+        {
+            _offset = int64_t(resolution.offsetBefore) * 1000000;
+            _current = _local - _offset;
+            return;
+        }
+
+        int64_t utc[2];
+
+        std::size_t count = resolution.toUtc(_local,
+                                             _range->_nonexistent,
+                                             _range->_ambiguous,
+                                             utc);
+
+        if (count > 0)
+        {
+            _current = utc[0];
+            _later = utc[1];
+            _hasLater = count == 2;
+            return;
+        }
+
+        // The local time is skipped.  A period that does not advance would
+        // never leave the transition, so it ends the range.
+        const int64_t previous = _local;
+
+        step();
+
+        if (_local <= previous)
+        {
+            _range = nullptr;
+            return;
+        }
+    }
+}
+
+
+LocalInstanceRange::LocalInstanceRange(const Poco::Timestamp& start,
+                                       std::size_t numInstances,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       TimeZone::NonexistentPolicy nonexistent,
+                                       TimeZone::AmbiguousPolicy ambiguous):
+    _start(start),
+    _end(std::numeric_limits<Poco::Timestamp::TimeVal>::max()),
+    _numInstances(numInstances),
+    _period(period),
+    _isFixed(period.isFixed()),
+    _step(period.getFixedMicroseconds()),
+    _zone(&zone),
+    _nonexistent(nonexistent),
+    _ambiguous(ambiguous)
+{
+}
+
+
+LocalInstanceRange::LocalInstanceRange(const Poco::Timestamp& start,
+                                       const Poco::Timespan& timespan,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       TimeZone::NonexistentPolicy nonexistent,
+                                       TimeZone::AmbiguousPolicy ambiguous):
+    LocalInstanceRange(start,
+                       start + timespan.totalMicroseconds(),
+                       period,
+                       zone,
+                       nonexistent,
+                       ambiguous)
+{
+}
+
+
+LocalInstanceRange::LocalInstanceRange(const Poco::Timestamp& start,
+                                       const Poco::Timestamp& end,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       TimeZone::NonexistentPolicy nonexistent,
+                                       TimeZone::AmbiguousPolicy ambiguous):
+    _start(start),
+    _end(end),
+    _numInstances(std::numeric_limits<std::size_t>::max()),
+    _period(period),
+    _isFixed(period.isFixed()),
+    _step(period.getFixedMicroseconds()),
+    _zone(&zone),
+    _nonexistent(nonexistent),
+    _ambiguous(ambiguous)
+{
+}
+
+
+LocalInstanceRange::LocalInstanceRange(const Interval& interval,
+                                       const Period& period,
+                                       const TimeZone& zone,
+                                       TimeZone::NonexistentPolicy nonexistent,
+                                       TimeZone::AmbiguousPolicy ambiguous):
+    LocalInstanceRange(interval.getStart(),
+                       interval.getEnd(),
+                       period,
+                       zone,
+                       nonexistent,
+                       ambiguous)
+{
+}
+
+
+LocalInstanceRange::Iterator LocalInstanceRange::begin() const
+{
+    return Iterator(this);
+}
+
+
+LocalInstanceRange::Iterator LocalInstanceRange::end() const
+{
+    return Iterator();
+}
+
+
+bool LocalInstanceRange::empty() const
+{
+    return begin() == end();
+}
+
+
+std::size_t LocalInstanceRange::size() const
+{
+    return std::size_t(std::distance(begin(), end()));
+}
+
+
+const Period& LocalInstanceRange::getPeriod() const
+{
+    return _period;
+}
+
+
+const TimeZone& LocalInstanceRange::getTimeZone() const
+{
+    return *_zone;
+}
+
+
+TimeZone::NonexistentPolicy LocalInstanceRange::getNonexistentPolicy() const
+{
+    return _nonexistent;
+}
+
+
+TimeZone::AmbiguousPolicy LocalInstanceRange::getAmbiguousPolicy() const
+{
+    return _ambiguous;
+}
+
+
+} } // namespace ofx::Time
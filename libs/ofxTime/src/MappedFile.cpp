@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+namespace ofx {
+namespace Time {
+
+
+MappedFile::MappedFile()
+{
+}
+
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+
+#if defined(_WIN32)
+
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    _mapping = mapping;
+    _data = static_cast<const char*>(data);
+    _size = std::size_t(size.QuadPart);
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    if (_data)
+    {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_mapping)
+    {
+        CloseHandle(_mapping);
+    }
+
+    _mapping = nullptr;
+    _data = nullptr;
+    _size = 0;
+}
+
+
+#else
+
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+
+    if (fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    if (status.st_size == 0)
+    {
+        ::close(file);
+        return true;
+    }
+
+    void* data = mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // The file is read front to back by each thread.
+    madvise(data, std::size_t(status.st_size), MADV_SEQUENTIAL);
+
+    _data = static_cast<const char*>(data);
+    _size = std::size_t(status.st_size);
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    if (_data)
+    {
+        munmap(const_cast<char*>(_data), _size);
+    }
+
+    _data = nullptr;
+    _size = 0;
+}
+
+
+#endif
+
+
+const char* MappedFile::data() const
+{
+    return _data;
+}
+
+
+std::size_t MappedFile::size() const
+{
+    return _size;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+#include <cstddef>
+#include <string>
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief A read-only memory mapping of a whole file.
+///
+/// The mapping is released when the MappedFile is destroyed.  Empty files
+/// are opened successfully with a null data() and a size() of zero.
+class MappedFile
+{
+public:
+    /// \brief Create a closed MappedFile.
+    MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    /// \brief Unmap the file.
+    ~MappedFile();
+
+    /// \brief Map a file.
+    /// \param path The path of the file.
+    /// \returns true iff the file was mapped.
+    bool open(const std::string& path);
+
+    /// \brief Unmap the file.
+    void close();
+
+    /// \returns the mapped contents.
+    const char* data() const;
+
+    /// \returns the number of mapped bytes.
+    std::size_t size() const;
+
+private:
+    /// \brief The mapped contents.
+    const char* _data = nullptr;
+
+    /// \brief The number of mapped bytes.
+    std::size_t _size = 0;
+
+#if defined(_WIN32)
+    /// \brief The file mapping handle.
+    void* _mapping = nullptr;
+#endif
+
+};
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,1280 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/RRule.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include "ofx/Time/Calendar.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+const int64_t MICROSECONDS_PER_SECOND = 1000000;
+const int64_t SECONDS_PER_DAY = 86400;
+
+
+/// \brief The number of instances buffered by an Iterator.
+const std::size_t ITERATOR_BUFFER_SIZE = 64;
+
+
+/// \brief The weekday names of BYDAY and WKST, indexed from Sunday.
+const char* const WEEKDAYS[] = { "SU", "MO", "TU", "WE", "TH", "FR", "SA" };
+
+
+/// \returns the day of the week of a name, or -1 if it is unknown.
+int parseWeekday(const std::string& text)
+{
+    for (int i = 0; i < 7; ++i)
+    {
+        if (text == WEEKDAYS[i])
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+bool parseInteger(const std::string& text, int& value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    const long result = std::strtol(text.c_str(), &end, 10);
+
+    if (*end != '\0'
+     || !std::isdigit(static_cast<unsigned char>(text.back()))
+     || result < std::numeric_limits<int>::min()
+     || result > std::numeric_limits<int>::max())
+    {
+        return false;
+    }
+
+    value = int(result);
+    return true;
+}
+
+
+/// \brief Parse a comma separated list of integers.
+///
+/// If isSigned is true, the absolute value of each integer must be in
+/// [minimum, maximum]; otherwise each integer must be in [minimum, maximum].
+bool parseList(const std::string& text,
+               int minimum,
+               int maximum,
+               bool isSigned,
+               std::vector<int>& values)
+{
+    std::size_t begin = 0;
+
+    for (;;)
+    {
+        const std::size_t end = text.find(',', begin);
+        int value = 0;
+
+        if (!parseInteger(text.substr(begin, end - begin), value))
+        {
+            return false;
+        }
+
+        const int magnitude = isSigned && value < 0 ? -value : value;
+
+        if (magnitude < minimum || magnitude > maximum)
+        {
+            return false;
+        }
+
+        values.push_back(value);
+
+        if (end == std::string::npos)
+        {
+            return true;
+        }
+
+        begin = end + 1;
+    }
+}
+
+
+/// \brief Parse a comma separated list of integers into a bitmask.
+template<typename Mask>
+bool parseMask(const std::string& text, int minimum, int maximum, Mask& mask)
+{
+    std::vector<int> values;
+
+    if (!parseList(text, minimum, maximum, false, values))
+    {
+        return false;
+    }
+
+    for (int value: values)
+    {
+        mask |= Mask(1) << value;
+    }
+
+    return true;
+}
+
+
+/// \brief Parse a DATE (YYYYMMDD) or DATE-TIME (YYYYMMDDTHHMMSS[Z]).
+///
+/// A DATE is read as the last microsecond of that day, so every instance
+/// on that day is included.
+bool parseUntil(const std::string& text, int64_t& until)
+{
+    const std::size_t size = text.size();
+
+    if (size != 8 && size != 15 && !(size == 16 && text[15] == 'Z'))
+    {
+        return false;
+    }
+
+    int fields[6] = { 0, 0, 0, 0, 0, 0 };
+    const std::size_t offsets[6] = { 0, 4, 6, 9, 11, 13 };
+    const std::size_t widths[6] = { 4, 2, 2, 2, 2, 2 };
+    const int numFields = size == 8 ? 3 : 6;
+
+    if (size > 8 && text[8] != 'T')
+    {
+        return false;
+    }
+
+    for (int i = 0; i < numFields; ++i)
+    {
+        for (std::size_t j = offsets[i]; j < offsets[i] + widths[i]; ++j)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(text[j])))
+            {
+                return false;
+            }
+
+            fields[i] = fields[i] * 10 + (text[j] - '0');
+        }
+    }
+
+    if (fields[1] < 1 || fields[1] > 12
+     || fields[2] < 1 || fields[2] > Calendar::daysInMonth(fields[0], fields[1])
+     || fields[3] > 23 || fields[4] > 59 || fields[5] > 59)
+    {
+        return false;
+    }
+
+    const int64_t day = Calendar::daysFromCivil(fields[0], fields[1], fields[2]);
+
+    if (numFields == 3)
+    {
+        until = (day + 1) * SECONDS_PER_DAY * MICROSECONDS_PER_SECOND - 1;
+    }
+    else
+    {
+        until = (day * SECONDS_PER_DAY
+              + fields[3] * 3600
+              + fields[4] * 60
+              + fields[5]) * MICROSECONDS_PER_SECOND;
+    }
+
+    return true;
+}
+
+
+/// \returns the smallest integer not less than numerator / denominator.
+inline int64_t ceilingDivide(int64_t numerator, int64_t denominator)
+{
+    return -Calendar::floorDivide(-numerator, denominator);
+}
+
+
+} // namespace
+
+
+RRule::Iterator::Iterator()
+{
+}
+
+
+RRule::Iterator::Iterator(const RRule* rule, int64_t from):
+    _rule(rule)
+{
+    load(from);
+}
+
+
+RRule::Iterator::reference RRule::Iterator::operator * () const
+{
+    return _current;
+}
+
+
+RRule::Iterator::pointer RRule::Iterator::operator -> () const
+{
+    return &_current;
+}
+
+
+RRule::Iterator& RRule::Iterator::operator ++ ()
+{
+    if (++_position < _instances.size())
+    {
+        _current = _instances[_position];
+    }
+    else if (_instances.back() == std::numeric_limits<int64_t>::max())
+    {
+        _rule = nullptr;
+    }
+    else
+    {
+        load(_instances.back() + 1);
+    }
+
+    return *this;
+}
+
+
+RRule::Iterator RRule::Iterator::operator ++ (int)
+{
+    Iterator iterator(*this);
+    ++(*this);
+    return iterator;
+}
+
+
+bool RRule::Iterator::operator == (const Iterator& other) const
+{
+    if (nullptr == _rule || nullptr == other._rule)
+    {
+        return _rule == other._rule;
+    }
+
+    return _rule == other._rule && _current == other._current;
+}
+
+
+bool RRule::Iterator::operator != (const Iterator& other) const
+{
+    return !(*this == other);
+}
+
+
+void RRule::Iterator::load(int64_t from)
+{
+    if (!_rule->seek(from, _instances, ITERATOR_BUFFER_SIZE))
+    {
+        _rule = nullptr;
+        return;
+    }
+
+    _position = 0;
+    _current = _instances.front();
+}
+
+
+RRule::RRule()
+{
+}
+
+
+RRule::RRule(const Poco::Timestamp& start, const std::string& rule):
+    _start(start)
+{
+    std::string error;
+
+    if (!parse(rule, error))
+    {
+        ofLogError("RRule::RRule") << error << ": " << rule;
+        return;
+    }
+
+    _valid = true;
+
+    applyDefaults();
+
+    // Resolve the COUNT into the time of the last instance, so that later
+    // queries do not have to count the instances before them.
+    std::vector<int64_t> instances;
+
+    if (!seek(_start.epochMicroseconds(), instances, 1))
+    {
+        _until = std::numeric_limits<int64_t>::min();
+    }
+    else if (_count > 0)
+    {
+        std::size_t index = 0;
+
+        for (Iterator iter = begin(); iter != end(); ++iter)
+        {
+            if (++index == _count)
+            {
+                _until = iter->epochMicroseconds();
+                break;
+            }
+        }
+    }
+}
+
+
+bool RRule::isValid() const
+{
+    return _valid;
+}
+
+
+const Poco::Timestamp& RRule::getStart() const
+{
+    return _start;
+}
+
+
+RRule::Frequency RRule::getFrequency() const
+{
+    return _frequency;
+}
+
+
+int RRule::getInterval() const
+{
+    return _interval;
+}
+
+
+std::size_t RRule::getCount() const
+{
+    return _count;
+}
+
+
+Poco::Timestamp RRule::getUntil() const
+{
+    return Poco::Timestamp(_until);
+}
+
+
+void RRule::addExclusion(const Poco::Timestamp& time)
+{
+    const int64_t microseconds = time.epochMicroseconds();
+
+    std::vector<int64_t>::iterator iter = std::lower_bound(_exclusions.begin(),
+                                                           _exclusions.end(),
+                                                           microseconds);
+
+    if (iter == _exclusions.end() || *iter != microseconds)
+    {
+        _exclusions.insert(iter, microseconds);
+    }
+}
+
+
+void RRule::setExclusions(const std::vector<Poco::Timestamp>& times)
+{
+    _exclusions.clear();
+    _exclusions.reserve(times.size());
+
+    for (const Poco::Timestamp& time: times)
+    {
+        _exclusions.push_back(time.epochMicroseconds());
+    }
+
+    std::sort(_exclusions.begin(), _exclusions.end());
+    _exclusions.erase(std::unique(_exclusions.begin(), _exclusions.end()),
+                      _exclusions.end());
+}
+
+
+const std::vector<int64_t>& RRule::getExclusions() const
+{
+    return _exclusions;
+}
+
+
+bool RRule::next(int64_t after, int64_t& instance) const
+{
+    if (after == std::numeric_limits<int64_t>::max())
+    {
+        return false;
+    }
+
+    std::vector<int64_t> instances;
+
+    if (!seek(after + 1, instances, 1))
+    {
+        return false;
+    }
+
+    instance = instances.front();
+    return true;
+}
+
+
+bool RRule::next(const Poco::Timestamp& after, Poco::Timestamp& instance) const
+{
+    int64_t microseconds = 0;
+
+    if (!next(after.epochMicroseconds(), microseconds))
+    {
+        return false;
+    }
+
+    instance = microseconds;
+    return true;
+}
+
+
+std::vector<Poco::Timestamp> RRule::getInstances(const Poco::Timestamp& start,
+                                                 const Poco::Timestamp& end) const
+{
+    std::vector<Poco::Timestamp> instances;
+
+    for (Iterator iter = begin(start); iter != this->end() && *iter < end; ++iter)
+    {
+        instances.push_back(*iter);
+    }
+
+    return instances;
+}
+
+
+RRule::Iterator RRule::begin() const
+{
+    return begin(_start);
+}
+
+
+RRule::Iterator RRule::begin(const Poco::Timestamp& time) const
+{
+    if (!_valid)
+    {
+        return Iterator();
+    }
+
+    return Iterator(this, time.epochMicroseconds());
+}
+
+
+RRule::Iterator RRule::end() const
+{
+    return Iterator();
+}
+
+
+bool RRule::parse(const std::string& rule, std::string& error)
+{
+    std::string text(rule);
+
+    std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+        return char(std::toupper(static_cast<unsigned char>(c)));
+    });
+
+    if (text.compare(0, 6, "RRULE:") == 0)
+    {
+        text.erase(0, 6);
+    }
+
+    std::set<std::string> names;
+    bool hasFrequency = false;
+    bool hasUntil = false;
+    std::size_t begin = 0;
+
+    while (begin <= text.size())
+    {
+        std::size_t end = text.find(';', begin);
+
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+
+        const std::string part = text.substr(begin, end - begin);
+        begin = end + 1;
+
+        if (part.empty())
+        {
+            continue;
+        }
+
+        const std::size_t equals = part.find('=');
+
+        if (equals == std::string::npos)
+        {
+            error = "Missing value for " + part;
+            return false;
+        }
+
+        const std::string name = part.substr(0, equals);
+        const std::string value = part.substr(equals + 1);
+
+        if (!names.insert(name).second)
+        {
+            error = "Duplicate " + name;
+            return false;
+        }
+
+        bool isValidPart = true;
+
+        if (name == "FREQ")
+        {
+            const char* const frequencies[] = {
+                "SECONDLY", "MINUTELY", "HOURLY", "DAILY", "WEEKLY", "MONTHLY", "YEARLY"
+            };
+
+            isValidPart = false;
+
+            for (int i = 0; i < 7; ++i)
+            {
+                if (value == frequencies[i])
+                {
+                    _frequency = Frequency(i);
+                    isValidPart = true;
+                }
+            }
+
+            hasFrequency = isValidPart;
+        }
+        else if (name == "INTERVAL")
+        {
+            isValidPart = parseInteger(value, _interval) && _interval > 0;
+        }
+        else if (name == "COUNT")
+        {
+            int count = 0;
+            isValidPart = parseInteger(value, count) && count > 0;
+            _count = std::size_t(count);
+        }
+        else if (name == "UNTIL")
+        {
+            isValidPart = parseUntil(value, _until);
+            hasUntil = true;
+        }
+        else if (name == "BYSECOND")
+        {
+            isValidPart = parseMask(value, 0, 59, _bySecond);
+        }
+        else if (name == "BYMINUTE")
+        {
+            isValidPart = parseMask(value, 0, 59, _byMinute);
+        }
+        else if (name == "BYHOUR")
+        {
+            isValidPart = parseMask(value, 0, 23, _byHour);
+        }
+        else if (name == "BYDAY")
+        {
+            std::size_t dayBegin = 0;
+
+            while (isValidPart)
+            {
+                const std::size_t dayEnd = value.find(',', dayBegin);
+                const std::string day = value.substr(dayBegin, dayEnd - dayBegin);
+
+                if (day.size() < 2)
+                {
+                    isValidPart = false;
+                    break;
+                }
+
+                OrdinalWeekday weekday;
+                weekday.weekday = parseWeekday(day.substr(day.size() - 2));
+
+                if (weekday.weekday < 0)
+                {
+                    isValidPart = false;
+                }
+                else if (day.size() == 2)
+                {
+                    _byWeekday |= 1u << weekday.weekday;
+                }
+                else
+                {
+                    isValidPart = parseInteger(day.substr(0, day.size() - 2), weekday.ordinal)
+                               && weekday.ordinal != 0
+                               && std::abs(weekday.ordinal) <= 53;
+                    _byOrdinalWeekday.push_back(weekday);
+                }
+
+                if (dayEnd == std::string::npos)
+                {
+                    break;
+                }
+
+                dayBegin = dayEnd + 1;
+            }
+        }
+        else if (name == "BYMONTHDAY")
+        {
+            std::vector<int> days;
+            isValidPart = parseList(value, 1, 31, true, days);
+
+            for (int day: days)
+            {
+                if (day > 0)
+                {
+                    _byMonthDay |= 1u << day;
+                }
+                else
+                {
+                    _byNegativeMonthDay |= 1u << -day;
+                }
+            }
+        }
+        else if (name == "BYYEARDAY")
+        {
+            isValidPart = parseList(value, 1, 366, true, _byYearDay);
+        }
+        else if (name == "BYWEEKNO")
+        {
+            isValidPart = parseList(value, 1, 53, true, _byWeekNo);
+        }
+        else if (name == "BYMONTH")
+        {
+            isValidPart = parseMask(value, 1, 12, _byMonth);
+        }
+        else if (name == "BYSETPOS")
+        {
+            isValidPart = parseList(value, 1, 366, true, _bySetPos);
+        }
+        else if (name == "WKST")
+        {
+            _weekStart = parseWeekday(value);
+            isValidPart = _weekStart >= 0;
+        }
+        else
+        {
+            error = "Unknown rule part " + name;
+            return false;
+        }
+
+        if (!isValidPart)
+        {
+            error = "Invalid " + name + " value " + value;
+            return false;
+        }
+    }
+
+    if (!hasFrequency)
+    {
+        error = "Missing FREQ";
+        return false;
+    }
+
+    if (_count > 0 && hasUntil)
+    {
+        error = "COUNT and UNTIL cannot both be specified";
+        return false;
+    }
+
+    if (!_byOrdinalWeekday.empty() && _frequency != MONTHLY && _frequency != YEARLY)
+    {
+        error = "BYDAY ordinals require FREQ=MONTHLY or FREQ=YEARLY";
+        return false;
+    }
+
+    if (!_byWeekNo.empty() && _frequency != YEARLY)
+    {
+        error = "BYWEEKNO requires FREQ=YEARLY";
+        return false;
+    }
+
+    if (!_byWeekNo.empty() && !_byOrdinalWeekday.empty())
+    {
+        error = "BYDAY ordinals cannot be combined with BYWEEKNO";
+        return false;
+    }
+
+    return true;
+}
+
+
+void RRule::applyDefaults()
+{
+    const int64_t start = _start.epochMicroseconds();
+    const int64_t startSeconds = Calendar::floorDivide(start, MICROSECONDS_PER_SECOND);
+    const int64_t startDay = Calendar::floorDivide(startSeconds, SECONDS_PER_DAY);
+    const int64_t secondOfDay = startSeconds - startDay * SECONDS_PER_DAY;
+    const Calendar::Date date = Calendar::civilFromDays(startDay);
+
+    _fraction = start - startSeconds * MICROSECONDS_PER_SECOND;
+    _startUnit = getUnit(startSeconds);
+    _lastPeriod = Calendar::floorDivide(getUnit(std::numeric_limits<int64_t>::max() / MICROSECONDS_PER_SECOND) - _startUnit,
+                                        _interval);
+
+    const bool hasDayRule = !_byWeekNo.empty()
+                         || !_byYearDay.empty()
+                         || _byMonthDay != 0
+                         || _byNegativeMonthDay != 0
+                         || _byWeekday != 0
+                         || !_byOrdinalWeekday.empty();
+
+    if (!hasDayRule)
+    {
+        switch(_frequency)
+        {
+            case YEARLY:
+                if (_byMonth == 0)
+                {
+                    _byMonth = 1u << date.month;
+                }
+                _byMonthDay = 1u << date.day;
+                break;
+            case MONTHLY:
+                _byMonthDay = 1u << date.day;
+                break;
+            case WEEKLY:
+                _byWeekday = 1u << Calendar::dayOfWeek(startDay);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Time fields coarser than the FREQ default to the start.  Those at or
+    // finer than the FREQ limit the start of each period instead.
+    if (_frequency > HOURLY && _byHour == 0)
+    {
+        _byHour = 1u << (secondOfDay / 3600);
+    }
+
+    if (_frequency > MINUTELY && _byMinute == 0)
+    {
+        _byMinute = uint64_t(1) << (secondOfDay / 60 % 60);
+    }
+
+    if (_frequency > SECONDLY && _bySecond == 0)
+    {
+        _bySecond = uint64_t(1) << (secondOfDay % 60);
+    }
+
+    _times.clear();
+
+    for (int hour = 0; hour < (_frequency > HOURLY ? 24 : 1); ++hour)
+    {
+        if (_frequency > HOURLY && ((_byHour >> hour) & 1) == 0)
+        {
+            continue;
+        }
+
+        for (int minute = 0; minute < (_frequency > MINUTELY ? 60 : 1); ++minute)
+        {
+            if (_frequency > MINUTELY && ((_byMinute >> minute) & 1) == 0)
+            {
+                continue;
+            }
+
+            for (int second = 0; second < (_frequency > SECONDLY ? 60 : 1); ++second)
+            {
+                if (_frequency > SECONDLY && ((_bySecond >> second) & 1) == 0)
+                {
+                    continue;
+                }
+
+                _times.push_back(hour * 3600 + minute * 60 + second);
+            }
+        }
+    }
+
+    // A sub-daily period starts at a time of day that repeats with the
+    // period's step.  If none of those times match, there are no instances.
+    if (_frequency < DAILY)
+    {
+        // Every matching sub-daily period has the same times, so BYSETPOS
+        // can be applied to them once.
+        if (!_bySetPos.empty())
+        {
+            const int64_t size = int64_t(_times.size());
+            std::vector<int> times;
+
+            for (int position: _bySetPos)
+            {
+                const int64_t index = position > 0 ? position - 1 : size + position;
+
+                if (index >= 0 && index < size)
+                {
+                    times.push_back(_times[std::size_t(index)]);
+                }
+            }
+
+            std::sort(times.begin(), times.end());
+            times.erase(std::unique(times.begin(), times.end()), times.end());
+
+            _times = times;
+            _bySetPos.clear();
+        }
+
+        const int64_t unitSeconds = _frequency == HOURLY ? 3600 : (_frequency == MINUTELY ? 60 : 1);
+        const int64_t firstSecond = getUnitStart(_startUnit);
+        int64_t a = (unitSeconds * _interval) % SECONDS_PER_DAY;
+        int64_t b = SECONDS_PER_DAY;
+
+        while (a != 0)
+        {
+            const int64_t t = b % a;
+            b = a;
+            a = t;
+        }
+
+        bool hasTime = false;
+
+        for (int64_t second = firstSecond - Calendar::floorDivide(firstSecond, b) * b; second < SECONDS_PER_DAY && !hasTime; second += b)
+        {
+            int64_t next = 0;
+            hasTime = matchesTime(second, next);
+        }
+
+        if (!hasTime)
+        {
+            _times.clear();
+        }
+    }
+}
+
+
+int64_t RRule::getUnit(int64_t seconds) const
+{
+    switch(_frequency)
+    {
+        case SECONDLY:
+            return seconds;
+        case MINUTELY:
+            return Calendar::floorDivide(seconds, 60);
+        case HOURLY:
+            return Calendar::floorDivide(seconds, 3600);
+        default:
+            break;
+    }
+
+    const int64_t day = Calendar::floorDivide(seconds, SECONDS_PER_DAY);
+
+    switch(_frequency)
+    {
+        case DAILY:
+            return day;
+        case WEEKLY:
+            // Day 0 is a Thursday, so day (_weekStart + 3) % 7 is a WKST.
+            return Calendar::floorDivide(day - (_weekStart + 3) % 7, 7);
+        case MONTHLY:
+        {
+            const Calendar::Date date = Calendar::civilFromDays(day);
+            return date.year * 12 + date.month - 1;
+        }
+        default:
+            return Calendar::civilFromDays(day).year;
+    }
+}
+
+
+int64_t RRule::getUnitStart(int64_t unit) const
+{
+    switch(_frequency)
+    {
+        case SECONDLY:
+            return unit;
+        case MINUTELY:
+            return unit * 60;
+        case HOURLY:
+            return unit * 3600;
+        case DAILY:
+            return unit * SECONDS_PER_DAY;
+        case WEEKLY:
+            return (unit * 7 + (_weekStart + 3) % 7) * SECONDS_PER_DAY;
+        case MONTHLY:
+        {
+            const int64_t year = Calendar::floorDivide(unit, 12);
+            const int month = int(unit - year * 12) + 1;
+            return Calendar::daysFromCivil(year, month, 1) * SECONDS_PER_DAY;
+        }
+        default:
+            return Calendar::daysFromCivil(unit, 1, 1) * SECONDS_PER_DAY;
+    }
+}
+
+
+int64_t RRule::getPeriodAtOrAfter(int64_t unit, int64_t period) const
+{
+    return std::max(period, ceilingDivide(unit - _startUnit, _interval));
+}
+
+
+bool RRule::seek(int64_t from,
+                 std::vector<int64_t>& instances,
+                 std::size_t limit) const
+{
+    instances.clear();
+
+    if (!_valid || _times.empty() || from > _until)
+    {
+        return false;
+    }
+
+    from = std::max(from, _start.epochMicroseconds());
+
+    // The calendar repeats every 400 years, so a rule that has no instance
+    // in one cycle of periods after "from" has no instance after it at all.
+    int64_t cycle = 0;
+
+    switch(_frequency)
+    {
+        case SECONDLY: cycle = 146097 * SECONDS_PER_DAY; break;
+        case MINUTELY: cycle = 146097 * 1440; break;
+        case HOURLY: cycle = 146097 * 24; break;
+        case DAILY: cycle = 146097; break;
+        case WEEKLY: cycle = 146097 / 7; break;
+        case MONTHLY: cycle = 4800; break;
+        case YEARLY: cycle = 400; break;
+    }
+
+    int64_t period = std::max(int64_t(0),
+                              Calendar::floorDivide(getUnit(Calendar::floorDivide(from, MICROSECONDS_PER_SECOND)) - _startUnit,
+                                                    _interval));
+
+    const int64_t lastPeriod = std::min(_lastPeriod, period + cycle);
+
+    while (period <= lastPeriod)
+    {
+        int64_t nextPeriod = period + 1;
+
+        if (!expand(period, from, instances, nextPeriod, limit))
+        {
+            return false;
+        }
+
+        if (!instances.empty())
+        {
+            return true;
+        }
+
+        period = nextPeriod;
+    }
+
+    return false;
+}
+
+
+bool RRule::expand(int64_t period,
+                   int64_t from,
+                   std::vector<int64_t>& instances,
+                   int64_t& nextPeriod,
+                   std::size_t limit) const
+{
+    instances.clear();
+    nextPeriod = period + 1;
+
+    const int64_t unit = _startUnit + period * _interval;
+    const int64_t unitStart = getUnitStart(unit);
+
+    if (unitStart > Calendar::floorDivide(_until, MICROSECONDS_PER_SECOND))
+    {
+        return false;
+    }
+
+    const bool hasSetPos = !_bySetPos.empty();
+    const int64_t lastSecond = (std::numeric_limits<int64_t>::max() - _fraction) / MICROSECONDS_PER_SECOND;
+    bool isDone = false;
+
+    // Without BYSETPOS each candidate is filtered as it is found.  With
+    // BYSETPOS the whole period is needed to count positions.
+    auto add = [&](int64_t seconds) {
+        if (seconds > lastSecond)
+        {
+            isDone = true;
+            return;
+        }
+
+        const int64_t instance = seconds * MICROSECONDS_PER_SECOND + _fraction;
+
+        if (hasSetPos)
+        {
+            instances.push_back(instance);
+        }
+        else if (instance > _until)
+        {
+            isDone = true;
+        }
+        else if (instance >= from && !isExcluded(instance))
+        {
+            instances.push_back(instance);
+            isDone = instances.size() >= limit;
+        }
+    };
+
+    if (_frequency < DAILY)
+    {
+        const int64_t day = Calendar::floorDivide(unitStart, SECONDS_PER_DAY);
+        bool failedMonth = false;
+        int64_t next = 0;
+
+        if (!matchesDay(day, failedMonth))
+        {
+            int64_t nextDay = day + 1;
+
+            if (failedMonth)
+            {
+                const Calendar::Date date = Calendar::civilFromDays(day);
+                nextDay = day - date.day + 1 + Calendar::daysInMonth(date.year, date.month);
+            }
+
+            nextPeriod = getPeriodAtOrAfter(getUnit(nextDay * SECONDS_PER_DAY), nextPeriod);
+            return true;
+        }
+
+        if (!matchesTime(unitStart, next))
+        {
+            nextPeriod = getPeriodAtOrAfter(getUnit(next), nextPeriod);
+            return true;
+        }
+
+        for (std::size_t i = 0; i < _times.size() && !isDone; ++i)
+        {
+            add(unitStart + _times[i]);
+        }
+    }
+    else
+    {
+        int64_t firstDay = Calendar::floorDivide(unitStart, SECONDS_PER_DAY);
+        int64_t lastDay = Calendar::floorDivide(getUnitStart(unit + 1), SECONDS_PER_DAY);
+
+        // Instances before "from" are dropped, so their days can be skipped.
+        if (!hasSetPos)
+        {
+            firstDay = std::max(firstDay,
+                                Calendar::floorDivide(from, MICROSECONDS_PER_SECOND * SECONDS_PER_DAY));
+        }
+
+        for (int64_t day = firstDay; day < lastDay && !isDone; ++day)
+        {
+            bool failedMonth = false;
+
+            if (!matchesDay(day, failedMonth))
+            {
+                if (failedMonth)
+                {
+                    const Calendar::Date date = Calendar::civilFromDays(day);
+                    const int64_t nextDay = day - date.day + 1 + Calendar::daysInMonth(date.year, date.month);
+
+                    if (_frequency == DAILY)
+                    {
+                        nextPeriod = getPeriodAtOrAfter(nextDay, nextPeriod);
+                    }
+
+                    day = nextDay - 1;
+                }
+
+                continue;
+            }
+
+            for (std::size_t i = 0; i < _times.size() && !isDone; ++i)
+            {
+                add(day * SECONDS_PER_DAY + _times[i]);
+            }
+        }
+    }
+
+    if (hasSetPos)
+    {
+        const std::vector<int64_t> candidates(instances);
+        const int64_t size = int64_t(candidates.size());
+
+        instances.clear();
+
+        for (int position: _bySetPos)
+        {
+            const int64_t index = position > 0 ? position - 1 : size + position;
+
+            if (index >= 0 && index < size)
+            {
+                instances.push_back(candidates[std::size_t(index)]);
+            }
+        }
+
+        std::sort(instances.begin(), instances.end());
+        instances.erase(std::unique(instances.begin(), instances.end()), instances.end());
+
+        const int64_t until = _until;
+
+        instances.erase(std::remove_if(instances.begin(), instances.end(), [&](int64_t instance) {
+                            return instance < from || instance > until || isExcluded(instance);
+                        }),
+                        instances.end());
+
+        if (instances.size() > limit)
+        {
+            instances.resize(limit);
+        }
+    }
+
+    return true;
+}
+
+
+bool RRule::matchesDay(int64_t day, bool& failedMonth) const
+{
+    const Calendar::Date date = Calendar::civilFromDays(day);
+
+    if (_byMonth != 0 && ((_byMonth >> date.month) & 1) == 0)
+    {
+        failedMonth = true;
+        return false;
+    }
+
+    if (!_byWeekNo.empty())
+    {
+        // Week 1 is the first week with at least four days in the year, so
+        // a day near January 1 may belong to a week of the adjacent year.
+        int64_t year = date.year;
+        int64_t first = getFirstWeekDay(year);
+        int64_t next = getFirstWeekDay(year + 1);
+
+        if (day < first)
+        {
+            next = first;
+            first = getFirstWeekDay(--year);
+        }
+        else if (day >= next)
+        {
+            first = next;
+            next = getFirstWeekDay(++year + 1);
+        }
+
+        const int week = int((day - first) / 7) + 1;
+        const int weeks = int((next - first) / 7);
+        bool isMatch = false;
+
+        for (int value: _byWeekNo)
+        {
+            isMatch = isMatch || value == week || value == week - weeks - 1;
+        }
+
+        if (!isMatch)
+        {
+            return false;
+        }
+    }
+
+    if (!_byYearDay.empty())
+    {
+        const int yearDay = int(day - Calendar::daysFromCivil(date.year, 1, 1)) + 1;
+        const int yearLength = Calendar::isLeapYear(date.year) ? 366 : 365;
+        bool isMatch = false;
+
+        for (int value: _byYearDay)
+        {
+            isMatch = isMatch || value == yearDay || value == yearDay - yearLength - 1;
+        }
+
+        if (!isMatch)
+        {
+            return false;
+        }
+    }
+
+    if (_byMonthDay != 0 || _byNegativeMonthDay != 0)
+    {
+        const int monthLength = Calendar::daysInMonth(date.year, date.month);
+
+        if (((_byMonthDay >> date.day) & 1) == 0
+         && ((_byNegativeMonthDay >> (monthLength - date.day + 1)) & 1) == 0)
+        {
+            return false;
+        }
+    }
+
+    if (_byWeekday != 0 || !_byOrdinalWeekday.empty())
+    {
+        const int weekday = Calendar::dayOfWeek(day);
+
+        if (((_byWeekday >> weekday) & 1) != 0)
+        {
+            return true;
+        }
+
+        // Ordinals count weeks within the month for FREQ=MONTHLY or when
+        // BYMONTH is given, and within the year otherwise.
+        int64_t first = 0;
+        int64_t last = 0;
+
+        if (_frequency == MONTHLY || _byMonth != 0)
+        {
+            first = day - date.day + 1;
+            last = first + Calendar::daysInMonth(date.year, date.month) - 1;
+        }
+        else
+        {
+            first = Calendar::daysFromCivil(date.year, 1, 1);
+            last = Calendar::daysFromCivil(date.year + 1, 1, 1) - 1;
+        }
+
+        for (const OrdinalWeekday& value: _byOrdinalWeekday)
+        {
+            if (value.weekday == weekday
+             && (value.ordinal > 0 ? (day - first) / 7 == value.ordinal - 1
+                                   : (last - day) / 7 == -value.ordinal - 1))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+
+bool RRule::matchesTime(int64_t seconds, int64_t& next) const
+{
+    const int64_t secondOfDay = seconds - Calendar::floorDivide(seconds, SECONDS_PER_DAY) * SECONDS_PER_DAY;
+    const int64_t hour = secondOfDay / 3600;
+    const int64_t minute = secondOfDay / 60 % 60;
+    const int64_t second = secondOfDay % 60;
+
+    if (_byHour != 0 && ((_byHour >> hour) & 1) == 0)
+    {
+        next = seconds - secondOfDay % 3600 + 3600;
+        return false;
+    }
+
+    if (_frequency <= MINUTELY && _byMinute != 0 && ((_byMinute >> minute) & 1) == 0)
+    {
+        next = seconds - second + 60;
+        return false;
+    }
+
+    if (_frequency == SECONDLY && _bySecond != 0 && ((_bySecond >> second) & 1) == 0)
+    {
+        next = seconds + 1;
+        return false;
+    }
+
+    return true;
+}
+
+
+int64_t RRule::getFirstWeekDay(int64_t year) const
+{
+    const int64_t first = Calendar::daysFromCivil(year, 1, 1);
+    const int64_t offset = (Calendar::dayOfWeek(first) - _weekStart + 7) % 7;
+    return offset <= 3 ? first - offset : first - offset + 7;
+}
+
+
+bool RRule::isExcluded(int64_t instance) const
+{
+    return !_exclusions.empty()
+        && std::binary_search(_exclusions.begin(), _exclusions.end(), instance);
+}
+
+
+} } // namespace ofx::Time
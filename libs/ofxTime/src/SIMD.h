@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#pragma once
+
+
+// Compile-time configuration for the vectorised batch kernels.
+//
+// On GCC and Clang for x86, the AVX2 and AVX-512 kernels are compiled with
+// per-function target attributes and selected at runtime, so the library
+// does not need to be built with -mavx2.  On other compilers the kernels are
+// only available when the corresponding instruction set is enabled for the
+// whole build (e.g. /arch:AVX2).  Define OFX_TIME_NO_SIMD to always use the
+// scalar kernels.
+
+
+#if !defined(OFX_TIME_NO_SIMD)
+    #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        #define OFX_TIME_SIMD_DISPATCH 1
+        #define OFX_TIME_HAVE_AVX2 1
+        #define OFX_TIME_HAVE_AVX512 1
+        #define OFX_TIME_TARGET_AVX2 __attribute__((target("avx2")))
+        #define OFX_TIME_TARGET_AVX512 __attribute__((target("avx512f")))
+    #else
+        #if defined(__AVX2__)
+            #define OFX_TIME_HAVE_AVX2 1
+        #endif
+        #if defined(__AVX512F__)
+            #define OFX_TIME_HAVE_AVX512 1
+        #endif
+        #define OFX_TIME_TARGET_AVX2
+        #define OFX_TIME_TARGET_AVX512
+    #endif
+#endif
+
+
+#if defined(OFX_TIME_HAVE_AVX2) || defined(OFX_TIME_HAVE_AVX512)
+    #include <immintrin.h>
+#endif
+
+
+// Helpers that are shared by the scalar and target attribute kernels must be
+// inlined into each kernel to be compiled for its instruction set.
+#if defined(__GNUC__) || defined(__clang__)
+    #define OFX_TIME_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+    #define OFX_TIME_ALWAYS_INLINE __forceinline
+#else
+    #define OFX_TIME_ALWAYS_INLINE inline
+#endif
+
+
+namespace ofx {
+namespace Time {
+
+
+/// \brief Runtime detection of the instruction sets used by batch kernels.
+class SIMD
+{
+public:
+    /// \returns true iff the AVX2 kernels can be used on this CPU.
+    static bool hasAVX2()
+    {
+#if defined(OFX_TIME_SIMD_DISPATCH)
+        static const bool result = __builtin_cpu_supports("avx2");
+        return result;
+#elif defined(OFX_TIME_HAVE_AVX2)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// \returns true iff the AVX-512 kernels can be used on this CPU.
+    static bool hasAVX512()
+    {
+#if defined(OFX_TIME_SIMD_DISPATCH)
+        static const bool result = __builtin_cpu_supports("avx512f");
+        return result;
+#elif defined(OFX_TIME_HAVE_AVX512)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+};
+
+
+} } // namespace ofx::Time
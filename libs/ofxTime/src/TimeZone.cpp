@@ -0,0 +1,1046 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/TimeZone.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include "Poco/DateTime.h"
+#include "ofx/Time/Calendar.h"
+#include "ofLog.h"
+#include "Ascii.h"
+#include "MappedFile.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+const int64_t MICROSECONDS_PER_SECOND = 1000000;
+const int64_t SECONDS_PER_DAY = 86400;
+
+
+/// \brief The zones loaded by TimeZone::get().
+struct Registry
+{
+    std::mutex mutex;
+    std::map<std::string, std::shared_ptr<const TimeZone>> zones;
+};
+
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+
+/// \brief The counts in a TZif header.
+struct Header
+{
+    char version = 0;
+    uint32_t isutcnt = 0;
+    uint32_t isstdcnt = 0;
+    uint32_t leapcnt = 0;
+    uint32_t timecnt = 0;
+    uint32_t typecnt = 0;
+    uint32_t charcnt = 0;
+};
+
+
+/// \brief The size of a TZif header.
+const std::size_t HEADER_SIZE = 44;
+
+
+inline uint32_t readUInt32(const unsigned char* p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+
+inline int64_t readInt32(const unsigned char* p)
+{
+    return int32_t(readUInt32(p));
+}
+
+
+inline int64_t readInt64(const unsigned char* p)
+{
+    return int64_t((uint64_t(readUInt32(p)) << 32) | uint64_t(readUInt32(p + 4)));
+}
+
+
+bool readHeader(const unsigned char* p, std::size_t size, Header& header)
+{
+    if (size < HEADER_SIZE || std::memcmp(p, "TZif", 4) != 0)
+    {
+        return false;
+    }
+
+    header.version = char(p[4]);
+    header.isutcnt = readUInt32(p + 20);
+    header.isstdcnt = readUInt32(p + 24);
+    header.leapcnt = readUInt32(p + 28);
+    header.timecnt = readUInt32(p + 32);
+    header.typecnt = readUInt32(p + 36);
+    header.charcnt = readUInt32(p + 40);
+    return true;
+}
+
+
+/// \returns the size of the data block following a header.
+uint64_t getDataSize(const Header& header, std::size_t timeSize)
+{
+    return uint64_t(header.timecnt) * timeSize
+         + header.timecnt
+         + uint64_t(header.typecnt) * 6
+         + header.charcnt
+         + uint64_t(header.leapcnt) * (timeSize + 4)
+         + header.isstdcnt
+         + header.isutcnt;
+}
+
+
+/// \brief Convert seconds to microseconds, saturating at the int64_t limits.
+inline int64_t toMicroseconds(int64_t seconds)
+{
+    if (seconds >= INT64_MAX / MICROSECONDS_PER_SECOND)
+    {
+        return INT64_MAX;
+    }
+
+    if (seconds <= INT64_MIN / MICROSECONDS_PER_SECOND)
+    {
+        return INT64_MIN;
+    }
+
+    return seconds * MICROSECONDS_PER_SECOND;
+}
+
+
+/// \brief Parse an unsigned number of at most three digits.
+bool parseNumber(const char*& p, int minimum, int maximum, int& value)
+{
+    if (!Ascii::isDigit(*p))
+    {
+        return false;
+    }
+
+    value = 0;
+
+    for (int digits = 0; digits < 3 && Ascii::isDigit(*p); ++digits, ++p)
+    {
+        value = value * 10 + (*p - '0');
+    }
+
+    return value >= minimum && value <= maximum;
+}
+
+
+/// \brief Parse a POSIX time, [+-]hh[:mm[:ss]], in seconds.
+bool parseTime(const char*& p, int maximumHours, int& seconds)
+{
+    int sign = 1;
+
+    if (*p == '+' || *p == '-')
+    {
+        sign = *p == '-' ? -1 : 1;
+        ++p;
+    }
+
+    int hours = 0;
+    int minutes = 0;
+    int secs = 0;
+
+    if (!parseNumber(p, 0, maximumHours, hours))
+    {
+        return false;
+    }
+
+    if (*p == ':')
+    {
+        ++p;
+
+        if (!parseNumber(p, 0, 59, minutes))
+        {
+            return false;
+        }
+
+        if (*p == ':')
+        {
+            ++p;
+
+            if (!parseNumber(p, 0, 59, secs))
+            {
+                return false;
+            }
+        }
+    }
+
+    seconds = sign * (hours * 3600 + minutes * 60 + secs);
+    return true;
+}
+
+
+/// \brief Parse a POSIX zone abbreviation, either alphabetic or quoted
+///        with angle brackets.
+bool parseName(const char*& p, std::string& name)
+{
+    const char* first = p;
+
+    if (*p == '<')
+    {
+        first = ++p;
+
+        while (*p && *p != '>')
+        {
+            ++p;
+        }
+
+        if (*p != '>')
+        {
+            return false;
+        }
+
+        name.assign(first, p++);
+    }
+    else
+    {
+        while (Ascii::isAlpha(*p))
+        {
+            ++p;
+        }
+
+        name.assign(first, p);
+    }
+
+    return name.size() >= 3;
+}
+
+
+} // namespace
+
+
+/// \brief A POSIX `TZ` rule, e.g. "CET-1CEST,M3.5.0,M10.5.0/3".
+struct TimeZone::Rule
+{
+    /// \brief A rule for the day and time of a transition.
+    struct Date
+    {
+        /// \brief The ways of specifying the day.
+        enum Kind
+        {
+            /// \brief Jn, the day of the year [1, 365], never Feb 29.
+            JULIAN,
+            /// \brief n, the zero-based day of the year [0, 365].
+            ZERO_BASED,
+            /// \brief Mm.w.d, day d of week w of month m.
+            MONTH_WEEK_DAY
+        };
+
+        Kind kind = MONTH_WEEK_DAY;
+        int day = 0;
+        int month = 1;
+        int week = 1;
+        int weekday = 0;
+
+        /// \brief The local time of day of the transition in seconds.
+        int time = 7200;
+
+        bool parse(const char*& p)
+        {
+            if (*p == 'J')
+            {
+                kind = JULIAN;
+                ++p;
+
+                if (!parseNumber(p, 1, 365, day))
+                {
+                    return false;
+                }
+            }
+            else if (*p == 'M')
+            {
+                kind = MONTH_WEEK_DAY;
+                ++p;
+
+                if (!parseNumber(p, 1, 12, month) || *p++ != '.'
+                 || !parseNumber(p, 1, 5, week) || *p++ != '.'
+                 || !parseNumber(p, 0, 6, weekday))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                kind = ZERO_BASED;
+
+                if (!parseNumber(p, 0, 365, day))
+                {
+                    return false;
+                }
+            }
+
+            if (*p == '/')
+            {
+                ++p;
+                return parseTime(p, 167, time);
+            }
+
+            return true;
+        }
+
+        /// \returns the day in the given year, in days since 1970-01-01.
+        int64_t getDay(int64_t year) const
+        {
+            switch(kind)
+            {
+                case JULIAN:
+                {
+                    const int64_t first = Calendar::daysFromCivil(year, 1, 1);
+                    return first + day - 1 + (Calendar::isLeapYear(year) && day >= 60 ? 1 : 0);
+                }
+                case ZERO_BASED:
+                    return Calendar::daysFromCivil(year, 1, 1) + day;
+                case MONTH_WEEK_DAY:
+                {
+                    const int64_t first = Calendar::daysFromCivil(year, month, 1);
+                    const int64_t firstWeekday = Calendar::dayOfWeek(first);
+
+                    int64_t result = first + (weekday - firstWeekday + 7) % 7 + (week - 1) * 7;
+
+                    // Week 5 is the last such day of the month.
+                    if (result >= first + Calendar::daysInMonth(year, month))
+                    {
+                        result -= 7;
+                    }
+
+                    return result;
+                }
+            }
+
+            return 0;
+        }
+    };
+
+    Type standard;
+    Type daylight;
+    bool hasDST = false;
+    Date start;
+    Date end;
+
+    bool parse(const std::string& text)
+    {
+        const char* p = text.c_str();
+        int offset = 0;
+
+        // POSIX offsets are west of UTC.
+        if (!parseName(p, standard.abbreviation) || !parseTime(p, 24, offset))
+        {
+            return false;
+        }
+
+        standard.offset = -offset;
+
+        if (*p == 0)
+        {
+            return true;
+        }
+
+        if (!parseName(p, daylight.abbreviation))
+        {
+            return false;
+        }
+
+        hasDST = true;
+        daylight.isDST = true;
+        daylight.offset = standard.offset + 3600;
+
+        if (*p != 0 && *p != ',')
+        {
+            if (!parseTime(p, 24, offset))
+            {
+                return false;
+            }
+
+            daylight.offset = -offset;
+        }
+
+        if (*p == 0)
+        {
+            // The current United States rule.
+            start.month = 3;
+            start.week = 2;
+            end.month = 11;
+            end.week = 1;
+            return true;
+        }
+
+        return *p++ == ','
+            && start.parse(p)
+            && *p++ == ','
+            && end.parse(p)
+            && *p == 0;
+    }
+};
+
+
+const int64_t TimeZone::CYCLE_SECONDS = INT64_C(146097) * SECONDS_PER_DAY;
+
+
+std::size_t TimeZone::Resolution::toUtc(int64_t local,
+                                        NonexistentPolicy nonexistent,
+                                        AmbiguousPolicy ambiguous,
+                                        int64_t* utc) const
+{
+    const int64_t before = local - offsetBefore * MICROSECONDS_PER_SECOND;
+    const int64_t after = local - offsetAfter * MICROSECONDS_PER_SECOND;
+
+    switch(type)
+    {
+        case UNIQUE:
+            utc[0] = before;
+            return 1;
+        case NONEXISTENT:
+            switch(nonexistent)
+            {
+                case NONEXISTENT_SHIFT_FORWARD:
+                    utc[0] = before;
+                    return 1;
+                case NONEXISTENT_SHIFT_BACKWARD:
+                    utc[0] = after;
+                    return 1;
+                case NONEXISTENT_NEXT_VALID:
+                    utc[0] = transition;
+                    return 1;
+                case NONEXISTENT_PREVIOUS_VALID:
+                    utc[0] = transition - 1;
+                    return 1;
+                case NONEXISTENT_SKIP:
+                    return 0;
+            }
+            break;
+        case AMBIGUOUS:
+            switch(ambiguous)
+            {
+                case AMBIGUOUS_EARLIER:
+                    utc[0] = before;
+                    return 1;
+                case AMBIGUOUS_LATER:
+                    utc[0] = after;
+                    return 1;
+                case AMBIGUOUS_BOTH:
+                    utc[0] = before;
+                    utc[1] = after;
+                    return 2;
+                case AMBIGUOUS_SKIP:
+                    return 0;
+            }
+            break;
+    }
+
+    return 0;
+}
+
+
+TimeZone::TimeZone()
+{
+}
+
+
+std::shared_ptr<const TimeZone> TimeZone::get(const std::string& name)
+{
+    Registry& registry = getRegistry();
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto iter = registry.zones.find(name);
+
+    if (iter != registry.zones.end())
+    {
+        return iter->second;
+    }
+
+    std::shared_ptr<const TimeZone> zone = load(name);
+
+    if (!zone)
+    {
+        ofLogError("TimeZone::get") << "Unable to load time zone " << name;
+        return nullptr;
+    }
+
+    registry.zones[name] = zone;
+    return zone;
+}
+
+
+std::shared_ptr<const TimeZone> TimeZone::local()
+{
+    static const std::shared_ptr<const TimeZone> zone = []() {
+        const char* tz = std::getenv("TZ");
+        std::string name = tz && *tz ? tz : "/etc/localtime";
+
+        if (name[0] == ':')
+        {
+            name.erase(0, 1);
+        }
+
+        std::shared_ptr<const TimeZone> result = get(name);
+        return result ? result : utc();
+    }();
+
+    return zone;
+}
+
+
+std::shared_ptr<const TimeZone> TimeZone::utc()
+{
+    static const std::shared_ptr<const TimeZone> zone = parsePosix("UTC", "UTC0");
+    return zone;
+}
+
+
+std::shared_ptr<const TimeZone> TimeZone::fromTZif(const std::string& name,
+                                                   const char* data,
+                                                   std::size_t size)
+{
+    std::shared_ptr<const TimeZone> zone = parseTZif(name, data, size);
+
+    if (!zone)
+    {
+        ofLogError("TimeZone::fromTZif") << "Invalid TZif data for " << name;
+    }
+
+    return zone;
+}
+
+
+std::shared_ptr<const TimeZone> TimeZone::fromPosix(const std::string& rule)
+{
+    std::shared_ptr<const TimeZone> zone = parsePosix(rule, rule);
+
+    if (!zone)
+    {
+        ofLogError("TimeZone::fromPosix") << "Invalid rule " << rule;
+    }
+
+    return zone;
+}
+
+
+const std::string& TimeZone::getName() const
+{
+    return _name;
+}
+
+
+const std::string& TimeZone::getRule() const
+{
+    return _rule;
+}
+
+
+int TimeZone::getOffset(int64_t utc) const
+{
+    int64_t seconds = Calendar::floorDivide(utc, MICROSECONDS_PER_SECOND);
+    reduce(seconds);
+    return _offsets[findOffsetIndex(seconds)];
+}
+
+
+bool TimeZone::isDST(int64_t utc) const
+{
+    int64_t seconds = Calendar::floorDivide(utc, MICROSECONDS_PER_SECOND);
+    reduce(seconds);
+    return _types[_typeIndices[findOffsetIndex(seconds)]].isDST;
+}
+
+
+const std::string& TimeZone::getAbbreviation(int64_t utc) const
+{
+    int64_t seconds = Calendar::floorDivide(utc, MICROSECONDS_PER_SECOND);
+    reduce(seconds);
+    return _types[_typeIndices[findOffsetIndex(seconds)]].abbreviation;
+}
+
+
+int64_t TimeZone::toLocal(int64_t utc) const
+{
+    return utc + getOffset(utc) * MICROSECONDS_PER_SECOND;
+}
+
+
+int64_t TimeZone::toUtc(int64_t local) const
+{
+    return local - resolve(local).offsetBefore * MICROSECONDS_PER_SECOND;
+}
+
+
+TimeZone::Resolution TimeZone::resolve(int64_t local) const
+{
+    int64_t first = 0;
+    int64_t last = 0;
+    return resolveSeconds(Calendar::floorDivide(local, MICROSECONDS_PER_SECOND), first, last);
+}
+
+
+TimeZone::Resolution TimeZone::resolve(int64_t local,
+                                      int64_t& first,
+                                      int64_t& last) const
+{
+    Resolution resolution = resolveSeconds(Calendar::floorDivide(local, MICROSECONDS_PER_SECOND), first, last);
+    first = toMicroseconds(first);
+    last = toMicroseconds(last);
+    return resolution;
+}
+
+
+std::size_t TimeZone::toUtc(int64_t local,
+                            NonexistentPolicy nonexistent,
+                            AmbiguousPolicy ambiguous,
+                            int64_t* utc) const
+{
+    return resolve(local).toUtc(local, nonexistent, ambiguous, utc);
+}
+
+
+void TimeZone::toLocal(const int64_t* utc, int64_t* local, std::size_t size) const
+{
+    // The range of UTC seconds [first, last) with the current offset.
+    int64_t first = 0;
+    int64_t last = 0;
+    int64_t offset = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int64_t seconds = Calendar::floorDivide(utc[i], MICROSECONDS_PER_SECOND);
+
+        if (seconds < first || seconds >= last)
+        {
+            int64_t reduced = seconds;
+            const int64_t shift = reduce(reduced);
+            const std::size_t index = findOffsetIndex(reduced);
+
+            getCycleRange(shift, first, last);
+
+            if (index > 0)
+            {
+                first = std::max(first, _transitions[index - 1]);
+            }
+
+            if (index < _transitions.size())
+            {
+                last = std::min(last, _transitions[index]);
+            }
+
+            first += shift;
+            last += shift;
+            offset = _offsets[index] * MICROSECONDS_PER_SECOND;
+        }
+
+        local[i] = utc[i] + offset;
+    }
+}
+
+
+void TimeZone::toUtc(const int64_t* local, int64_t* utc, std::size_t size) const
+{
+    // The range of local seconds [first, last) with the current offset.
+    int64_t first = 0;
+    int64_t last = 0;
+    int64_t offset = 0;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const int64_t seconds = Calendar::floorDivide(local[i], MICROSECONDS_PER_SECOND);
+
+        if (seconds < first || seconds >= last)
+        {
+            offset = resolveSeconds(seconds, first, last).offsetBefore * MICROSECONDS_PER_SECOND;
+        }
+
+        utc[i] = local[i] - offset;
+    }
+}
+
+
+Poco::LocalDateTime TimeZone::toLocalDateTime(const Poco::Timestamp& timestamp) const
+{
+    return Poco::LocalDateTime(getOffset(timestamp.epochMicroseconds()),
+                               Poco::DateTime(timestamp),
+                               true);
+}
+
+
+std::size_t TimeZone::getTransitionCount() const
+{
+    return _transitions.size();
+}
+
+
+std::shared_ptr<TimeZone> TimeZone::parseTZif(const std::string& name,
+                                              const char* data,
+                                              std::size_t size)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* last = p + size;
+
+    Header header;
+
+    if (!data || !readHeader(p, size, header))
+    {
+        return nullptr;
+    }
+
+    std::size_t timeSize = 4;
+
+    // Version 2 and later files repeat the data with 64-bit times.
+    if (header.version >= '2')
+    {
+        const uint64_t skip = HEADER_SIZE + getDataSize(header, 4);
+
+        if (skip > size || !readHeader(p + skip, size - std::size_t(skip), header))
+        {
+            return nullptr;
+        }
+
+        p += skip;
+        timeSize = 8;
+    }
+
+    p += HEADER_SIZE;
+
+    if (getDataSize(header, timeSize) > uint64_t(last - p)
+     || header.typecnt == 0
+     || header.typecnt > 256
+     || header.charcnt == 0
+     || (header.isstdcnt != 0 && header.isstdcnt != header.typecnt)
+     || (header.isutcnt != 0 && header.isutcnt != header.typecnt))
+    {
+        return nullptr;
+    }
+
+    const unsigned char* times = p;
+    const unsigned char* indices = times + header.timecnt * timeSize;
+    const unsigned char* types = indices + header.timecnt;
+    const char* chars = reinterpret_cast<const char*>(types + header.typecnt * 6);
+
+    std::shared_ptr<TimeZone> zone(new TimeZone());
+    zone->_name = name;
+
+    for (uint32_t i = 0; i < header.typecnt; ++i)
+    {
+        const unsigned char* type = types + i * 6;
+        const int64_t offset = readInt32(type);
+        const uint32_t abbreviation = type[5];
+
+        if (offset == INT32_MIN || abbreviation >= header.charcnt)
+        {
+            return nullptr;
+        }
+
+        Type result;
+        result.offset = int(offset);
+        result.isDST = type[4] != 0;
+
+        const char* first = chars + abbreviation;
+        const char* end = static_cast<const char*>(std::memchr(first, 0, header.charcnt - abbreviation));
+        result.abbreviation.assign(first, end ? end : chars + header.charcnt);
+        zone->_types.push_back(result);
+    }
+
+    // Times before the first transition use the first type.
+    zone->_typeIndices.push_back(0);
+
+    for (uint32_t i = 0; i < header.timecnt; ++i)
+    {
+        const int64_t time = timeSize == 8 ? readInt64(times + i * 8) : readInt32(times + i * 4);
+
+        if (indices[i] >= header.typecnt
+         || (!zone->_transitions.empty() && time <= zone->_transitions.back()))
+        {
+            return nullptr;
+        }
+
+        zone->_transitions.push_back(time);
+        zone->_typeIndices.push_back(indices[i]);
+    }
+
+    zone->_fileTransitions = zone->_transitions.size();
+
+    // The footer is a POSIX rule between two newlines.
+    p += getDataSize(header, timeSize);
+
+    if (timeSize == 8 && p < last && *p == '\n')
+    {
+        const char* first = reinterpret_cast<const char*>(p + 1);
+        const char* newline = static_cast<const char*>(std::memchr(first, '\n', std::size_t(last - p - 1)));
+
+        Rule rule;
+
+        if (newline && newline != first && rule.parse(std::string(first, newline)))
+        {
+            zone->_rule.assign(first, newline);
+
+            if (rule.hasDST)
+            {
+                if (zone->_transitions.empty())
+                {
+                    zone->applyRule(rule, 1969, true);
+                }
+                else
+                {
+                    const int64_t days = Calendar::floorDivide(zone->_transitions.back(), SECONDS_PER_DAY);
+                    zone->applyRule(rule, Calendar::civilFromDays(days).year, false);
+                }
+            }
+        }
+    }
+
+    zone->finish();
+    return zone;
+}
+
+
+std::shared_ptr<TimeZone> TimeZone::parsePosix(const std::string& name,
+                                               const std::string& rule)
+{
+    Rule parsed;
+
+    if (!parsed.parse(rule))
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<TimeZone> zone(new TimeZone());
+    zone->_name = name;
+    zone->_rule = rule;
+    zone->_types.push_back(parsed.standard);
+    zone->_typeIndices.push_back(0);
+
+    if (parsed.hasDST)
+    {
+        zone->applyRule(parsed, 1969, true);
+    }
+
+    zone->finish();
+    return zone;
+}
+
+
+std::shared_ptr<TimeZone> TimeZone::load(const std::string& name)
+{
+    std::string path = name;
+
+    if (name.empty() || name[0] != '/')
+    {
+        const char* directory = std::getenv("TZDIR");
+        path = std::string(directory && *directory ? directory : "/usr/share/zoneinfo") + "/" + name;
+    }
+
+    MappedFile file;
+
+    if (!name.empty() && name.find("..") == std::string::npos && file.open(path))
+    {
+        return parseTZif(name, file.data(), file.size());
+    }
+
+    return parsePosix(name, name);
+}
+
+
+std::size_t TimeZone::addType(const Type& type)
+{
+    for (std::size_t i = 0; i < _types.size(); ++i)
+    {
+        if (_types[i] == type)
+        {
+            return i;
+        }
+    }
+
+    _types.push_back(type);
+    return _types.size() - 1;
+}
+
+
+void TimeZone::addTransition(int64_t seconds, std::size_t type)
+{
+    if (!_transitions.empty())
+    {
+        // Rule transitions only follow the transitions from the file.
+        if (seconds < _transitions.back()
+         || (seconds == _transitions.back() && _transitions.size() <= _fileTransitions))
+        {
+            return;
+        }
+
+        // A rule transition at the same time replaces the previous one, as
+        // for zones that observe daylight saving time all year.
+        if (seconds == _transitions.back())
+        {
+            _transitions.pop_back();
+            _typeIndices.pop_back();
+        }
+    }
+
+    if (_types[_typeIndices.back()] == _types[type])
+    {
+        return;
+    }
+
+    _transitions.push_back(seconds);
+    _typeIndices.push_back(uint16_t(type));
+}
+
+
+void TimeZone::applyRule(const Rule& rule, int64_t firstYear, bool cycleBefore)
+{
+    const std::size_t standard = addType(rule.standard);
+    const std::size_t daylight = addType(rule.daylight);
+
+    // One extra year covers transitions that fall in the next UTC year.
+    for (int64_t year = firstYear; year <= firstYear + 401; ++year)
+    {
+        // The start is given in standard time and the end in daylight time.
+        const int64_t start = rule.start.getDay(year) * SECONDS_PER_DAY + rule.start.time - rule.standard.offset;
+        const int64_t end = rule.end.getDay(year) * SECONDS_PER_DAY + rule.end.time - rule.daylight.offset;
+
+        if (start < end)
+        {
+            addTransition(start, daylight);
+            addTransition(end, standard);
+        }
+        else
+        {
+            addTransition(end, standard);
+            addTransition(start, daylight);
+        }
+    }
+
+    _cycleStart = Calendar::daysFromCivil(firstYear + 1, 1, 1) * SECONDS_PER_DAY;
+    _cycleEnd = _cycleStart + CYCLE_SECONDS;
+    _cycleBefore = cycleBefore;
+}
+
+
+void TimeZone::finish()
+{
+    _offsets.resize(_typeIndices.size());
+
+    for (std::size_t i = 0; i < _typeIndices.size(); ++i)
+    {
+        _offsets[i] = _types[_typeIndices[i]].offset;
+    }
+
+    _localTransitions.resize(_transitions.size());
+
+    for (std::size_t i = 0; i < _transitions.size(); ++i)
+    {
+        _localTransitions[i] = _transitions[i] + std::min(_offsets[i], _offsets[i + 1]);
+
+        // Keep the table sorted for the search even if two transitions are
+        // closer together than their offsets.
+        if (i > 0)
+        {
+            _localTransitions[i] = std::max(_localTransitions[i], _localTransitions[i - 1]);
+        }
+    }
+}
+
+
+int64_t TimeZone::reduce(int64_t& seconds) const
+{
+    int64_t shift = 0;
+
+    if (seconds >= _cycleEnd)
+    {
+        shift = ((seconds - _cycleEnd) / CYCLE_SECONDS + 1) * CYCLE_SECONDS;
+    }
+    else if (_cycleBefore && seconds < _cycleStart)
+    {
+        shift = -(((_cycleStart - seconds - 1) / CYCLE_SECONDS + 1) * CYCLE_SECONDS);
+    }
+
+    seconds -= shift;
+    return shift;
+}
+
+
+void TimeZone::getCycleRange(int64_t shift, int64_t& first, int64_t& last) const
+{
+    first = shift != 0 || _cycleBefore ? _cycleStart : INT64_MIN;
+    last = _cycleEnd;
+}
+
+
+std::size_t TimeZone::findOffsetIndex(int64_t seconds) const
+{
+    return std::size_t(std::upper_bound(_transitions.begin(), _transitions.end(), seconds) - _transitions.begin());
+}
+
+
+TimeZone::Resolution TimeZone::resolveSeconds(int64_t seconds,
+                                              int64_t& first,
+                                              int64_t& last) const
+{
+    const int64_t shift = reduce(seconds);
+
+    // The number of transitions that affect local times up to seconds.
+    const std::size_t index = std::size_t(std::upper_bound(_localTransitions.begin(),
+                                                           _localTransitions.end(),
+                                                           seconds) - _localTransitions.begin());
+
+    Resolution resolution;
+
+    getCycleRange(shift, first, last);
+
+    if (index < _localTransitions.size())
+    {
+        last = std::min(last, _localTransitions[index]);
+    }
+
+    if (index == 0)
+    {
+        resolution.offsetBefore = _offsets[0];
+        resolution.offsetAfter = _offsets[0];
+    }
+    else
+    {
+        const std::size_t transition = index - 1;
+        const int before = _offsets[transition];
+        const int after = _offsets[transition + 1];
+        const int64_t end = _transitions[transition] + std::max(before, after);
+
+        if (seconds < end)
+        {
+            resolution.type = after > before ? Resolution::NONEXISTENT : Resolution::AMBIGUOUS;
+            resolution.offsetBefore = before;
+            resolution.offsetAfter = after;
+            resolution.transition = (_transitions[transition] + shift) * MICROSECONDS_PER_SECOND;
+            first = 0;
+            last = 0;
+            return resolution;
+        }
+
+        resolution.offsetBefore = after;
+        resolution.offsetAfter = after;
+        first = std::max(first, end);
+    }
+
+    first += shift;
+    last += shift;
+    return resolution;
+}
+
+
+} } // namespace ofx::Time
@@ -0,0 +1,425 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/TimingWheel.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "ofx/Time/Bits.h"
+#include "ofx/Time/Calendar.h"
+#include "ofx/Time/Utils.h"
+#include "ofLog.h"
+
+
+namespace ofx {
+namespace Time {
+
+
+TimingWheel::TimingWheel(const Poco::Timespan& resolution,
+                         const Poco::Timestamp& start):
+    _origin(start.epochMicroseconds()),
+    _resolution(resolution.totalMicroseconds()),
+    _slots(LEVELS * SLOTS)
+{
+    if (_resolution <= 0)
+    {
+        ofLogError("TimingWheel::TimingWheel") << "The resolution must be positive: " << _resolution << " us.";
+        _resolution = 1;
+    }
+
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        for (int word = 0; word < SLOTS / 64; ++word)
+        {
+            _occupied[level][word] = 0;
+        }
+    }
+}
+
+
+TimingWheel::Timer TimingWheel::schedule(const Poco::Timestamp& deadline,
+                                         Callback callback)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return add(deadline.epochMicroseconds(), nullptr, std::move(callback));
+}
+
+
+TimingWheel::Timer TimingWheel::schedule(const Poco::Timestamp& deadline,
+                                         const Period& period,
+                                         Callback callback)
+{
+    if (Utils::add(deadline, period) <= deadline)
+    {
+        ofLogError("TimingWheel::schedule") << "The period must be positive.";
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return add(deadline.epochMicroseconds(), &period, std::move(callback));
+}
+
+
+bool TimingWheel::cancel(Timer timer)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    int32_t index = find(timer);
+
+    if (index < 0)
+    {
+        return false;
+    }
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+
+bool TimingWheel::isScheduled(Timer timer) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return find(timer) >= 0;
+}
+
+
+std::size_t TimingWheel::advance(const Poco::Timestamp& now)
+{
+    const Poco::Timestamp::TimeVal time = now.epochMicroseconds();
+
+    std::vector<std::pair<Callback, Poco::Timestamp::TimeVal>> fired;
+    Executor executor;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // The last tick that has started.
+        const int64_t target = Calendar::floorDivide(time - _origin, _resolution);
+
+        if (target <= _current)
+        {
+            return 0;
+        }
+
+        for (;;)
+        {
+            const int64_t tick = getNextTick(target + 1);
+
+            if (tick > target)
+            {
+                break;
+            }
+
+            _current = tick;
+
+            // The slots that the current tick has just entered hold timers
+            // that are due now or belong on a lower level.
+            for (int level = LEVELS - 1; level >= 0; --level)
+            {
+                const int digit = int((uint64_t(tick) >> (level * SLOT_BITS)) & (SLOTS - 1));
+                const int32_t slot = level * SLOTS + digit;
+
+                std::vector<int32_t>& indices = _slots[slot];
+
+                if (indices.empty())
+                {
+                    continue;
+                }
+
+                _occupied[level][digit / 64] &= ~(uint64_t(1) << (digit % 64));
+
+                // Timers that are not due always move to a later slot, so the
+                // indices are not changed while they are read.
+                for (int32_t index: indices)
+                {
+                    Entry& entry = _entries[index];
+
+                    if (entry.tick > tick)
+                    {
+                        link(index);
+                    }
+                    else if (entry.repeat)
+                    {
+                        fired.push_back(std::make_pair(entry.callback, entry.deadline));
+
+                        if (rearm(entry, time))
+                        {
+                            entry.tick = getDeadlineTick(entry.deadline);
+                            link(index);
+                        }
+                        else
+                        {
+                            ofLogError("TimingWheel::advance") << "The period did not advance, cancelling.";
+                            release(index);
+                        }
+                    }
+                    else
+                    {
+                        fired.push_back(std::make_pair(std::move(entry.callback), entry.deadline));
+                        release(index);
+                    }
+                }
+
+                indices.clear();
+            }
+        }
+
+        _current = target;
+        executor = _executor;
+    }
+
+    for (std::pair<Callback, Poco::Timestamp::TimeVal>& timer: fired)
+    {
+        if (executor)
+        {
+            Callback callback = std::move(timer.first);
+            Poco::Timestamp::TimeVal deadline = timer.second;
+
+            executor([callback, deadline]() {
+                callback(Poco::Timestamp(deadline));
+            });
+        }
+        else
+        {
+            timer.first(Poco::Timestamp(timer.second));
+        }
+    }
+
+    return fired.size();
+}
+
+
+bool TimingWheel::getNextTime(Poco::Timestamp& time) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (0 == _size)
+    {
+        return false;
+    }
+
+    const int64_t tick = getNextTick(std::numeric_limits<int64_t>::max());
+    time = Poco::Timestamp(_origin + tick * _resolution);
+    return true;
+}
+
+
+std::size_t TimingWheel::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+
+Poco::Timespan TimingWheel::getResolution() const
+{
+    return Poco::Timespan(_resolution);
+}
+
+
+void TimingWheel::setExecutor(Executor executor)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _executor = std::move(executor);
+}
+
+
+void TimingWheel::setExecutor(WorkStealingPool& pool)
+{
+    setExecutor([&pool](std::function<void()> task) {
+        pool.submit(std::move(task));
+    });
+}
+
+
+TimingWheel::Timer TimingWheel::add(Poco::Timestamp::TimeVal deadline,
+                                    const Period* period,
+                                    Callback callback)
+{
+    int32_t index = 0;
+
+    if (_free.empty())
+    {
+        index = int32_t(_entries.size());
+        _entries.emplace_back();
+    }
+    else
+    {
+        index = _free.back();
+        _free.pop_back();
+    }
+
+    Entry& entry = _entries[index];
+    entry.tick = getDeadlineTick(deadline);
+    entry.deadline = deadline;
+    entry.callback = std::move(callback);
+
+    if (period)
+    {
+        entry.repeat.reset(new Repeat());
+        entry.repeat->period = *period;
+        entry.repeat->first = deadline;
+    }
+
+    link(index);
+    ++_size;
+
+    return (Timer(entry.generation) << 32) | Timer(index + 1);
+}
+
+
+bool TimingWheel::rearm(Entry& entry, Poco::Timestamp::TimeVal now)
+{
+    Repeat& repeat = *entry.repeat;
+
+    const Poco::Timestamp::TimeVal previous = entry.deadline;
+
+    if (repeat.period.isFixed())
+    {
+        // Skip the missed deadlines in one step.
+        const int64_t length = repeat.period.getFixedMicroseconds();
+        repeat.count = std::max(repeat.count + 1, Calendar::floorDivide(now - repeat.first, length) + 1);
+        entry.deadline = repeat.first + repeat.count * length;
+    }
+    else
+    {
+        // Each deadline is computed from the first so that clamped days of
+        // the month do not accumulate.
+        do
+        {
+            ++repeat.count;
+            entry.deadline = Utils::add(Poco::Timestamp(repeat.first),
+                                        repeat.period * repeat.count).epochMicroseconds();
+        }
+        while (entry.deadline <= now && entry.deadline > previous);
+    }
+
+    return entry.deadline > previous;
+}
+
+
+int64_t TimingWheel::getDeadlineTick(Poco::Timestamp::TimeVal deadline) const
+{
+    const int64_t tick = -Calendar::floorDivide(_origin - deadline, _resolution);
+    return std::max(tick, _current + 1);
+}
+
+
+int32_t TimingWheel::find(Timer timer) const
+{
+    const uint64_t slot = timer & 0xFFFFFFFF;
+
+    if (0 == slot || slot > _entries.size())
+    {
+        return -1;
+    }
+
+    const Entry& entry = _entries[slot - 1];
+
+    if (entry.slot < 0 || entry.generation != uint32_t(timer >> 32))
+    {
+        return -1;
+    }
+
+    return int32_t(slot - 1);
+}
+
+
+void TimingWheel::link(int32_t index)
+{
+    Entry& entry = _entries[index];
+
+    // The level is the highest digit in which the tick differs from the
+    // current tick.
+    const uint64_t tick = uint64_t(entry.tick);
+    const int level = Bits::highestBit(tick ^ uint64_t(_current)) / SLOT_BITS;
+    const int digit = int((tick >> (level * SLOT_BITS)) & (SLOTS - 1));
+    const int32_t slot = level * SLOTS + digit;
+
+    std::vector<int32_t>& indices = _slots[slot];
+
+    entry.slot = slot;
+    entry.position = int32_t(indices.size());
+    indices.push_back(index);
+
+    _occupied[level][digit / 64] |= uint64_t(1) << (digit % 64);
+}
+
+
+void TimingWheel::unlink(int32_t index)
+{
+    Entry& entry = _entries[index];
+    std::vector<int32_t>& indices = _slots[entry.slot];
+
+    const int32_t last = indices.back();
+    indices[entry.position] = last;
+    _entries[last].position = entry.position;
+    indices.pop_back();
+
+    if (indices.empty())
+    {
+        const int level = entry.slot / SLOTS;
+        const int digit = entry.slot % SLOTS;
+        _occupied[level][digit / 64] &= ~(uint64_t(1) << (digit % 64));
+    }
+}
+
+
+void TimingWheel::release(int32_t index)
+{
+    Entry& entry = _entries[index];
+    entry.callback = Callback();
+    entry.repeat.reset();
+    entry.slot = -1;
+    ++entry.generation;
+    _free.push_back(index);
+    --_size;
+}
+
+
+int64_t TimingWheel::getNextTick(int64_t limit) const
+{
+    const uint64_t current = uint64_t(_current);
+
+    // Every timer on a level lies in a later slot of that level than the
+    // current tick, and the slots of a lower level are all reached before
+    // the next slot of a higher level, so the first occupied slot found
+    // from the lowest level up is the next one.
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        const int shift = level * SLOT_BITS;
+        const int digit = int((current >> shift) & (SLOTS - 1));
+
+        for (int word = (digit + 1) / 64; word < SLOTS / 64; ++word)
+        {
+            uint64_t bits = _occupied[level][word];
+
+            if (word == (digit + 1) / 64)
+            {
+                bits &= ~uint64_t(0) << ((digit + 1) % 64);
+            }
+
+            if (0 != bits)
+            {
+                const uint64_t next = uint64_t(word * 64 + Bits::lowestBit(bits));
+
+                // The digits above this level are unchanged.
+                const uint64_t base = level + 1 < LEVELS
+                                    ? (current >> (shift + SLOT_BITS)) << (shift + SLOT_BITS)
+                                    : 0;
+
+                return std::min(limit, int64_t(base | (next << shift)));
+            }
+        }
+    }
+
+    return limit;
+}
+
+
+} } // namespace ofx::Time
@@ -6,18 +6,82 @@
 
 
 #include "ofx/Time/Utils.h"
-#include "Poco/Exception.h"
+#include "ofx/Time/CalendarTable.h"
+#include "Divider.h"
+#include "FieldExtractor.h"
 
 
 namespace ofx {
 namespace Time {
 
 
+namespace {
+
+
+/// \brief Compute `((in[i] + bias) / span) * span` for an array.
+void divideMultiply(const int64_t* in,
+                    int64_t* out,
+                    std::size_t size,
+                    Poco::Timestamp::TimeDiff span,
+                    Poco::Timestamp::TimeDiff bias)
+{
+    if (span > 1)
+    {
+        Divider(span).divideMultiply(in, out, size, bias);
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        out[i] = ((in[i] + bias) / span) * span;
+    }
+}
+
+
+/// \brief Convert a rounded local time back to UTC.
+///
+/// The offset of the time that was rounded is kept if it is valid at the
+/// rounded time, so that rounding within the repeated hour of a fall-back
+/// transition stays in the same pass of that hour.  Otherwise the zone's
+/// policy resolves the rounded time.
+///
+/// \param zone The time zone.
+/// \param local The rounded local time in microseconds.
+/// \param offset The offset of the original time in microseconds.
+/// \returns the UTC time in microseconds since the epoch.
+int64_t toUtcWithOffset(const TimeZone& zone, int64_t local, int64_t offset)
+{
+    const int64_t utc = local - offset;
+    return zone.toLocal(utc) == local ? utc : zone.toUtc(local);
+}
+
+
+} // namespace
+
+
+
 std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
                                                  std::size_t quantity,
                                                  const Period& period)
 {
     std::vector<Poco::Timestamp> results;
+    results.reserve(quantity);
+
+    if (period.isFixed())
+    {
+        // Fixed periods form an arithmetic progression, so there is no need
+        // to round-trip each instance through a Poco::DateTime.
+        Poco::Timestamp::TimeVal t = start.epochMicroseconds();
+        Poco::Timestamp::TimeDiff step = period.getFixedMicroseconds();
+
+        for (std::size_t i = 0; i < quantity; ++i)
+        {
+            results.push_back(Poco::Timestamp(t));
+            t += step;
+        }
+
+        return results;
+    }
 
     Poco::Timestamp t(start);
 
@@ -45,6 +109,22 @@ std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
                                                  const Poco::Timestamp& end,
                                                  const Period& period)
 {
+    Poco::Timestamp::TimeDiff step = period.getFixedMicroseconds();
+
+    if (period.isFixed() && step > 0)
+    {
+        // The number of instances in [start, end) is known up front for
+        // fixed periods, so allocate once and fill the progression.
+        std::size_t quantity = 0;
+
+        if (end > start)
+        {
+            quantity = std::size_t((end - start - 1) / step + 1);
+        }
+
+        return getInstances(start, quantity, period);
+    }
+
     std::vector<Poco::Timestamp> results;
 
     for (Poco::Timestamp t(start); t < end; t = add(t, period))
@@ -65,6 +145,64 @@ std::vector<Poco::Timestamp> Utils::getInstances(const Interval& Interval,
 }
 
 
+std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
+                                                 std::size_t quantity,
+                                                 const Period& period,
+                                                 const TimeZone& zone,
+                                                 TimeZone::NonexistentPolicy nonexistent,
+                                                 TimeZone::AmbiguousPolicy ambiguous)
+{
+    std::vector<Poco::Timestamp> results;
+    results.reserve(quantity);
+    getInstances(LocalInstanceRange(start, quantity, period, zone, nonexistent, ambiguous), results);
+    return results;
+}
+
+
+std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
+                                                 const Poco::Timespan& timespan,
+                                                 const Period& period,
+                                                 const TimeZone& zone,
+                                                 TimeZone::NonexistentPolicy nonexistent,
+                                                 TimeZone::AmbiguousPolicy ambiguous)
+{
+    return getInstances(start,
+                        start + timespan.totalMicroseconds(),
+                        period,
+                        zone,
+                        nonexistent,
+                        ambiguous);
+}
+
+
+std::vector<Poco::Timestamp> Utils::getInstances(const Poco::Timestamp& start,
+                                                 const Poco::Timestamp& end,
+                                                 const Period& period,
+                                                 const TimeZone& zone,
+                                                 TimeZone::NonexistentPolicy nonexistent,
+                                                 TimeZone::AmbiguousPolicy ambiguous)
+{
+    std::vector<Poco::Timestamp> results;
+    getInstances(LocalInstanceRange(start, end, period, zone, nonexistent, ambiguous), results);
+    return results;
+}
+
+
+std::vector<Poco::Timestamp> Utils::getInstances(const Interval& interval,
+                                                 const Period& period,
+                                                 const TimeZone& zone,
+                                                 TimeZone::NonexistentPolicy nonexistent,
+                                                 TimeZone::AmbiguousPolicy ambiguous)
+{
+    return getInstances(interval.getStart(),
+                        interval.getEnd(),
+                        period,
+                        zone,
+                        nonexistent,
+                        ambiguous);
+}
+
+
 Poco::Timestamp Utils::toUtcTimestamp(const Poco::LocalDateTime& localDateTime)
 {
     return localDateTime.utc().timestamp();
@@ -84,106 +222,68 @@ Poco::LocalDateTime Utils::add(const Poco::LocalDateTime& time,
 }
 
 
-Poco::DateTime Utils::add(const Poco::DateTime& timez, const Period& period)
+Poco::DateTime Utils::add(const Poco::DateTime& dateTime, const Period& period)
 {
-    Poco::DateTime dateTime = timez;
+    return add(dateTime.timestamp(), period);
+}
 
-    for (int i = int(Period::NUM_FIELDS) - 1; i > -1; --i)
-    {
-        Period::Field field = Period::Field(i);
 
-        int64_t amount = period.get(field);
+Poco::Timestamp Utils::add(const Poco::Timestamp& time,
+                           const Period& period)
+{
+    Poco::Timestamp::TimeVal t = time.epochMicroseconds();
+
+    // Calendar fields are applied first, largest to smallest, followed by
+    // the fixed-length fields.
+    if (!period.isFixed())
+    {
+        int64_t years = period.get(Period::YEAR);
+        int64_t months = period.get(Period::MONTH);
 
-        if (0 == amount) continue;
+        if (0 != years)
+        {
+            t = CalendarTable::addYears(t, years);
+        }
 
-        switch (field)
+        if (0 != months)
         {
-            case Period::MICROSECOND:
-                dateTime += Poco::Timespan(amount);
-                break;
-            case Period::MILLISECOND:
-                dateTime += Poco::Timespan(amount * Poco::Timespan::MILLISECONDS);
-                break;
-            case Period::SECOND:
-                dateTime += Poco::Timespan(amount * Poco::Timespan::SECONDS);
-                break;
-            case Period::MINUTE:
-                dateTime += Poco::Timespan(amount * Poco::Timespan::MINUTES);
-                break;
-            case Period::HOUR:
-                dateTime += Poco::Timespan(amount * Poco::Timespan::HOURS);
-                break;
-            case Period::DAY:
-                dateTime += Poco::Timespan(amount * Poco::Timespan::DAYS);
-                break;
-            case Period::WEEK:
-                dateTime += Poco::Timespan(amount * 7 * Poco::Timespan::DAYS);
-                break;
-            case Period::MONTH:
-            {
-                int yearsToAdd  = (dateTime.month() + amount) / 12;
-                int newMonth = (dateTime.month() + amount) % 12;
-
-                // deal with negative months
-                if (newMonth < 1)
-                {
-                    newMonth += 12;
-                    yearsToAdd--;
-                }
-
-                dateTime = addYears(dateTime, yearsToAdd);
-
-                try
-                {
-                    dateTime = Poco::DateTime(dateTime.year(),
-                                              newMonth,
-                                              1, // remove days, add back later
-                                              dateTime.minute(),
-                                              dateTime.second(),
-                                              dateTime.millisecond(),
-                                              dateTime.microsecond());
-                }
-                catch (Poco::Exception& exception)
-                {
-                    ofLogError("Utils::add()") << exception.displayText();
-                }
-
-                int numDaysInThisMonth = Poco::DateTime::daysOfMonth(dateTime.year(),
-                                                                     dateTime.month());
-
-                int daysToAdd = std::min(dateTime.day(), numDaysInThisMonth) - 1; // keep it in Interval
-
-                // add days back
-                dateTime = addDays(dateTime, daysToAdd);
-                break;
-            }
-            case Period::YEAR:
-            {
-                if (amount > 0)
-                {
-                    int leapDays = countLeapDaysBetweenYears(dateTime.year(), dateTime.year() + amount + 1);
-                    dateTime += Poco::Timespan((Poco::Timestamp::TimeDiff)(365 * amount + leapDays) * Poco::Timespan::DAYS);
-                }
-                else
-                {
-                    int leapDays = countLeapDaysBetweenYears(dateTime.year() + amount, dateTime.year() + 1);
-                    dateTime -= Poco::Timespan((Poco::Timestamp::TimeDiff)(365 * -amount + leapDays) * Poco::Timespan::DAYS);
-                }
-                break;
-            }
-            default:
-                ofLogWarning("Utils::add()") << "Unknown field: " << field;
+            t = CalendarTable::addMonths(t, months);
         }
     }
 
-    return dateTime;
+    return Poco::Timestamp(t + period.getFixedMicroseconds());
 }
 
 
 Poco::Timestamp Utils::add(const Poco::Timestamp& time,
-                           const Period& period)
+                           const Period& period,
+                           const TimeZone& zone)
 {
-    return add(Poco::DateTime(time), period).timestamp();
+    Poco::Timestamp::TimeVal t = time.epochMicroseconds();
+
+    // Calendar fields are applied to the local time, largest to smallest,
+    // followed by the fixed-length fields.
+    if (!period.isFixed())
+    {
+        int64_t years = period.get(Period::YEAR);
+        int64_t months = period.get(Period::MONTH);
+
+        Poco::Timestamp::TimeVal local = zone.toLocal(t);
+
+        if (0 != years)
+        {
+            local = CalendarTable::addYears(local, years);
+        }
+
+        if (0 != months)
+        {
+            local = CalendarTable::addMonths(local, months);
+        }
+
+        t = zone.toUtc(local);
+    }
+
+    return Poco::Timestamp(t + period.getFixedMicroseconds());
 }
 
 
@@ -253,21 +353,21 @@ Poco::Timestamp Utils::addSeconds(const Poco::Timestamp& time,
 Poco::LocalDateTime Utils::addMinutes(const Poco::LocalDateTime& time,
                                       int64_t amount)
 {
-    return add(time, Period(Period::SECOND, amount));
+    return add(time, Period(Period::MINUTE, amount));
 }
 
 
 Poco::DateTime Utils::addMinutes(const Poco::DateTime& time,
                                  int64_t amount)
 {
-    return add(time, Period(Period::SECOND, amount));
+    return add(time, Period(Period::MINUTE, amount));
 }
 
 
 Poco::Timestamp Utils::addMinutes(const Poco::Timestamp& time,
                                   int64_t amount)
 {
-    return add(time, Period(Period::SECOND, amount));
+    return add(time, Period(Period::MINUTE, amount));
 }
 
 
@@ -433,6 +533,16 @@ Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
 }
 
 
+Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
+                             const Poco::Timespan& timespan,
+                             const TimeZone& zone)
+{
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, round(Poco::Timestamp(local), timespan).epochMicroseconds(), local - utc));
+}
+
+
 Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
                                const Poco::Timespan& timespan)
 {
@@ -445,6 +555,16 @@ Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
 }
 
 
+Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
+                               const Poco::Timespan& timespan,
+                               const TimeZone& zone)
+{
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, ceiling(Poco::Timestamp(local), timespan).epochMicroseconds(), local - utc));
+}
+
+
 Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
                              const Poco::Timespan& timespan)
 {
@@ -457,6 +577,55 @@ Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
 }
 
 
+Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
+                             const Poco::Timespan& timespan,
+                             const TimeZone& zone)
+{
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, floor(Poco::Timestamp(local), timespan).epochMicroseconds(), local - utc));
+}
+
+
+void Utils::round(const int64_t* timestamps,
+                  int64_t* results,
+                  std::size_t size,
+                  const Poco::Timespan& timespan)
+{
+    Poco::Timestamp::TimeVal spanTicks = timespan.totalMicroseconds();
+    divideMultiply(timestamps, results, size, spanTicks, (spanTicks / 2) + 1);
+}
+
+
+void Utils::ceiling(const int64_t* timestamps,
+                    int64_t* results,
+                    std::size_t size,
+                    const Poco::Timespan& timespan)
+{
+    Poco::Timestamp::TimeVal spanTicks = timespan.totalMicroseconds();
+    divideMultiply(timestamps, results, size, spanTicks, spanTicks - 1);
+}
+
+
+void Utils::floor(const int64_t* timestamps,
+                  int64_t* results,
+                  std::size_t size,
+                  const Poco::Timespan& timespan)
+{
+    Poco::Timestamp::TimeVal spanTicks = timespan.totalMicroseconds();
+    divideMultiply(timestamps, results, size, spanTicks, 0);
+}
+
+
+void Utils::extractFields(const int64_t* timestamps,
+                          int32_t* results,
+                          std::size_t size,
+                          Calendar::Field field)
+{
+    FieldExtractor::extract(timestamps, results, size, field);
+}
+
+
 Poco::LocalDateTime Utils::round(const Poco::LocalDateTime& localDateTime,
                                  Period::Field field)
 {
@@ -483,109 +652,124 @@ Poco::LocalDateTime Utils::floor(const Poco::LocalDateTime& localDateTime,
 
 Poco::DateTime Utils::round(const Poco::DateTime& dateTime,
                             Period::Field field)
+{
+    return round(dateTime.timestamp(), field);
+}
+
+
+Poco::DateTime Utils::ceiling(const Poco::DateTime& dateTime,
+                              Period::Field field)
+{
+    return ceiling(dateTime.timestamp(), field);
+}
+
+
+Poco::DateTime Utils::floor(const Poco::DateTime& dateTime,
+                            Period::Field field)
+{
+    return floor(dateTime.timestamp(), field);
+}
+
+
+Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
+                             Period::Field field)
 {
     switch(field)
     {
         case Period::MICROSECOND:
-            return round(dateTime, 1);
         case Period::MILLISECOND:
-            return round(dateTime, Poco::Timespan::MILLISECONDS);
         case Period::SECOND:
-            return round(dateTime, Poco::Timespan::SECONDS);
         case Period::MINUTE:
-            return round(dateTime, Poco::Timespan::MINUTES);
         case Period::HOUR:
-            return round(dateTime, Poco::Timespan::HOURS);
         case Period::DAY:
-            return round(dateTime, Poco::Timespan::DAYS);
         case Period::WEEK:
-            return round(dateTime, Poco::Timespan::DAYS * 7);
+            return round(timestamp, Poco::Timespan(Period::getFieldMicroseconds(field)));
         case Period::MONTH:
-            return round(dateTime, Poco::Timespan::DAYS * 365.25 / 12);
+            return CalendarTable::roundMonth(timestamp.epochMicroseconds());
         case Period::YEAR:
-            return round(dateTime, Poco::Timespan::DAYS * 365.25);
+            return CalendarTable::roundYear(timestamp.epochMicroseconds());
         default:
             ofLogWarning("Utils::round()") << "Unknown field: " << field;
-            return dateTime;
+            return timestamp;
     }
 }
 
-Poco::DateTime Utils::ceiling(const Poco::DateTime& dateTime,
-                              Period::Field field)
+
+Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
+                             Period::Field field,
+                             const TimeZone& zone)
+{
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, round(Poco::Timestamp(local), field).epochMicroseconds(), local - utc));
+}
+
+
+Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
+                               Period::Field field)
 {
     switch(field)
     {
         case Period::MICROSECOND:
-            return ceiling(dateTime, 1);
         case Period::MILLISECOND:
-            return ceiling(dateTime, Poco::Timespan::MILLISECONDS);
         case Period::SECOND:
-            return ceiling(dateTime, Poco::Timespan::SECONDS);
         case Period::MINUTE:
-            return ceiling(dateTime, Poco::Timespan::MINUTES);
         case Period::HOUR:
-            return ceiling(dateTime, Poco::Timespan::HOURS);
         case Period::DAY:
-            return ceiling(dateTime, Poco::Timespan::DAYS);
         case Period::WEEK:
-            return ceiling(dateTime, Poco::Timespan::DAYS * 7);
+            return ceiling(timestamp, Poco::Timespan(Period::getFieldMicroseconds(field)));
         case Period::MONTH:
-            return ceiling(dateTime, Poco::Timespan::DAYS * 365.25 / 12);
+            return CalendarTable::ceilingMonth(timestamp.epochMicroseconds());
         case Period::YEAR:
-            return ceiling(dateTime, Poco::Timespan::DAYS * 365.25);
+            return CalendarTable::ceilingYear(timestamp.epochMicroseconds());
         default:
-            ofLogWarning("Utils::round()") << "Unknown field: " << field;
-            return dateTime;
+            ofLogWarning("Utils::ceiling()") << "Unknown field: " << field;
+            return timestamp;
     }
 }
 
-Poco::DateTime Utils::floor(const Poco::DateTime& dateTime,
-                            Period::Field field)
+
+Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
+                               Period::Field field,
+                               const TimeZone& zone)
+{
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, ceiling(Poco::Timestamp(local), field).epochMicroseconds(), local - utc));
+}
+
+
+Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
+                             Period::Field field)
 {
     switch(field)
     {
         case Period::MICROSECOND:
-            return floor(dateTime, 1);
         case Period::MILLISECOND:
-            return floor(dateTime, Poco::Timespan::MILLISECONDS);
         case Period::SECOND:
-            return floor(dateTime, Poco::Timespan::SECONDS);
         case Period::MINUTE:
-            return floor(dateTime, Poco::Timespan::MINUTES);
         case Period::HOUR:
-            return floor(dateTime, Poco::Timespan::HOURS);
         case Period::DAY:
-            return floor(dateTime, Poco::Timespan::DAYS);
         case Period::WEEK:
-            return floor(dateTime, Poco::Timespan::DAYS * 7);
+            return floor(timestamp, Poco::Timespan(Period::getFieldMicroseconds(field)));
         case Period::MONTH:
-            return floor(dateTime, Poco::Timespan::DAYS * 365.25 / 12);
+            return CalendarTable::floorMonth(timestamp.epochMicroseconds());
         case Period::YEAR:
-            return floor(dateTime, Poco::Timespan::DAYS * 365.25);
+            return CalendarTable::floorYear(timestamp.epochMicroseconds());
         default:
-            ofLogWarning("Utils::round()") << "Unknown field: " << field;
-            return dateTime;
+            ofLogWarning("Utils::floor()") << "Unknown field: " << field;
+            return timestamp;
     }
 }
 
-Poco::Timestamp Utils::round(const Poco::Timestamp& timestamp,
-                             Period::Field field)
-{
-    return round(Poco::DateTime(timestamp), field).timestamp();
-}
-
-
-Poco::Timestamp Utils::ceiling(const Poco::Timestamp& timestamp,
-                               Period::Field field)
-{
-    return ceiling(Poco::DateTime(timestamp), field).timestamp();
-}
-
 
 Poco::Timestamp Utils::floor(const Poco::Timestamp& timestamp,
-                             Period::Field field)
+                             Period::Field field,
+                             const TimeZone& zone)
 {
-    return floor(Poco::DateTime(timestamp), field).timestamp();
+    const int64_t utc = timestamp.epochMicroseconds();
+    const int64_t local = zone.toLocal(utc);
+    return Poco::Timestamp(toUtcWithOffset(zone, floor(Poco::Timestamp(local), field).epochMicroseconds(), local - utc));
 }
 
 
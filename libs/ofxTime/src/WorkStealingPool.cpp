@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2013 Christopher Baker <https://christopherbaker.net>
+//
+// SPDX-License-Identifier:    MIT
+//
+
+
+#include "ofx/Time/WorkStealingPool.h"
+#include <algorithm>
+
+
+namespace ofx {
+namespace Time {
+
+
+namespace {
+
+
+/// \brief The pool that owns the current thread, if any.
+thread_local const WorkStealingPool* currentPool = nullptr;
+
+
+/// \brief The index of the current thread in currentPool.
+thread_local std::size_t currentIndex = 0;
+
+
+} // namespace
+
+
+WorkStealingPool::WorkStealingPool(std::size_t numThreads):
+    _pending(0),
+    _next(0)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (std::size_t i = 0; i < numThreads; ++i)
+    {
+        _workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+
+    // The threads are started after every queue exists, since any of them
+    // may steal from any other.
+    for (std::size_t i = 0; i < numThreads; ++i)
+    {
+        _workers[i]->thread = std::thread(&WorkStealingPool::run, this, i);
+    }
+}
+
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+
+    _condition.notify_all();
+
+    for (std::unique_ptr<Worker>& worker: _workers)
+    {
+        worker->thread.join();
+    }
+}
+
+
+void WorkStealingPool::submit(Task task)
+{
+    const std::size_t index = currentPool == this
+                            ? currentIndex
+                            : _next.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+
+    {
+        std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+        _workers[index]->tasks.push_back(std::move(task));
+    }
+
+    _pending.fetch_add(1);
+
+    // Taking the lock orders the increment before the check of a worker
+    // that is about to sleep, so the notification cannot be missed.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+
+    _condition.notify_one();
+}
+
+
+std::size_t WorkStealingPool::getNumThreads() const
+{
+    return _workers.size();
+}
+
+
+void WorkStealingPool::run(std::size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    for (;;)
+    {
+        Task task;
+
+        if (pop(index, task))
+        {
+            _pending.fetch_sub(1);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        _condition.wait(lock, [this]() {
+            return _pending.load() > 0 || _isStopping;
+        });
+
+        if (_isStopping && _pending.load() == 0)
+        {
+            return;
+        }
+    }
+}
+
+
+bool WorkStealingPool::pop(std::size_t index, Task& task)
+{
+    {
+        Worker& worker = *_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < _workers.size(); ++i)
+    {
+        Worker& victim = *_workers[(index + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+} } // namespace ofx::Time
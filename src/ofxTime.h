@@ -14,9 +14,33 @@
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTimeParser.h"
 #include "Poco/LocalDateTime.h"
+#include "ofx/Time/CachedClock.h"
+#include "ofx/Time/Calendar.h"
+#include "ofx/Time/CalendarTable.h"
+#include "ofx/Time/Clock.h"
+#include "ofx/Time/ColumnParser.h"
+#include "ofx/Time/CompiledFormat.h"
+#include "ofx/Time/CompiledParser.h"
+#include "ofx/Time/Coroutine.h"
+#include "ofx/Time/CronSchedule.h"
+#include "ofx/Time/DefaultInitAllocator.h"
+#include "ofx/Time/EventLoop.h"
+#include "ofx/Time/IncrementalFormat.h"
+#include "ofx/Time/InstanceRange.h"
 #include "ofx/Time/Interval.h"
+#include "ofx/Time/IntervalColumn.h"
+#include "ofx/Time/IntervalIndex.h"
+#include "ofx/Time/IntervalMapper.h"
+#include "ofx/Time/IntervalSet.h"
+#include "ofx/Time/LocalInstanceRange.h"
 #include "ofx/Time/Period.h"
+#include "ofx/Time/RRule.h"
+#include "ofx/Time/SeqLock.h"
+#include "ofx/Time/StaticPeriod.h"
+#include "ofx/Time/TimeZone.h"
+#include "ofx/Time/TimingWheel.h"
 #include "ofx/Time/Utils.h"
+#include "ofx/Time/WorkStealingPool.h"
 
 
 namespace ofxTime = ofx::Time;